@@ -20,6 +20,9 @@
 
 #include <boost/program_options.hpp>
 #include "property.h"
+#include "mutex.h"
+
+namespace votca { namespace ctp { class Calculator; }}
 
 namespace votca { namespace tools {
 
@@ -36,6 +39,15 @@ public:
      * \return return code
      */
     int Exec(int argc, char **argv);
+    /**
+     * \brief executes the program with several threads
+     * \param argc argc from main
+     * \param argv argv from main
+     * \return return code
+     *
+     * Same as Exec, but adds the option --nthreads and calls RunThreaded
+     * instead of Run.
+     */
     int ExecThreaded(int argc, char **argv);
 
     /**
@@ -93,7 +105,43 @@ public:
      * the work should be done in here.
      */
     virtual void Run() { }
-    virtual void RunThreaded() { }
+
+    /**
+     * \brief Main body of a threaded application
+     *
+     * Called by ExecThreaded instead of Run. The default implementation
+     * starts NumberOfThreads() threads which call RunWorker and waits for
+     * them. If a worker throws, the stop flag is set for the others and
+     * a runtime_error with the message of the first exception is thrown
+     * once all threads have finished.
+     */
+    virtual void RunThreaded();
+
+    /**
+     * \brief work done by one thread in RunThreaded
+     *
+     * The argument is the number of the thread, 0 ... NumberOfThreads()-1.
+     * Long running workers should check StopRequested() regularly.
+     */
+    virtual void RunWorker(int) { }
+
+    /**
+     * \brief number of threads given by --nthreads
+     *
+     * 1 for Exec, 0 on the command line means one thread per core.
+     */
+    int NumberOfThreads() const { return _nthreads; }
+
+    /// \brief ask all workers to finish early
+    void RequestStop();
+    /// \brief should the workers stop
+    bool StopRequested();
+
+    /**
+     * \brief pass the number of threads to a calculator
+     * \param calculator calculator run by this application
+     */
+    void ConfigureCalculator(votca::ctp::Calculator *calculator);
 
     /**
      * \brief add option for command line
@@ -144,6 +192,8 @@ public:
 protected:
     /// Variable map containing all program options
     boost::program_options::variables_map _op_vm;
+    /// program options in the order they were given on the command line
+    std::vector<boost::program_options::option> _op_parsed;
 
     /// program options required by all applications
     boost::program_options::options_description _op_desc;
@@ -159,6 +209,13 @@ protected:
     bool _continue_execution;
     
 private:
+    /// common part of Exec and ExecThreaded
+    int Execute(int argc, char **argv, bool threaded);
+
+    int _nthreads;
+    bool _stop;
+    Mutex _stop_mutex;
+
     /// get input parameters from file, location may be specified in command line
     void ParseCommandLine(int argc, char **argv);
     
@@ -0,0 +1,139 @@
+/*
+ * Copyright 2009-2014 The VOTCA Development Team (http://www.votca.org)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#ifndef _VOTCA_TOOLS_BOUNDEDQUEUE_H
+#define	_VOTCA_TOOLS_BOUNDEDQUEUE_H
+
+#include <stddef.h>
+#include <sched.h>
+#include <vector>
+
+namespace votca { namespace tools {
+
+/**
+ * \brief bounded lock-free multi-producer multi-consumer queue
+ *
+ * Ring buffer where every cell carries a sequence number (D. Vyukov's
+ * bounded MPMC queue). Producers and consumers claim cells with one
+ * compare-and-swap on the tail or head counter, no locks are taken.
+ * The capacity is rounded up to a power of two.
+ *
+ * T must be default constructible and assignable.
+ */
+template<typename T>
+class BoundedQueue
+{
+public:
+    explicit BoundedQueue(size_t capacity);
+
+    /// \brief add an element, returns false if the queue is full
+    bool TryPush(const T &value);
+    /// \brief remove the oldest element, returns false if the queue is empty
+    bool TryPop(T &value);
+
+    /// \brief add an element, waits while the queue is full
+    void Push(const T &value) { while(!TryPush(value)) sched_yield(); }
+    /// \brief remove the oldest element, waits while the queue is empty
+    void Pop(T &value) { while(!TryPop(value)) sched_yield(); }
+
+    /// \brief maximal number of elements
+    size_t capacity() const { return _mask + 1; }
+
+private:
+    struct cell_t {
+        size_t _sequence;
+        T _data;
+    };
+
+    enum { cacheline = 64 };
+
+    std::vector<cell_t> _buffer;
+    size_t _mask;
+    // head and tail on separate cache lines to avoid false sharing
+    char _pad0[cacheline];
+    size_t _tail;
+    char _pad1[cacheline];
+    size_t _head;
+    char _pad2[cacheline];
+
+    BoundedQueue(const BoundedQueue &);
+    BoundedQueue &operator=(const BoundedQueue &);
+};
+
+template<typename T>
+BoundedQueue<T>::BoundedQueue(size_t capacity)
+    : _tail(0), _head(0)
+{
+    size_t n = 2;
+    while(n < capacity) n *= 2;
+    _buffer.resize(n);
+    _mask = n - 1;
+    for(size_t i = 0; i < n; ++i)
+        _buffer[i]._sequence = i;
+}
+
+template<typename T>
+bool BoundedQueue<T>::TryPush(const T &value)
+{
+    size_t pos = __atomic_load_n(&_tail, __ATOMIC_RELAXED);
+    cell_t *cell;
+    while(true) {
+        cell = &_buffer[pos & _mask];
+        size_t seq = __atomic_load_n(&cell->_sequence, __ATOMIC_ACQUIRE);
+        ptrdiff_t diff = (ptrdiff_t)seq - (ptrdiff_t)pos;
+        if(diff == 0) {
+            if(__atomic_compare_exchange_n(&_tail, &pos, pos + 1, true,
+                    __ATOMIC_RELAXED, __ATOMIC_RELAXED))
+                break;
+        }
+        else if(diff < 0)
+            return false;
+        else
+            pos = __atomic_load_n(&_tail, __ATOMIC_RELAXED);
+    }
+    cell->_data = value;
+    __atomic_store_n(&cell->_sequence, pos + 1, __ATOMIC_RELEASE);
+    return true;
+}
+
+template<typename T>
+bool BoundedQueue<T>::TryPop(T &value)
+{
+    size_t pos = __atomic_load_n(&_head, __ATOMIC_RELAXED);
+    cell_t *cell;
+    while(true) {
+        cell = &_buffer[pos & _mask];
+        size_t seq = __atomic_load_n(&cell->_sequence, __ATOMIC_ACQUIRE);
+        ptrdiff_t diff = (ptrdiff_t)seq - (ptrdiff_t)(pos + 1);
+        if(diff == 0) {
+            if(__atomic_compare_exchange_n(&_head, &pos, pos + 1, true,
+                    __ATOMIC_RELAXED, __ATOMIC_RELAXED))
+                break;
+        }
+        else if(diff < 0)
+            return false;
+        else
+            pos = __atomic_load_n(&_head, __ATOMIC_RELAXED);
+    }
+    value = cell->_data;
+    __atomic_store_n(&cell->_sequence, pos + _mask + 1, __ATOMIC_RELEASE);
+    return true;
+}
+
+}}
+
+#endif	/* _VOTCA_TOOLS_BOUNDEDQUEUE_H */
@@ -24,6 +24,7 @@
 #include <votca/tools/property.h>
 #include <votca/tools/propertyiomanipulator.h>
 #include <votca/tools/globals.h>
+#include <votca/tools/defaultsregistry.h>
 
 namespace votca { namespace ctp {
 
@@ -88,7 +89,9 @@ public:
      *  
      * If a value is not given or tag is not present and at the same time
      * a default value exists in the corresponding XML file in VOTCASHARE
-     * a tag is created and/or a default value is assigned to it
+     * a tag is created and/or a default value is assigned to it.
+     * Each defaults file is parsed only once per process. The options are
+     * modified in place, call this before other threads access them.
      */    
     void UpdateWithDefaults(votca::tools::Property *options);
     
@@ -106,9 +109,9 @@ inline void Calculator::LoadDefaults() {
 
 inline void Calculator::UpdateWithDefaults(votca::tools::Property *options) {
     
-    // copy options from the object supplied by the Application
+    // options supplied by the Application, updated in place
     std::string id = Identify();
-    votca::tools::Property _options = options->get( "options." + id );
+    votca::tools::Property &_options = options->get( "options." + id );
     
     // add default values if specified in VOTCASHARE
     char *votca_share = getenv("VOTCASHARE");
@@ -117,16 +120,8 @@ inline void Calculator::UpdateWithDefaults(votca::tools::Property *options) {
     std::string xmlFile = std::string(getenv("VOTCASHARE")) 
             + std::string("/ctp/xml/") + id + std::string(".xml");
     
-    votca::tools::Property defaults, _defaults;
-    votca::tools::load_property_from_xml(_defaults, xmlFile);
-    defaults = _defaults.get( "options." + id );
-    
-    //std::cout << _options;
-    //std::cout << defaults;
-      
     // if a value not given or a tag not present, provide default values
-    AddDefaults( _options, defaults );   
-   
+    votca::tools::DefaultsRegistry::Instance().Update( *options, xmlFile, "options." + id );
      
     // output calculator options
     std::string indent("          "); int level = 1;
@@ -138,22 +133,7 @@ inline void Calculator::UpdateWithDefaults(votca::tools::Property *options) {
 
 
 inline void Calculator::AddDefaults( votca::tools::Property &p, votca::tools::Property &defaults ) {
-     
-    for(std::list<votca::tools::Property>::iterator iter = defaults.begin(); iter!=defaults.end(); ++iter) {
-        std::string name =  (*iter).path() + "." + (*iter).name();
-
-        votca::tools::Property rootp = *p.begin();
-        if  ( (*iter).hasAttribute("default") ) {
-            if ( rootp.exists( name ) ) {
-                //std::cout << "E " << rootp.value() << std::endl;
-                if ( rootp.HasChilds()) rootp.value() = (*iter).value();
-            } else {
-                //std::cout << "N " << (*iter).name() << std::endl;
-                rootp.add((*iter).name(), (*iter).value());
-            }
-        }
-        AddDefaults( p, (*iter) );
-    }    
+    votca::tools::DefaultsRegistry::Merge( p, defaults );
 }
 
 }}
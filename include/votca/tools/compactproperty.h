@@ -0,0 +1,348 @@
+/*
+ * Copyright 2009-2014 The VOTCA Development Team (http://www.votca.org)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#ifndef _VOTCA_TOOLS_COMPACTPROPERTY_H
+#define	_VOTCA_TOOLS_COMPACTPROPERTY_H
+
+#include <string>
+#include <vector>
+#include <list>
+#include <stdexcept>
+#include "property.h"
+
+namespace votca { namespace tools {
+
+/**
+ * \brief pool of interned strings
+ *
+ * Every distinct string is stored exactly once in one contiguous character
+ * buffer and is identified by an integer id. Interning the same string twice
+ * returns the same id.
+ */
+class StringPool
+{
+public:
+    typedef unsigned int id_t;
+
+    StringPool();
+
+    /**
+     * \brief add a string to the pool
+     * @param str pointer to the characters (need not be zero terminated)
+     * @param len number of characters
+     * @return id of the string
+     */
+    id_t Intern(const char *str, size_t len);
+    id_t Intern(const string &str) { return Intern(str.data(), str.size()); }
+
+    /**
+     * \brief look up a string without adding it
+     * @return id of the string or StringPool::npos if it is not in the pool
+     */
+    id_t Find(const char *str, size_t len) const;
+    id_t Find(const string &str) const { return Find(str.data(), str.size()); }
+
+    static const id_t npos = ~0u;
+
+    /**
+     * \brief zero terminated string for id
+     *
+     * The pointer is invalidated by the next call to Intern.
+     */
+    const char *c_str(id_t id) const { return &_chars[_offsets[id]]; }
+    /// \brief length of string id
+    size_t length(id_t id) const { return _offsets[id+1] - _offsets[id] - 1; }
+    /// \brief copy of string id
+    string str(id_t id) const { return string(c_str(id), length(id)); }
+    /// \brief number of distinct strings
+    size_t size() const { return _offsets.size() - 1; }
+
+    /// \brief remove all strings
+    void clear();
+    /// \brief release unused capacity
+    void shrink();
+    /// \brief approximate number of bytes used
+    size_t MemoryUsage() const;
+
+private:
+    vector<char> _chars;
+    vector<size_t> _offsets;
+    /// open addressing hash table of string ids, size is a power of two
+    vector<id_t> _table;
+
+    static size_t Hash(const char *str, size_t len);
+    void Rehash(size_t nslots);
+};
+
+class CompactProperty;
+
+/**
+ * \brief read-only view of one node of a CompactProperty tree
+ *
+ * A PropertyView offers the reading part of the Property interface
+ * (name, value, path, get, Select, as, attributes, child iteration) on top
+ * of the compact storage. A view is just a pointer and an index and is
+ * cheap to copy; it stays valid as long as the tree it points into.
+ */
+class PropertyView
+{
+public:
+    PropertyView() : _tree(NULL), _node(0) {}
+    PropertyView(const CompactProperty *tree, unsigned int node)
+        : _tree(tree), _node(node) {}
+
+    /// \brief name of property
+    string name() const;
+    /// \brief value of property
+    string value() const;
+    /// \brief full path of property (excluding the name), e.g. cg.inverse
+    string path() const;
+
+    /**
+     * \brief get existing property
+     * @param key identifier, levels separated by "."
+     *
+     * throws a runtime_error if the property does not exist
+     */
+    PropertyView get(const string &key) const;
+    /// \brief check weather property exists
+    bool exists(const string &key) const;
+    /**
+     * \brief select property based on a filter
+     *
+     * returns all properties that match the key criteria including
+     * wildcards "*" and "?". Example: "base.item*.value"
+     */
+    std::list<PropertyView> Select(const string &filter) const;
+
+    /// \brief return value as type, same conversions as Property::as
+    template<typename T>
+    T as() const;
+
+    /// \brief does the property has childs?
+    bool HasChilds() const;
+    /// \brief number of child properties
+    size_t size() const;
+    /// \brief i-th child property
+    PropertyView child(size_t i) const;
+
+    /// \brief return true if a node has attributes
+    bool hasAttributes() const;
+    /// \brief return true if an attribute exists
+    bool hasAttribute(const string &attribute) const;
+    /**
+     * \brief return attribute as type
+     *
+     * throws a runtime_error if the attribute does not exist
+     */
+    template<typename T>
+    T getAttribute(const string &attribute) const;
+
+    /// \brief index of the node in the arena
+    unsigned int index() const { return _node; }
+
+    /// iterator over the childs of a node
+    class iterator {
+    public:
+        iterator() {}
+        iterator(const CompactProperty *tree, unsigned int node)
+            : _tree(tree), _node(node) {}
+        PropertyView operator*() const { return PropertyView(_tree, _node); }
+        iterator &operator++() { ++_node; return *this; }
+        bool operator==(const iterator &i) const { return _node == i._node; }
+        bool operator!=(const iterator &i) const { return _node != i._node; }
+    private:
+        const CompactProperty *_tree;
+        unsigned int _node;
+    };
+    /// \brief iterator to first child property
+    iterator begin() const;
+    /// \brief end iterator for child properties
+    iterator end() const;
+
+    /**
+     * \brief copy the subtree into a (mutable) Property
+     * @param p empty property object to fill
+     */
+    void ToProperty(Property &p) const;
+
+private:
+    const CompactProperty *_tree;
+    unsigned int _node;
+
+    const char *FindAttribute(const string &attribute) const;
+};
+
+/**
+ * \brief compact, read-only storage of a property tree
+ *
+ * All nodes of the tree live in one contiguous arena. Names, paths and
+ * values are interned in string pools and nodes only store their ids.
+ * The childs of a node are stored next to each other (breadth first order),
+ * so a node refers to them as an index range, attributes are kept in one
+ * flat vector the same way.
+ *
+ * A CompactProperty is filled either from an existing Property or directly
+ * from an XML file via load_compact_property_from_xml. Read access goes
+ * through PropertyView, which mimics the Property interface.
+ */
+class CompactProperty
+{
+public:
+    typedef StringPool::id_t id_t;
+
+    struct node_t {
+        id_t name;
+        id_t path;
+        id_t value;
+        unsigned int parent;
+        unsigned int first_child;
+        unsigned int nchilds;
+        unsigned int first_attribute;
+        unsigned int nattributes;
+    };
+
+    struct attribute_t {
+        id_t name;
+        id_t value;
+    };
+
+    CompactProperty() { clear(); }
+    /// \brief build compact tree from a Property
+    explicit CompactProperty(Property &p) { Assign(p); }
+
+    /// \brief replace content by a copy of p
+    void Assign(Property &p);
+    /// \brief remove all nodes, leaves an empty root
+    void clear();
+
+    /// \brief view of the root node
+    PropertyView root() const { return PropertyView(this, 0); }
+    /// \brief shortcut for root().get(key)
+    PropertyView get(const string &key) const { return root().get(key); }
+    /// \brief shortcut for root().Select(filter)
+    std::list<PropertyView> Select(const string &filter) const { return root().Select(filter); }
+
+    /// \brief number of nodes including the root
+    size_t size() const { return _nodes.size(); }
+    /// \brief approximate number of bytes used by the tree
+    size_t MemoryUsage() const;
+
+    const node_t &node(unsigned int i) const { return _nodes[i]; }
+    const attribute_t &attribute(unsigned int i) const { return _attributes[i]; }
+    const StringPool &names() const { return _names; }
+    const StringPool &values() const { return _values; }
+
+private:
+    vector<node_t> _nodes;
+    vector<attribute_t> _attributes;
+    /// names, paths and attribute names
+    StringPool _names;
+    /// values and attribute values
+    StringPool _values;
+
+    friend class CompactPropertyBuilder;
+};
+
+/**
+ * \brief load an XML file directly into a compact tree
+ * @param p tree to fill
+ * @param filename XML file
+ *
+ * This is the counterpart of load_property_from_xml, it does not create
+ * intermediate Property objects.
+ */
+bool load_compact_property_from_xml(CompactProperty &p, const string &filename);
+
+inline string PropertyView::name() const
+{
+    return _tree->names().str(_tree->node(_node).name);
+}
+
+inline string PropertyView::value() const
+{
+    return _tree->values().str(_tree->node(_node).value);
+}
+
+inline string PropertyView::path() const
+{
+    return _tree->names().str(_tree->node(_node).path);
+}
+
+inline bool PropertyView::HasChilds() const
+{
+    return _tree->node(_node).nchilds != 0;
+}
+
+inline size_t PropertyView::size() const
+{
+    return _tree->node(_node).nchilds;
+}
+
+inline PropertyView PropertyView::child(size_t i) const
+{
+    return PropertyView(_tree, _tree->node(_node).first_child + i);
+}
+
+inline PropertyView::iterator PropertyView::begin() const
+{
+    return iterator(_tree, _tree->node(_node).first_child);
+}
+
+inline PropertyView::iterator PropertyView::end() const
+{
+    const CompactProperty::node_t &n = _tree->node(_node);
+    return iterator(_tree, n.first_child + n.nchilds);
+}
+
+inline bool PropertyView::hasAttributes() const
+{
+    return _tree->node(_node).nattributes != 0;
+}
+
+inline bool PropertyView::hasAttribute(const string &attribute) const
+{
+    return FindAttribute(attribute) != NULL;
+}
+
+inline bool PropertyView::exists(const string &key) const
+{
+    try { get(key); }
+    catch(std::exception &err) { return false; }
+    return true;
+}
+
+template<typename T>
+inline T PropertyView::as() const
+{
+    // reuse the conversions (and error messages) of Property
+    return Property(name(), value(), path()).as<T>();
+}
+
+template<typename T>
+inline T PropertyView::getAttribute(const string &attribute) const
+{
+    const char *value = FindAttribute(attribute);
+    if(!value)
+        throw std::runtime_error("attribute " + attribute + " not found\n");
+    return lexical_cast<T>(string(value), "wrong type in attribute " + attribute
+            + " of element " + path() + "."  + name() + "\n");
+}
+
+}}
+
+#endif	/* _VOTCA_TOOLS_COMPACTPROPERTY_H */
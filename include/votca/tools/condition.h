@@ -0,0 +1,62 @@
+/*
+ * Copyright 2009-2014 The VOTCA Development Team (http://www.votca.org)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#ifndef _VOTCA_TOOLS_CONDITION_H
+#define	_VOTCA_TOOLS_CONDITION_H
+
+#include <pthread.h>
+#include "mutex.h"
+
+namespace votca { namespace tools {
+
+/**
+ * \brief condition variable working together with Mutex
+ *
+ * \code
+ *   ScopedLock lock(mutex);
+ *   while(!ready)
+ *       condition.Wait(mutex);
+ * \endcode
+ */
+class Condition
+{
+public:
+    Condition();
+    ~Condition();
+
+    /// \brief wait for a signal, mutex must be locked by the caller
+    void Wait(Mutex &mutex);
+    /**
+     * \brief wait for a signal at most the given time
+     * @return false if the time ran out
+     */
+    bool TimedWait(Mutex &mutex, double seconds);
+    /// \brief wake up one waiting thread
+    void Signal();
+    /// \brief wake up all waiting threads
+    void Broadcast();
+
+private:
+    pthread_cond_t _cond;
+
+    Condition(const Condition &);
+    Condition &operator=(const Condition &);
+};
+
+}}
+
+#endif	/* _VOTCA_TOOLS_CONDITION_H */
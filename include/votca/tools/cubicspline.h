@@ -98,6 +98,11 @@ public:
      * \param scale parameters for terms "A,B,C,D"
      * When creating a matrix to fit data with a spline, this function creates
      * one entry in that fitting matrix.
+     *
+     * Each row only has four non-zeros, so for large fits matrix_type can be
+     * a SparseMatrixBuilder instead of a dense matrix. The same holds for the
+     * other AddToFitMatrix and AddBCToFitMatrix functions, the result can be
+     * solved with LeastSquaresSolver.
     */
     template<typename matrix_type>
     void AddToFitMatrix(matrix_type &A, double x,
@@ -23,6 +23,7 @@
 #include <map>
 #include <sstream>
 #include "tokenizer.h"
+#include "wildcard.h"
 
 namespace votca { namespace tools {
 
@@ -204,8 +205,16 @@ typename DataCollection<T>::selection *DataCollection<T>::select(string strselec
     typename DataCollection<T>::selection *sel = sel_append;
     if(!sel_append) sel = new typename DataCollection<T>::selection;
     
+    WildcardPattern pattern(strselection);
+    if(pattern.IsLiteral()) {
+        typename map<string,array*>::iterator i = _array_by_name.find(strselection);
+        if(i != _array_by_name.end())
+            sel->push_back((*i).second);
+        return sel;
+    }
+
     for(typename map<string,array*>::iterator i=_array_by_name.begin(); i!=_array_by_name.end();++i) {
-        if(wildcmp(strselection.c_str(), (*i).second->getName().c_str()))
+        if(pattern.Match((*i).second->getName()))
             sel->push_back((*i).second);
     }
     return sel;
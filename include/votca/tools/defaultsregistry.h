@@ -0,0 +1,85 @@
+/*
+ * Copyright 2009-2014 The VOTCA Development Team (http://www.votca.org)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#ifndef _VOTCA_TOOLS_DEFAULTSREGISTRY_H
+#define	_VOTCA_TOOLS_DEFAULTSREGISTRY_H
+
+#include <string>
+#include <map>
+#include "property.h"
+#include "mutex.h"
+
+namespace votca { namespace tools {
+
+/**
+ * \brief process-wide cache of XML files with default options
+ *
+ * Every file is parsed only once, later requests return the same tree.
+ * The trees are kept until the end of the program, so references returned
+ * by Get stay valid. Get can be called from several threads.
+ */
+class DefaultsRegistry
+{
+public:
+    /// \brief the registry of the process
+    static DefaultsRegistry &Instance();
+
+    /**
+     * \brief parsed content of an XML file
+     * @param filename XML file
+     *
+     * The returned tree is shared and must not be modified.
+     */
+    Property &Get(const std::string &filename);
+
+    /**
+     * \brief add default values to an options tree
+     * @param options tree with the user options
+     * @param filename XML file with the defaults
+     * @param key property holding the options in both trees, e.g. options.name
+     *
+     * The options tree is modified in place without locking, nobody else
+     * may read or write it during the update. Update a shared options
+     * object once before worker threads are started.
+     */
+    void Update(Property &options, const std::string &filename, const std::string &key);
+
+    /**
+     * \brief recursively add defaults to p
+     * @param p options to update
+     * @param defaults tree with default values
+     *
+     * A tag with a "default" attribute which is missing in p is created
+     * with the default value, an existing tag with empty value gets the
+     * default value. Sections are created if they contain defaults.
+     * No locking is done.
+     */
+    static void Merge(Property &p, Property &defaults);
+
+private:
+    DefaultsRegistry() {}
+    ~DefaultsRegistry();
+
+    std::map<std::string, Property *> _files;
+    Mutex _files_mutex;
+
+    static bool HasDefaults(Property &p);
+};
+
+}}
+
+#endif	/* _VOTCA_TOOLS_DEFAULTSREGISTRY_H */
@@ -0,0 +1,125 @@
+/*
+ * Copyright 2009-2014 The VOTCA Development Team (http://www.votca.org)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#ifndef __VOTCA_TOOLS_LANCZOS_H
+#define	__VOTCA_TOOLS_LANCZOS_H
+
+#include <boost/numeric/ublas/matrix.hpp>
+#include <boost/numeric/ublas/vector.hpp>
+
+namespace votca { namespace tools {
+    namespace ub = boost::numeric::ublas;
+
+/**
+ * \brief symmetric linear operator y = A*x
+ *
+ * Interface for matrix-free eigensolvers: only the product with a vector
+ * is needed, the matrix itself never has to be stored.
+ */
+class LinearOperator
+{
+public:
+    virtual ~LinearOperator() {}
+
+    /// \brief dimension of the operator
+    virtual size_t size() const = 0;
+    /// \brief y = A*x, x and y have size() elements and do not overlap
+    virtual void Apply(const double *x, double *y) const = 0;
+};
+
+/**
+ * \brief LinearOperator for a dense symmetric matrix
+ *
+ * Only keeps a reference, the matrix has to outlive the operator.
+ */
+class MatrixOperator : public LinearOperator
+{
+public:
+    explicit MatrixOperator(const ub::matrix<double> &A) : _A(A) {}
+
+    size_t size() const { return _A.size1(); }
+    void Apply(const double *x, double *y) const;
+
+private:
+    const ub::matrix<double> &_A;
+};
+
+/**
+ * \brief partial eigenspectrum of a symmetric operator by thick-restart Lanczos
+ *
+ * Computes the nev lowest or highest eigenpairs of a symmetric operator.
+ * The Krylov basis is kept fully orthogonal, after every restart the best
+ * Ritz vectors are kept (thick restart, K. Wu and H. Simon, SIAM J. Matrix
+ * Anal. Appl. 22, 602 (2000)). The cost per restart is a number of
+ * products with A plus O(N*m^2) for a basis of m vectors, so for nev << N
+ * it is far below the O(N^3) of a full diagonalization.
+ *
+ * The solver does not depend on the linalg backend.
+ */
+class LanczosSolver
+{
+public:
+    enum spectrum_t { lowest, highest };
+
+    LanczosSolver();
+
+    /// \brief relative tolerance of the eigenpair residuals (default 1e-10)
+    void setTolerance(double tol) { _tol = tol; }
+    /// \brief maximum number of restarts (default 1000)
+    void setMaxRestarts(int n) { _max_restarts = n; }
+    /**
+     * \brief number of basis vectors between restarts
+     *
+     * 0 (default) picks max(2*nev, nev+20), limited by the dimension.
+     */
+    void setBasisSize(int m) { _basis_size = m; }
+    /// \brief seed of the random start vector
+    void setSeed(unsigned long seed) { _seed = seed; }
+
+    /**
+     * \brief solve for nev eigenpairs
+     * @param A symmetric operator
+     * @param nev number of eigenpairs
+     * @param E eigenvalues in ascending order
+     * @param V eigenvectors as columns (size x nev)
+     * @param which lowest or highest part of the spectrum
+     * @return true if all eigenpairs converged
+     *
+     * If the solver does not converge, E and V contain the best
+     * approximations found.
+     */
+    bool Solve(const LinearOperator &A, int nev, ub::vector<double> &E,
+            ub::matrix<double> &V, spectrum_t which = lowest);
+
+    /// \brief number of restarts of the last Solve
+    int getRestarts() const { return _restarts; }
+    /// \brief number of products with A of the last Solve
+    int getMatVecs() const { return _matvecs; }
+
+private:
+    double _tol;
+    int _max_restarts;
+    int _basis_size;
+    unsigned long _seed;
+
+    int _restarts;
+    int _matvecs;
+};
+
+}}
+
+#endif	/* __VOTCA_TOOLS_LANCZOS_H */
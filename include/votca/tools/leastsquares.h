@@ -0,0 +1,93 @@
+/*
+ * Copyright 2009-2014 The VOTCA Development Team (http://www.votca.org)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#ifndef __VOTCA_TOOLS_LEASTSQUARES_H
+#define	__VOTCA_TOOLS_LEASTSQUARES_H
+
+#include <votca/tools/sparsematrix.h>
+
+namespace votca { namespace tools {
+
+/**
+ * \brief iterative solver for sparse linear least-squares problems
+ *
+ * Minimizes |A*x - b|^2 + lambda^2*|x|^2 for a SparseMatrix A, lambda is
+ * the (optional) Tikhonov damping. Only products with A and trans(A) are
+ * needed, so memory scales with the number of non-zeros and the normal
+ * equations are never formed.
+ *
+ * Two methods are available:
+ * - cgls: conjugate gradients on the normal equations
+ * - lsqr: LSQR (C. C. Paige and M. A. Saunders, ACM Trans. Math. Softw. 8,
+ *   43 (1982)), mathematically equivalent to cgls but more stable for
+ *   ill-conditioned problems
+ *
+ * With the Jacobi preconditioner the columns of the damped system are
+ * scaled to unit norm, which usually cuts the number of iterations for
+ * badly scaled columns. The damping always acts on x itself.
+ */
+class LeastSquaresSolver
+{
+public:
+    enum method_t { cgls, lsqr };
+
+    LeastSquaresSolver();
+
+    /// \brief iterative method (default lsqr)
+    void setMethod(method_t method) { _method = method; }
+    /// \brief Tikhonov damping lambda (default 0)
+    void setDamping(double lambda) { _damping = lambda; }
+    /// \brief scale the columns to unit norm (default true)
+    void setJacobiPreconditioner(bool use) { _jacobi = use; }
+    /**
+     * \brief relative tolerance (default 1e-10)
+     *
+     * Stops if |r| <= tol*|b| (consistent systems) or
+     * |trans(A)*r| <= tol*|A|*|r| (least-squares solution found).
+     */
+    void setTolerance(double tol) { _tol = tol; }
+    /// \brief maximum number of iterations, 0 (default) for 4*size2, at least 100
+    void setMaxIterations(int n) { _max_iterations = n; }
+
+    /**
+     * \brief solve the least-squares problem
+     * @param A sparse matrix
+     * @param b inhomogenity
+     * @param x solution, the iteration starts from zero
+     * @return true if the tolerance was reached
+     */
+    bool Solve(const SparseMatrix &A, const ub::vector<double> &b, ub::vector<double> &x);
+
+    /// \brief number of iterations of the last Solve
+    int getIterations() const { return _iterations; }
+    /// \brief |A*x - b| of the last solution
+    double getResidualNorm() const { return _residual; }
+
+private:
+    method_t _method;
+    double _damping;
+    bool _jacobi;
+    double _tol;
+    int _max_iterations;
+
+    int _iterations;
+    double _residual;
+};
+
+}}
+
+#endif	/* __VOTCA_TOOLS_LEASTSQUARES_H */
@@ -76,6 +76,12 @@ namespace votca { namespace tools {
      */
     void linalg_constrained_qrsolve(ub::vector<double> &x, ub::matrix<double> &A, ub::vector<double> &b, ub::matrix<double> &constr);
 
+    /*
+     * The return value of the linalg_eigenvalues functions depends on the
+     * backend: GSL returns its error status, i.e. true on failure, while
+     * MKL and LAPACK return true on success.
+     */
+
     /**
      * \brief eigenvalues of a symmetric matrix A*x=E*x
      * @param A symmetric matrix 
@@ -130,6 +136,8 @@ namespace votca { namespace tools {
      * @param V output: eigenvectors      
      * 
      * This function wrapps gsl_eigen_symmv / DSYEV
+     * Only the nmax lowest eigenpairs are calculated, 0 < nmax <= size of A,
+     * otherwise std::invalid_argument is thrown.
      * 
      */
     bool linalg_eigenvalues( ub::matrix<double> &A, ub::vector<double> &E, ub::matrix<double> &V , int nmax );
@@ -141,6 +149,7 @@ namespace votca { namespace tools {
      * @param V output: eigenvectors      
      * 
      * This function wrapps gsl_eigen_symmv / DSYEV
+     * Only the nmax lowest eigenpairs are calculated, 0 < nmax <= size of A.
      * 
      */
     bool linalg_eigenvalues( ub::matrix<float> &A, ub::vector<float> &E, ub::matrix<float> &V , int nmax );
@@ -156,7 +165,18 @@ namespace votca { namespace tools {
      * 
      */
     bool linalg_eigenvalues_general( ub::matrix<double> &A,ub::matrix<double> &B, ub::vector<double> &E, ub::matrix<double> &V);
-    
+
+     /**
+     * \brief singular value decomposition A = U*S*trans(V)
+     * @param A input: MxN matrix (M >= N), output: MxN orthogonal matrix U
+     * @param V output: NxN orthogonal matrix
+     * @param S output: singular values
+     *
+     * This function wrapps dgesvd, only available with the lapack backend
+     *
+     */
+    bool linalg_singular_value_decomposition( ub::matrix<double> &A, ub::matrix<double> &V, ub::vector<double> &S );
+
     
     
 }}
@@ -0,0 +1,185 @@
+/*
+ * Copyright 2009-2014 The VOTCA Development Team (http://www.votca.org)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#ifndef __VOTCA_TOOLS_LINALGSOLVERS_H
+#define	__VOTCA_TOOLS_LINALGSOLVERS_H
+
+#include <votca/tools/linalg.h>
+
+namespace votca { namespace tools {
+
+/*
+ * Solver objects for repeated solves of systems of the same size.
+ *
+ * The free functions in linalg.h allocate their workspace on every call.
+ * The classes below keep the factorization and all workspaces between
+ * calls, they are only reallocated if the problem size changes. A matrix
+ * is factorized once by Decompose and can then be used for any number of
+ * right hand sides. Decompose copies the matrix, the input is left untouched.
+ *
+ * The implementation depends on the linalg backend, a solver object
+ * must not be used by several threads at the same time.
+ */
+
+/**
+ * \brief least-squares solver based on a QR decomposition
+ *
+ * Solves min |A*x - b| for an MxN matrix A with M >= N.
+ */
+class QRSolver
+{
+public:
+    QRSolver();
+    ~QRSolver();
+
+    /**
+     * \brief check A for zero columns in Decompose (default: true)
+     *
+     * A matrix with a zero column has no unique solution, the check throws
+     * a runtime_error in this case. Switch it off in inner loops if the
+     * matrix is known to be fine.
+     */
+    void setCheckZeroColumns(bool check) { _check_zero_columns = check; }
+    bool getCheckZeroColumns() const { return _check_zero_columns; }
+
+    /// \brief factorize A
+    void Decompose(const ub::matrix<double> &A);
+
+    /**
+     * \brief solve for the last decomposed matrix
+     * @param x storage for x
+     * @param b inhomogenity
+     * @param residual if non-zero, residual b - A*x will be stored here
+     */
+    void Solve(ub::vector<double> &x, const ub::vector<double> &b, ub::vector<double> *residual = NULL);
+
+    /// \brief Decompose(A) followed by Solve(x, b, residual)
+    void Solve(ub::vector<double> &x, const ub::matrix<double> &A,
+            const ub::vector<double> &b, ub::vector<double> *residual = NULL) {
+        Decompose(A);
+        Solve(x, b, residual);
+    }
+
+private:
+    struct workspace_t;
+    workspace_t *_ws;
+    bool _check_zero_columns;
+
+    QRSolver(const QRSolver &);
+    QRSolver &operator=(const QRSolver &);
+};
+
+/**
+ * \brief solver for symmetric positive definite systems based on a
+ * Cholesky decomposition
+ */
+class CholeskySolver
+{
+public:
+    CholeskySolver();
+    ~CholeskySolver();
+
+    /**
+     * \brief factorize A
+     *
+     * throws a runtime_error if A is not symmetric positive definite
+     */
+    void Decompose(const ub::matrix<double> &A);
+
+    /// \brief solve A*x=b for the last decomposed matrix
+    void Solve(ub::vector<double> &x, const ub::vector<double> &b);
+
+    /// \brief Decompose(A) followed by Solve(x, b)
+    void Solve(ub::vector<double> &x, const ub::matrix<double> &A, const ub::vector<double> &b) {
+        Decompose(A);
+        Solve(x, b);
+    }
+
+private:
+    struct workspace_t;
+    workspace_t *_ws;
+
+    CholeskySolver(const CholeskySolver &);
+    CholeskySolver &operator=(const CholeskySolver &);
+};
+
+/**
+ * \brief solver for general square systems based on a LU decomposition
+ * with partial pivoting
+ */
+class LUSolver
+{
+public:
+    LUSolver();
+    ~LUSolver();
+
+    /**
+     * \brief factorize A
+     *
+     * throws a runtime_error if A is singular
+     */
+    void Decompose(const ub::matrix<double> &A);
+
+    /// \brief solve A*x=b for the last decomposed matrix
+    void Solve(ub::vector<double> &x, const ub::vector<double> &b);
+
+    /// \brief inverse of the last decomposed matrix
+    void Invert(ub::matrix<double> &V);
+
+    /// \brief Decompose(A) followed by Invert(V), replaces linalg_invert
+    void Invert(const ub::matrix<double> &A, ub::matrix<double> &V) {
+        Decompose(A);
+        Invert(V);
+    }
+
+private:
+    struct workspace_t;
+    workspace_t *_ws;
+
+    LUSolver(const LUSolver &);
+    LUSolver &operator=(const LUSolver &);
+};
+
+/**
+ * \brief eigensolver for symmetric matrices
+ */
+class EigenSolver
+{
+public:
+    EigenSolver();
+    ~EigenSolver();
+
+    /**
+     * \brief eigenvalues and eigenvectors of the symmetric matrix A
+     * @param A symmetric matrix
+     * @param E eigenvalues in ascending order
+     * @param V eigenvectors as columns
+     * @return true on success
+     */
+    bool Solve(const ub::matrix<double> &A, ub::vector<double> &E, ub::matrix<double> &V);
+
+private:
+    struct workspace_t;
+    workspace_t *_ws;
+
+    EigenSolver(const EigenSolver &);
+    EigenSolver &operator=(const EigenSolver &);
+};
+
+}}
+
+#endif	/* __VOTCA_TOOLS_LINALGSOLVERS_H */
@@ -24,15 +24,17 @@
 
 namespace votca { namespace tools {
 
-class matrix
+template<typename T>
+class matrix_t
 {
 public:
+    typedef T scalar_t;
         
-    matrix() {};
-    matrix(const double &v) { *this=v; }
-    matrix(const matrix &m) { *this=m; }
-    matrix(double  arr[9]) {*this=arr; }
-    matrix(const vec& a, const vec& b, const vec& c){
+    matrix_t() {};
+    matrix_t(const T &v) { *this=v; }
+    matrix_t(const matrix_t &m) { *this=m; }
+    matrix_t(T  arr[9]) {*this=arr; }
+    matrix_t(const vec_t<T>& a, const vec_t<T>& b, const vec_t<T>& c){
         _m[0]=a.getX(); _m[1]=b.getX(); _m[2]=c.getX();
         _m[3]=a.getY(); _m[4]=b.getY(); _m[5]=c.getY();
         _m[6]=a.getZ(); _m[7]=b.getZ(); _m[8]=c.getZ();
@@ -40,27 +42,27 @@ public:
     
     void Invert();
     
-    matrix &operator=(const double &v);
-    matrix &operator=(const matrix &v);
-    matrix &operator=(double [9]);
+    matrix_t &operator=(const T &v);
+    matrix_t &operator=(const matrix_t &v);
+    matrix_t &operator=(T [9]);
     //vec &operator+=(const vec &v);
     //vec &operator-=(const vec &v);
-    matrix &operator*=(const double &d){
+    matrix_t &operator*=(const T &d){
         for(size_t i=0; i<9; ++i) _m[i] *=d;
         return *this;
     }
     //matrix &operator*(const double &d){
     	
     //}
-    matrix &operator/=(const double &d){
+    matrix_t &operator/=(const T &d){
         for(size_t i=0; i<9; ++i) _m[i] /=d;
         return *this;
     }  
-    matrix &operator-=(const matrix &v){
+    matrix_t &operator-=(const matrix_t &v){
         for(size_t i=0; i<9; ++i) _m[i] -= v._m[i];
         return *this;
     }
-    matrix &operator+=(const matrix &v){
+    matrix_t &operator+=(const matrix_t &v){
         for(size_t i=0; i<9; ++i) _m[i] += v._m[i];
         return *this;
     }  
@@ -80,24 +82,24 @@ public:
      * @param j column
      * @param v value
      */
-    void set(const byte_t &i, const byte_t &j, const double &v) { _m[i*3+j] = v; }
+    void set(const byte_t &i, const byte_t &j, const T &v) { _m[i*3+j] = v; }
     /**
      * \brief get an element of the matrix
      */
-    const double &get(const byte_t &i, const byte_t &j) const { return _m[i*3+j]; }
+    const T &get(const byte_t &i, const byte_t &j) const { return _m[i*3+j]; }
 
     /**
      * \brief get a row vector
      * @param i row
      * @return row vector i
      */
-    vec getRow(const byte_t &i) const { return vec(&_m[i*3]); }
+    vec_t<T> getRow(const byte_t &i) const { return vec_t<T>(&_m[i*3]); }
     /**
      * \brief get a column vector
      * @param i column
      * @return column vector i
      */
-    vec getCol(const byte_t &i) const { return vec(_m[i], _m[i+3], _m[i+6]); }
+    vec_t<T> getCol(const byte_t &i) const { return vec_t<T>(_m[i], _m[i+3], _m[i+6]); }
     
     /**
      * \brief direct read/write access
@@ -105,11 +107,11 @@ public:
      * @return pointer to beginning of row i
      * use it as matrix[a][b]
      */
-    double *operator[](size_t i) { return &_m[i*3]; }
+    T *operator[](size_t i) { return &_m[i*3]; }
     
     struct eigensystem_t {
-        double eigenvalues[3];
-        vec eigenvecs[3];
+        T eigenvalues[3];
+        vec_t<T> eigenvecs[3];
         
         eigensystem_t operator+=(const eigensystem_t &e) {
             eigenvalues[0]+=e.eigenvalues[0];
@@ -121,7 +123,7 @@ public:
 	    return *this;
         }        
 
-        eigensystem_t operator*=(const double &f) {
+        eigensystem_t operator*=(const T &f) {
             eigenvalues[0]*=f;
             eigenvalues[1]*=f;
             eigenvalues[2]*=f;
@@ -133,7 +135,7 @@ public:
         
         void zero() {
             eigenvalues[0]=eigenvalues[1]=eigenvalues[2]=0;
-            eigenvecs[0]=eigenvecs[1]=eigenvecs[2]=vec(0.,0.,0.);
+            eigenvecs[0]=eigenvecs[1]=eigenvecs[2]=vec_t<T>(0.,0.,0.);
         }
     };
 
@@ -146,9 +148,37 @@ public:
      */
     void RandomRotation();
 
+    /**
+     * \brief create a uniform random rotation matrix with a given generator
+     * @param rng generator with a member rand_uniform(), e.g. RandomStream
+     *
+     * Same as RandomRotation(), but does not touch the global state of
+     * drand48 and is reproducible.
+     */
+    template<typename RNG>
+    void RandomRotation(RNG &rng) {
+        double theta = rng.rand_uniform();
+        double phi = rng.rand_uniform();
+        double z = rng.rand_uniform();
+        RotationFromUniform(theta, phi, z);
+    }
+
+    /**
+     * \brief rotation matrix from three numbers uniform in [0,1)
+     *
+     * Uniformly distributed input gives uniformly distributed rotations,
+     * see RandomRotation.
+     */
+    void RotationFromUniform(double u1, double u2, double u3);
+
     /**
      * \brief calculate eigenvalues and eigenvectors
      * @param out struct containing eigenvals + eigenvecs
+     *
+     * The matrix has to be symmetric. Eigenvalues are sorted in ascending
+     * order. They are calculated analytically (trigonometric solution of the
+     * characteristic polynomial), nearly isotropic matrices fall back to the
+     * Jacobi method (cjcbi).
      */
     void SolveEigensystem(eigensystem_t &out);
     
@@ -157,7 +187,7 @@ public:
      * @return the matrix after transpose
      *
      * After this operation, matrix stores the transposed value.
-     */matrix &Transpose(){
+     */matrix_t &Transpose(){
         std::swap( _m[1], _m[3]);
         std::swap( _m[2], _m[6]);
         std::swap( _m[5], _m[7]);
@@ -169,8 +199,8 @@ public:
      * @param a the matrix to multiply with
      * @return multiplied matrix
      */
-     matrix  operator * (const matrix & a){
-        matrix r;
+     matrix_t  operator * (const matrix_t & a) const {
+        matrix_t r;
         r._m[0] = _m[0] * a._m[0] + _m[1] * a._m[3] + _m[2] * a._m[6];
         r._m[1] = _m[0] * a._m[1] + _m[1] * a._m[4] + _m[2] * a._m[7];
         r._m[2] = _m[0] * a._m[2] + _m[1] * a._m[5] + _m[2] * a._m[8];
@@ -191,57 +221,89 @@ public:
      * @param a vector
      * @return A*x
      */
-     vec operator * ( const vec & a){
-       return vec( _m[0] * a.getX() + _m[1] * a.getY() + _m[2] * a.getZ(), 
+     vec_t<T> operator * ( const vec_t<T> & a) const {
+       return vec_t<T>( _m[0] * a.getX() + _m[1] * a.getY() + _m[2] * a.getZ(), 
                 _m[3] * a.getX() + _m[4] * a.getY() + _m[5] * a.getZ(),
                 _m[6] * a.getX() + _m[7] * a.getY() + _m[8] * a.getZ() ); 
     }
 
-    friend matrix operator*(const double &, const matrix &);
-    friend vec operator*(const vec &, const matrix &);
-    
     template<class Archive>
     void serialize(Archive &arch, const unsigned int version) { arch & _m; }
+
+    // friends defined in the class, see vec_t for the reason
+    friend matrix_t operator*(const matrix_t &r, const T &d)
+    {
+        return (matrix_t(r) *= d);
+    }
+
+    friend matrix_t operator*(const T &d, const matrix_t &m)
+    {
+        return (matrix_t(m) *= d);
+    }
+
+    friend matrix_t operator/(const matrix_t &r, const T &d)
+    {
+        return (matrix_t(r) /= d);
+    }
+
+    friend matrix_t operator+(const matrix_t &r, const matrix_t &v)
+    {
+        return (matrix_t(r) += v);
+    }
+
+    friend matrix_t operator-(const matrix_t &r, const matrix_t &v)
+    {
+        return (matrix_t(r) -= v);
+    }
     
 private:
-    double _m[9];
+    T _m[9];
 };
 
-inline matrix &matrix::operator=(const double &v)
+typedef matrix_t<double> matrix;
+typedef matrix_t<float> matrixf;
+
+template<typename T>
+inline matrix_t<T> &matrix_t<T>::operator=(const T &v)
 {
     for(size_t i=0; i<9; ++i)
         _m[i] = v;
     return *this;
 }
 
-inline matrix &matrix::operator=(const matrix &m)
+template<typename T>
+inline matrix_t<T> &matrix_t<T>::operator=(const matrix_t &m)
 {
     for(size_t i=0; i<9; ++i)
         _m[i] = m._m[i];
     return *this;
 }
 
-inline matrix &matrix::operator=(double arr[9])
+template<typename T>
+inline matrix_t<T> &matrix_t<T>::operator=(T arr[9])
 {
     for(size_t i=0; i<9; ++i)
         _m[i] = arr[i];
     return *this;
 }
 
-inline void matrix::UnitMatrix()
+template<typename T>
+inline void matrix_t<T>::UnitMatrix()
 {
     ZeroMatrix();
     _m[0] = _m[4] = _m[8] = 1.0;
 }
 
-inline void matrix::ZeroMatrix()
+template<typename T>
+inline void matrix_t<T>::ZeroMatrix()
 {
     for(size_t i=0; i<9; ++i)
         _m[i] = 0.;//(*this) = 0.;
     
 }
 
-inline std::ostream &operator<<(std::ostream &out, matrix& m)
+template<typename T>
+inline std::ostream &operator<<(std::ostream &out, matrix_t<T>& m)
 {
       out << '|' << m[0][0] << ',' << m[0][1] << ',' << m[0][2] << '|' << std::endl;
       out << '|' << m[1][0] << ',' << m[1][1] << ',' << m[1][2] << '|' << std::endl;
@@ -249,55 +311,26 @@ inline std::ostream &operator<<(std::ostream &out, matrix& m)
       return out;
 }
 
-inline matrix operator|( const vec & a, const vec & b){
-    matrix res;
-    res.set(0,0, a.getX() * b.getX());
-    res.set(0,1, a.getX() * b.getY());
-    res.set(0,2, a.getX() * b.getZ());
-    res.set(1,0, a.getY() * b.getX());
-    res.set(1,1, a.getY() * b.getY());
-    res.set(1,2, a.getY() * b.getZ());
-    res.set(2,0, a.getZ() * b.getX());
-    res.set(2,1, a.getZ() * b.getY());
-    res.set(2,2, a.getZ() * b.getZ());
-    return res;
-}
-
-
-inline matrix operator*(const matrix & r, const double &d){
-    return ( matrix(r) *= d);
-}
-
-inline matrix operator*(const double &d, const matrix &m)
-{
-        matrix mm;
-	for(size_t i=0; i<9; ++i)
-	    mm._m[i] = d*m._m[i];
-	return mm;
-}
-
-inline vec operator*(const matrix & r, const vec &a){
-        return matrix(r) * a;
-}
-
-
-inline matrix operator/(const matrix & r,const double &d){
-    return ( matrix(r) /= d);
-}  
-inline matrix operator+(const matrix & r, const matrix & v){
-    return ( matrix(r) += v);
-}
-inline matrix operator-(const matrix & r, const matrix & v){
-    return ( matrix(r) -= v);
-}
-    
-
 /* provided the matrix a diagonalizes it and returns the eigenvalues 
    lambda0 = a[0][0], lambda1 = a[1][1], lambda2= a[2][2], ...
    as well as the corresponding eigenvectors v[][0], v[][1], v[][2] 
 */
 int cjcbi(matrix &a, matrix &v, double eps=1e-10, int jt=100);
 
+/**
+ * \brief solve the eigensystems of many symmetric matrices
+ * @param m array of n symmetric matrices
+ * @param out array of n eigensystems
+ * @param n number of matrices
+ *
+ * Gives the same result as calling SolveEigensystem for every matrix, but
+ * the eigenvalues of a whole block of matrices are calculated in one
+ * vectorizable loop. Use it for gyration or inertia tensors of all
+ * molecules of a frame.
+ */
+template<typename T>
+void SolveEigensystems(const matrix_t<T> *m, typename matrix_t<T>::eigensystem_t *out, size_t n);
+
 }}
 
 #endif	/* _matrix_H */
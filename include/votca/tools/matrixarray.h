@@ -0,0 +1,106 @@
+/*
+ * Copyright 2009-2014 The VOTCA Development Team (http://www.votca.org)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#ifndef _VOTCA_TOOLS_MATRIXARRAY_H
+#define	_VOTCA_TOOLS_MATRIXARRAY_H
+
+#include <vector>
+#include "matrix.h"
+#include "vecarray.h"
+
+namespace votca { namespace tools {
+
+/**
+ * \brief array of 3x3 matrices in structure of arrays layout
+ *
+ * Each of the 9 elements is stored in its own 64 byte aligned array, so
+ * the kernels below (multiply, transpose, determinant, invert) process
+ * many matrices with vector instructions instead of looping over single
+ * matrix objects. Typical uses are the rotations or inertia tensors of all
+ * molecules of a frame.
+ */
+class MatrixArray
+{
+public:
+    MatrixArray();
+    explicit MatrixArray(size_t n);
+    explicit MatrixArray(const std::vector<matrix> &m);
+    MatrixArray(const MatrixArray &a);
+    ~MatrixArray();
+
+    MatrixArray &operator=(const MatrixArray &a);
+
+    /// \brief number of matrices
+    size_t size() const { return _size; }
+    /// \brief change the number of matrices, new elements are uninitialized
+    void resize(size_t n);
+    /// \brief reserve memory for n matrices
+    void reserve(size_t n);
+    void clear() { _size = 0; }
+
+    /**
+     * \brief array of element (i,j) of all matrices, aligned to 64 bytes
+     * @param i row
+     * @param j column
+     */
+    double *element(int i, int j) { return _c[3*i+j]; }
+    const double *element(int i, int j) const { return _c[3*i+j]; }
+
+    /// \brief copy of the k-th matrix
+    matrix operator[](size_t k) const;
+    /// \brief set the k-th matrix
+    void set(size_t k, const matrix &m);
+    void push_back(const matrix &m);
+
+    /// \brief replace content by a copy of m
+    void FromVector(const std::vector<matrix> &m);
+    /// \brief copy content to m, m is resized
+    void ToVector(std::vector<matrix> &m) const;
+
+private:
+    /// element arrays in row major order, all in one block owned by _c[0]
+    double *_c[9];
+    size_t _size;
+    size_t _capacity;
+};
+
+/**
+ * \brief out[k] = a[k]*b[k]
+ *
+ * With rotation matrices this composes the rotations (first b, then a).
+ * out may be the same array as a or b.
+ */
+void multiply(const MatrixArray &a, const MatrixArray &b, MatrixArray &out);
+/// \brief out[k] = r*a[k], e.g. apply the same rotation to all matrices
+void multiply(const matrix &r, const MatrixArray &a, MatrixArray &out);
+/// \brief out[k] = a[k]*v[k], out may be the same array as v
+void multiply(const MatrixArray &a, const VecArray &v, VecArray &out);
+/// \brief out[k] = transpose of a[k], out may be the same array as a
+void transpose(const MatrixArray &a, MatrixArray &out);
+/// \brief out[k] = det(a[k])
+void determinant(const MatrixArray &a, double *out);
+/**
+ * \brief out[k] = inverse of a[k]
+ *
+ * Same as matrix::Invert, singular matrices give inf or nan elements.
+ * out may be the same array as a.
+ */
+void invert(const MatrixArray &a, MatrixArray &out);
+
+}}
+
+#endif	/* _VOTCA_TOOLS_MATRIXARRAY_H */
@@ -40,6 +40,31 @@ namespace votca {
 
         private:
             pthread_mutex_t _mutexVar;
+
+            // a mutex cannot be copied
+            Mutex(const Mutex &);
+            Mutex &operator=(const Mutex &);
+
+            friend class Condition;
+        };
+
+/**
+         \brief Locks a Mutex for the lifetime of the object
+
+         * The mutex is unlocked in the destructor, also if an exception
+         * leaves the scope.
+
+         */
+        class ScopedLock {
+        public:
+            explicit ScopedLock(Mutex &mutex) : _mutex(mutex) { _mutex.Lock(); }
+            ~ScopedLock() { _mutex.Unlock(); }
+
+        private:
+            Mutex &_mutex;
+
+            ScopedLock(const ScopedLock &);
+            ScopedLock &operator=(const ScopedLock &);
         };
 
     }
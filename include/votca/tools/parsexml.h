@@ -19,22 +19,70 @@
 #define _PARSEXML_H
 
 #include <string>
-#include <stack>
+#include <deque>
+#include <new>
 #include <map>
 #include <list>
+#include <string.h>
+#include <stdexcept>
+#include <boost/static_assert.hpp>
+#include <boost/utility/string_ref.hpp>
+#include "lexical_cast.h"
 
 namespace votca { namespace tools {
     
 using namespace std;
 
+/**
+    \brief read-only view of the attributes of an XML element
+
+    The view points directly into the attribute array of the parser, no
+    strings are copied. It is only valid inside the element handler.
+  */
+class XMLAttributes {
+public:
+    explicit XMLAttributes(const char **attr) : _attr(attr) {}
+
+    /// \brief number of attributes
+    size_t size() const;
+    /// \brief name of i-th attribute
+    const char *name(size_t i) const { return _attr[2*i]; }
+    /// \brief value of i-th attribute
+    const char *value(size_t i) const { return _attr[2*i+1]; }
+
+    /// \brief value of an attribute or NULL if it does not exist
+    const char *find(const char *name) const;
+    /// \brief check whether an attribute exists
+    bool has(const char *name) const { return find(name) != NULL; }
+
+    /**
+     * \brief return attribute as type
+     *
+     * throws a runtime_error if the attribute does not exist
+     */
+    template<typename T>
+    T get(const char *name) const;
+
+private:
+    const char **_attr;
+};
+
 /**
     \brief XML SAX parser (wrapper for expat)
 
     This class is a wrapper for the expat SAX interface. Parsing the xml file
     is done via callback functions (Element handlers).
 
-    The class implements contains a stupid implementation for functors to
-    handle callbacks to memeber functions but there is lots of room for improvement.
+    Handlers are member functions of the form
+        void Handler(const boost::string_ref &el, const XMLAttributes &attr)
+    which get the element name and the attributes as views into the parser
+    buffers. The handler objects are constructed in a pool of slots which is
+    reused for every element, so parsing does not allocate memory per element.
+
+    The older form
+        void Handler(const string &el, map<string, string> &attr)
+    is still supported, it copies name and attributes for every element.
+
     So far only callbacks for start element handlers is implemented. The extension
     to EndElement handler (to signal if an element is close) is similar and straight
     forward. So far it was not needed and was therefore not done.
@@ -43,9 +91,9 @@ using namespace std;
 class ParseXML {
 public:
     /// constructor
-    ParseXML() {}
+    ParseXML() : _depth(0) {}
     /// destructor
-    ~ParseXML() {}
+    ~ParseXML();
 
     /**
      * \brief open an XML file and start parsing it
@@ -57,6 +105,16 @@ public:
      */
     void Open(const string &_filename);
 
+    /**
+     * \brief parse an XML document in memory
+     * @param data begin of the document
+     * @param size size of the document in bytes
+     * @param name name of the document used in error messages
+     *
+     * Same as Open, but the document is already in memory.
+     */
+    void OpenBuffer(const char *data, size_t size, const string &name = "xml buffer");
+
     /**
      * \brief Set handler for next element (only member functions possible)
      * @param object instance of class which for callback
@@ -66,6 +124,10 @@ public:
      * say what is coming next. Optionally call IgnoreElement
      */
     template<typename T>
+    void NextHandler(T *object, void (T::*fkt)(const boost::string_ref &, const XMLAttributes &));
+
+    /// \brief Set handler for next element, copies name and attributes
+    template<typename T>
     void NextHandler(T *object, void (T::*fkt)(const string &, map<string, string> &));
 
     /**
@@ -74,56 +136,131 @@ public:
     void IgnoreChilds();
     
 private:
-    // virtual void ParseRoot(const string &el, map<string, string> &attr);
-    void ParseIgnore(const string &el, map<string, string> &attr);
+    void ParseIgnore(const boost::string_ref &el, const XMLAttributes &attr);
 
-    
+    /// start element callback for xml parser
+    void StartElemHndl(const char *el, const char **attr);
     /// end element callback for xml parser
-    void StartElemHndl(const string &el, map<string, string> &attr);
-    /// end element callback for xml parser
-    void EndElemHndl(const string &el);
-
+    void EndElemHndl(const char *el);
 
     class Functor {
     public:
         Functor() {}
-        virtual void operator()(const string &, map<string, string> &) = 0;
+        virtual void operator()(const boost::string_ref &, const XMLAttributes &) = 0;
         virtual ~Functor() {};
     };
 
     template<typename T>
     class FunctorMember : public Functor {
     public:
-        typedef void (T::*fkt_t)(const string &, map<string, string> &);
+        typedef void (T::*fkt_t)(const boost::string_ref &, const XMLAttributes &);
 
         FunctorMember(T* cls, fkt_t fkt) : _cls(cls), _fkt(fkt) {}
-        
-        void operator()(const string &el, map<string, string> & attr) {
+
+        void operator()(const boost::string_ref &el, const XMLAttributes &attr) {
             (_cls->*_fkt)(el, attr);
         }
-        
+
     private:
         T* _cls;
         fkt_t _fkt;
     };
 
-    stack<Functor *> _stack_handler;
-    Functor *_handler;
+    /// adapter for handlers taking string and map
+    template<typename T>
+    class FunctorMemberMap : public Functor {
+    public:
+        typedef void (T::*fkt_t)(const string &, map<string, string> &);
+
+        FunctorMemberMap(T* cls, fkt_t fkt) : _cls(cls), _fkt(fkt) {}
+
+        void operator()(const boost::string_ref &el, const XMLAttributes &attr) {
+            map<string, string> mattr;
+            for (size_t i = 0; i < attr.size(); ++i)
+                mattr[attr.name(i)] = attr.value(i);
+            string sel(el.data(), el.size());
+            (_cls->*_fkt)(sel, mattr);
+        }
+
+    private:
+        T* _cls;
+        fkt_t _fkt;
+    };
+
+    /// storage for one handler, one slot per open element
+    struct handler_slot_t {
+        enum { size = 8*sizeof(void*) };
+        Functor *handler;
+        union {
+            void *align_ptr;
+            double align_double;
+            char data[size];
+        } storage;
+    };
+
+    /// slots are never freed while parsing, deque keeps them in place
+    deque<handler_slot_t> _slots;
+    /// number of slots in use
+    size_t _depth;
+
+    /// memory for the next handler
+    void *PushSlot();
+    void PopSlot();
 
     friend void start_hndl(void *data, const char *el, const char **attr);
     friend void end_hndl(void *data, const char *el);
 };
 
+inline size_t XMLAttributes::size() const
+{
+    size_t n = 0;
+    while (_attr[2*n]) ++n;
+    return n;
+}
+
+inline const char *XMLAttributes::find(const char *name) const
+{
+    for (size_t i = 0; _attr[i]; i += 2)
+        if (strcmp(_attr[i], name) == 0)
+            return _attr[i + 1];
+    return NULL;
+}
+
+template<typename T>
+inline T XMLAttributes::get(const char *name) const
+{
+    const char *v = find(name);
+    if (!v)
+        throw std::runtime_error(string("attribute ") + name + " not found\n");
+    return lexical_cast<T>(string(v), string("wrong type in attribute ") + name + "\n");
+}
+
+inline void *ParseXML::PushSlot()
+{
+    if (_depth == _slots.size())
+        _slots.push_back(handler_slot_t());
+    return _slots[_depth++].storage.data;
+}
+
 inline void ParseXML::IgnoreChilds()
 {
     NextHandler(this, &ParseXML::ParseIgnore);
 }
 
+template<typename T>
+inline void ParseXML::NextHandler(T *object, void (T::*fkt)(const boost::string_ref &, const XMLAttributes &))
+{
+    BOOST_STATIC_ASSERT(sizeof(FunctorMember<T>) <= handler_slot_t::size);
+    void *mem = PushSlot();
+    _slots[_depth-1].handler = new (mem) FunctorMember<T>(object, fkt);
+}
+
 template<typename T>
 inline void ParseXML::NextHandler(T *object, void (T::*fkt)(const string &, map<string, string> &))
 {
-    _handler = dynamic_cast<Functor*>(new FunctorMember<T>(object, fkt));
-    _stack_handler.push(_handler);
+    BOOST_STATIC_ASSERT(sizeof(FunctorMemberMap<T>) <= handler_slot_t::size);
+    void *mem = PushSlot();
+    _slots[_depth-1].handler = new (mem) FunctorMemberMap<T>(object, fkt);
 }
 
 }}
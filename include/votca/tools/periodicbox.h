@@ -0,0 +1,112 @@
+/*
+ * Copyright 2009-2014 The VOTCA Development Team (http://www.votca.org)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#ifndef _VOTCA_TOOLS_PERIODICBOX_H
+#define	_VOTCA_TOOLS_PERIODICBOX_H
+
+#include "matrix.h"
+#include "vecarray.h"
+
+namespace votca { namespace tools {
+
+/**
+ * \brief periodic simulation cell with minimum image kernels
+ *
+ * The box is given by a matrix with the three box vectors a, b and c as
+ * columns, see matrix(const vec&, const vec&, const vec&). The type of the
+ * box is detected at construction:
+ *  - open: all box vectors are zero, no periodic boundaries
+ *  - orthorhombic: the matrix is diagonal, images are removed per component
+ *  - triclinic: everything else, images are removed in fractional coordinates
+ *
+ * The kernels work on SoA coordinates (VecArray, VecArrayf) and vectorize.
+ * Displacements always point from the first to the second argument.
+ *
+ * For triclinic boxes the result is the shortest image whenever that is
+ * shorter than half the smallest perpendicular width of the cell (see
+ * MaxCutoff), which covers all cutoff based analyses. Longer displacements
+ * are reduced to the cell around the origin, but need not be the shortest.
+ */
+class PeriodicBox
+{
+public:
+    enum box_type_t {
+        typeOpen,
+        typeOrthorhombic,
+        typeTriclinic
+    };
+
+    /// \brief open box
+    PeriodicBox();
+    /// \brief box with the box vectors as columns of box
+    explicit PeriodicBox(const matrix &box);
+
+    /// \brief change the box, the type is detected again
+    void setBox(const matrix &box);
+    const matrix &getBox() const { return _box; }
+    box_type_t getType() const { return _type; }
+    double Volume() const;
+    /**
+     * \brief half the smallest perpendicular width of the cell
+     *
+     * Minimum image results are exact for distances up to this value.
+     */
+    double MaxCutoff() const;
+
+    /// \brief shortest image of the displacement d
+    vec MinimumImage(const vec &d) const;
+    /// \brief shortest connection from r1 to r2
+    vec Displacement(const vec &r1, const vec &r2) const { return MinimumImage(r2 - r1); }
+    /// \brief minimum image distance of r1 and r2
+    double Distance(const vec &r1, const vec &r2) const { return abs(Displacement(r1, r2)); }
+
+    /// \brief replace all displacements in d by their shortest image
+    template<typename T>
+    void MinimumImage(VecArray_t<T> &d) const;
+    /// \brief out[i] = shortest connection from a[i] to b[i], out is resized
+    template<typename T>
+    void Displacements(const VecArray_t<T> &a, const VecArray_t<T> &b, VecArray_t<T> &out) const;
+    /// \brief out[i] = shortest connection from p to a[i], out is resized
+    template<typename T>
+    void Displacements(const vec_t<T> &p, const VecArray_t<T> &a, VecArray_t<T> &out) const;
+    /// \brief out[i] = minimum image distance of a[i] and b[i]
+    template<typename T>
+    void Distances(const VecArray_t<T> &a, const VecArray_t<T> &b, T *out) const;
+    /// \brief out[i] = minimum image distance of p and a[i]
+    template<typename T>
+    void Distances(const vec_t<T> &p, const VecArray_t<T> &a, T *out) const;
+    /// \brief out[i] = squared minimum image distance of a[i] and b[i]
+    template<typename T>
+    void Distances2(const VecArray_t<T> &a, const VecArray_t<T> &b, T *out) const;
+    /// \brief out[i] = squared minimum image distance of p and a[i]
+    template<typename T>
+    void Distances2(const vec_t<T> &p, const VecArray_t<T> &a, T *out) const;
+
+private:
+    matrix _box;
+    /// inverse box, maps to fractional coordinates
+    matrix _inverse;
+    box_type_t _type;
+
+    /// call op with the minimum image function for the type of the box
+    template<typename T, typename Op>
+    void Dispatch(const Op &op) const;
+};
+
+}}
+
+#endif	/* _VOTCA_TOOLS_PERIODICBOX_H */
@@ -227,6 +227,20 @@ inline bool Property::exists(const string &key)
     
 bool load_property_from_xml(Property &p, string file);
 
+/**
+ * \brief load a property tree from an XML document in memory
+ * @param p property to fill
+ * @param data begin of the document
+ * @param size size of the document in bytes
+ */
+bool load_property_from_xml_buffer(Property &p, const char *data, size_t size);
+
+/// \brief load a property tree from an XML document stored in a string
+inline bool load_property_from_xml_string(Property &p, const string &xml)
+{
+    return load_property_from_xml_buffer(p, xml.data(), xml.size());
+}
+
 // TO DO: write a better function for this!!!!
 template<>
 inline bool Property::as<bool>() const
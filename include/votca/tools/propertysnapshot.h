@@ -0,0 +1,138 @@
+/*
+ * Copyright 2009-2014 The VOTCA Development Team (http://www.votca.org)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#ifndef _VOTCA_TOOLS_PROPERTYSNAPSHOT_H
+#define	_VOTCA_TOOLS_PROPERTYSNAPSHOT_H
+
+#include <string>
+#include <vector>
+#include <iostream>
+#include <boost/cstdint.hpp>
+#include "property.h"
+
+namespace votca { namespace tools {
+
+/**
+ * \brief information about an XML file a snapshot was created from
+ *
+ * A snapshot is only valid for a file with exactly the same path, size,
+ * modification time and content hash.
+ */
+struct snapshot_source_t {
+    snapshot_source_t() : size(0), mtime(0), hash(0) {}
+
+    std::string path;
+    boost::uint64_t size;
+    boost::int64_t mtime;
+    boost::uint64_t hash;
+
+    /**
+     * \brief fill in all fields for a file on disk
+     * @param filename file to describe
+     * @param content if not NULL, the file is read into content and the
+     *        description belongs to exactly this data
+     */
+    void FromFile(const std::string &filename, std::vector<char> *content = NULL);
+
+    bool operator==(const snapshot_source_t &s) const {
+        return path == s.path && size == s.size && mtime == s.mtime && hash == s.hash;
+    }
+};
+
+/**
+ * \brief write the childs of p in the binary snapshot format
+ * @param p property tree
+ * @param source description of the file the tree was read from
+ * @param out output stream (opened in binary mode)
+ * @param skip number of leading childs of p to leave out
+ *
+ * The snapshot contains names, values, attributes and the complete child
+ * structure. The format is versioned and does not depend on the byte
+ * order of the machine.
+ */
+void save_property_snapshot(Property &p, const snapshot_source_t &source,
+        std::ostream &out, size_t skip = 0);
+
+/**
+ * \brief append the trees of a snapshot as childs of p
+ * @param p property to add the trees to
+ * @param data begin of the snapshot in memory
+ * @param size size of the snapshot
+ * @param source if not NULL, the description of the source file is stored here
+ *
+ * Throws a runtime_error if the data is not a valid snapshot.
+ */
+void load_property_snapshot(Property &p, const char *data, size_t size,
+        snapshot_source_t *source = NULL);
+
+/**
+ * \brief cache of binary snapshots of parsed XML files
+ *
+ * The cache keeps one snapshot per XML file in a directory. Load only
+ * succeeds if the snapshot matches the current state of the XML file, so
+ * stale entries are never used.
+ *
+ * load_property_from_xml uses the cache in the directory given by the
+ * environment variable VOTCA_PROPERTY_CACHE, if it is set.
+ */
+class PropertySnapshotCache
+{
+public:
+    explicit PropertySnapshotCache(const std::string &directory);
+
+    /**
+     * \brief load the snapshot of an XML file
+     * @param p property to append the trees to
+     * @param filename XML file
+     * @return true if a valid snapshot was found and loaded
+     */
+    bool Load(Property &p, const std::string &filename);
+
+    /**
+     * \brief store a snapshot of the parsed XML file
+     * @param p property tree read from filename
+     * @param filename XML file
+     * @param skip number of leading childs of p which do not come from filename
+     *
+     * Errors writing the cache are ignored, the cache is only an optimization.
+     */
+    void Store(Property &p, const std::string &filename, size_t skip = 0);
+
+    /**
+     * \brief store a snapshot of a tree parsed from a copy of an XML file
+     * @param p property tree parsed from the data described by source
+     * @param source description of the file content, see snapshot_source_t::FromFile
+     * @param skip number of leading childs of p which do not come from the file
+     *
+     * Use this if the file might change while it is parsed, the snapshot
+     * then is still tagged with the content the tree was built from.
+     */
+    void Store(Property &p, const snapshot_source_t &source, size_t skip = 0);
+
+    /// \brief name of the snapshot file for an XML file
+    std::string SnapshotFile(const std::string &filename) const;
+
+    /// \brief cache configured by VOTCA_PROPERTY_CACHE or NULL if not set
+    static PropertySnapshotCache *Default();
+
+private:
+    std::string _directory;
+};
+
+}}
+
+#endif	/* _VOTCA_TOOLS_PROPERTYSNAPSHOT_H */
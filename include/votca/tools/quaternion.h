@@ -0,0 +1,212 @@
+/*
+ * Copyright 2009-2014 The VOTCA Development Team (http://www.votca.org)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#ifndef _VOTCA_TOOLS_QUATERNION_H
+#define	_VOTCA_TOOLS_QUATERNION_H
+
+#include <iostream>
+#include "vec.h"
+#include "matrix.h"
+#include "vecarray.h"
+
+namespace votca { namespace tools {
+
+/**
+ * \brief quaternion, mainly used as a rotation
+ *
+ * A unit quaternion q = (w, x, y, z) describes the rotation by the angle
+ * 2*acos(w) around the axis (x, y, z). Compared to a rotation matrix it
+ * needs 4 instead of 9 numbers, composing two rotations is cheaper and a
+ * quaternion can be renormalized when rounding errors accumulate after
+ * many compositions.
+ *
+ * The product q1*q2 is the rotation q2 followed by q1, like for matrices.
+ */
+class quaternion
+{
+public:
+    quaternion() {}
+    quaternion(const double &w, const double &x, const double &y, const double &z)
+        : _w(w), _x(x), _y(y), _z(z) {}
+    /// \brief quaternion from scalar and vector part
+    quaternion(const double &w, const vec &v)
+        : _w(w), _x(v.getX()), _y(v.getY()), _z(v.getZ()) {}
+    /// \brief quaternion of a rotation matrix
+    explicit quaternion(const matrix &rotation) { FromMatrix(rotation); }
+
+    /// \brief rotation by angle (in radians) around axis
+    static quaternion FromAxisAngle(const vec &axis, double angle);
+    /// \brief the rotation which does nothing
+    static quaternion Identity() { return quaternion(1., 0., 0., 0.); }
+
+    const double &getW() const { return _w; }
+    const double &getX() const { return _x; }
+    const double &getY() const { return _y; }
+    const double &getZ() const { return _z; }
+    /// \brief vector part
+    vec getVector() const { return vec(_x, _y, _z); }
+
+    quaternion &operator+=(const quaternion &q) {
+        _w += q._w; _x += q._x; _y += q._y; _z += q._z;
+        return *this;
+    }
+    quaternion &operator-=(const quaternion &q) {
+        _w -= q._w; _x -= q._x; _y -= q._y; _z -= q._z;
+        return *this;
+    }
+    quaternion &operator*=(const double &d) {
+        _w *= d; _x *= d; _y *= d; _z *= d;
+        return *this;
+    }
+    /// \brief compose, *this = (*this)*q
+    quaternion &operator*=(const quaternion &q);
+
+    /// \brief length of the quaternion
+    double norm() const { return sqrt(_w*_w + _x*_x + _y*_y + _z*_z); }
+    /// \brief scale to unit length, call after many compositions
+    quaternion &normalize() { return (*this) *= 1./norm(); }
+    /// \brief conjugate, the inverse rotation for unit quaternions
+    quaternion conjugate() const { return quaternion(_w, -_x, -_y, -_z); }
+
+    /// \brief rotate v, the quaternion has to be normalized
+    vec Rotate(const vec &v) const;
+
+    /// \brief rotation matrix, the quaternion has to be normalized
+    matrix ToMatrix() const;
+    /**
+     * \brief set from a rotation matrix
+     *
+     * Uses Shepperd's method, which is stable for all rotations. The result
+     * is normalized and has w >= 0.
+     */
+    void FromMatrix(const matrix &rotation);
+
+    /**
+     * \brief uniform random rotation
+     *
+     * Uses drand48, see RandomRotation(RNG&) for a reproducible version.
+     */
+    void RandomRotation();
+
+    /**
+     * \brief uniform random rotation with a given generator
+     * @param rng generator with a member rand_uniform(), e.g. RandomStream
+     */
+    template<typename RNG>
+    void RandomRotation(RNG &rng) {
+        double u1 = rng.rand_uniform();
+        double u2 = rng.rand_uniform();
+        double u3 = rng.rand_uniform();
+        RotationFromUniform(u1, u2, u3);
+    }
+
+    /**
+     * \brief rotation from three numbers uniform in [0,1)
+     *
+     * Shoemake's method: uniformly distributed input gives uniformly
+     * distributed rotations.
+     */
+    void RotationFromUniform(double u1, double u2, double u3);
+
+    template<class Archive>
+    void serialize(Archive &arch, const unsigned int version) { arch & _w; arch & _x; arch & _y; arch & _z; }
+
+private:
+    double _w, _x, _y, _z;
+};
+
+inline quaternion operator+(const quaternion &q1, const quaternion &q2)
+{
+    return quaternion(q1) += q2;
+}
+
+inline quaternion operator-(const quaternion &q1, const quaternion &q2)
+{
+    return quaternion(q1) -= q2;
+}
+
+inline quaternion operator*(const quaternion &q, const double &d)
+{
+    return quaternion(q) *= d;
+}
+
+inline quaternion operator*(const double &d, const quaternion &q)
+{
+    return quaternion(q) *= d;
+}
+
+/// \brief Hamilton product, the rotation q2 followed by q1
+inline quaternion operator*(const quaternion &q1, const quaternion &q2)
+{
+    return quaternion(
+        q1.getW()*q2.getW() - q1.getX()*q2.getX() - q1.getY()*q2.getY() - q1.getZ()*q2.getZ(),
+        q1.getW()*q2.getX() + q1.getX()*q2.getW() + q1.getY()*q2.getZ() - q1.getZ()*q2.getY(),
+        q1.getW()*q2.getY() - q1.getX()*q2.getZ() + q1.getY()*q2.getW() + q1.getZ()*q2.getX(),
+        q1.getW()*q2.getZ() + q1.getX()*q2.getY() - q1.getY()*q2.getX() + q1.getZ()*q2.getW());
+}
+
+inline quaternion &quaternion::operator*=(const quaternion &q)
+{
+    return *this = (*this) * q;
+}
+
+/// \brief 4 dimensional dot product
+inline double dot(const quaternion &q1, const quaternion &q2)
+{
+    return q1.getW()*q2.getW() + q1.getX()*q2.getX() + q1.getY()*q2.getY() + q1.getZ()*q2.getZ();
+}
+
+inline vec quaternion::Rotate(const vec &v) const
+{
+    // v' = v + 2w (u x v) + 2 u x (u x v) with the vector part u
+    vec u(_x, _y, _z);
+    vec t = 2.*(u^v);
+    return v + _w*t + (u^t);
+}
+
+inline std::ostream &operator<<(std::ostream &out, const quaternion &q)
+{
+    out << '[' << q.getW() << ", " << q.getX() << ", " << q.getY() << ", " << q.getZ() << ']';
+    return out;
+}
+
+/**
+ * \brief spherical linear interpolation between two rotations
+ * @param q1 rotation for t = 0
+ * @param q2 rotation for t = 1
+ * @param t interpolation parameter in [0,1]
+ *
+ * Interpolates along the shorter arc with constant angular velocity, both
+ * quaternions have to be normalized.
+ */
+quaternion slerp(const quaternion &q1, const quaternion &q2, double t);
+
+/// \brief out[i] = q applied to v[i], out is resized and may be v
+template<typename T>
+void rotate(const quaternion &q, const VecArray_t<T> &v, VecArray_t<T> &out);
+
+/**
+ * \brief rigid body rotation: out[i] = center + q applied to (v[i] - center)
+ *
+ * out is resized and may be v.
+ */
+template<typename T>
+void rotate(const quaternion &q, const vec_t<T> &center, const VecArray_t<T> &v, VecArray_t<T> &out);
+
+}}
+
+#endif	/* _VOTCA_TOOLS_QUATERNION_H */
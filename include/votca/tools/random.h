@@ -47,12 +47,20 @@ public:
     static double rand_uniform( void );
     static int rand_uniform_int( int max_int );
     static double rand_gaussian( double sigma );
+    /// fill out with n numbers uniform in [0,1), same as n calls of rand_uniform
+    static void fill_uniform( double *out, size_t n );
+    /// fill out with n integers in [0,max_int-1]
+    static void fill_uniform_int( int *out, size_t n, int max_int );
+    /// fill out with n gaussian numbers, uses both numbers of each Box-Muller pair
+    static void fill_gaussian( double *out, size_t n, double sigma );
     static void save( char *fileName );
     static void restore( char *fileName );
 
 private:
     static double  *MARSarray, MARSc, MARScd, MARScm ;
     static int     MARSi, MARSj ; 
+
+    friend class RNGCheckpoint;
 };
 
 }}
@@ -46,7 +46,7 @@ class Random2
 {
 public:
 
-    Random2() {};
+    Random2() : MARSarray(NULL) {};
    ~Random2() {};
 
     void    init( int nA1, int nA2, int nA3, int nB1 );
@@ -57,10 +57,19 @@ public:
     int     rand_uniform_int( int max_int );
     double  rand_gaussian( double sigma );
 
+    /// fill out with n numbers uniform in [0,1), same as n calls of rand_uniform
+    void    fill_uniform( double *out, size_t n );
+    /// fill out with n integers in [0,max_int-1]
+    void    fill_uniform_int( int *out, size_t n, int max_int );
+    /// fill out with n gaussian numbers, uses both numbers of each Box-Muller pair
+    void    fill_gaussian( double *out, size_t n, double sigma );
+
 private:
 
     double  *MARSarray, MARSc, MARScd, MARScm ;
     int     MARSi, MARSj ; 
+
+    friend class RNGCheckpoint;
 };
 
 }}
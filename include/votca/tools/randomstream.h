@@ -0,0 +1,140 @@
+/*
+ * Copyright 2009-2014 The VOTCA Development Team (http://www.votca.org)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#ifndef _VOTCA_TOOLS_RANDOMSTREAM_H
+#define	_VOTCA_TOOLS_RANDOMSTREAM_H
+
+#include <stddef.h>
+#include <boost/cstdint.hpp>
+
+namespace votca { namespace tools {
+
+/**
+ * \brief counter-based random number stream (Philox4x32-10)
+ *
+ * The n-th number of a stream is a pure function of (seed, stream id, n):
+ * Philox encrypts a 128 bit counter with the seed as key. There is no
+ * shared state, every thread or task uses its own stream id, and jumping
+ * to any position (skip) is O(1). Results are therefore reproducible
+ * independent of the number of threads, as long as work items always use
+ * the same stream id.
+ *
+ * See: J. K. Salmon, M. A. Moraes, R. O. Dror and D. E. Shaw, Parallel
+ * random numbers: as easy as 1, 2, 3, SC11 (2011).
+ */
+class RandomStream
+{
+public:
+    typedef boost::uint32_t uint32_t;
+    typedef boost::uint64_t uint64_t;
+
+    /// \brief stream number stream of seed, positioned at the start
+    explicit RandomStream(uint64_t seed = 0, uint64_t stream = 0) { init(seed, stream); }
+
+    /// \brief restart with a new seed and stream id
+    void init(uint64_t seed, uint64_t stream = 0);
+
+    /// \brief uniform 32 bit integer
+    uint32_t rand_uint32();
+    /// \brief double precision number uniformly distributed in [0,1), 53 random bits
+    double rand_uniform();
+    /// \brief integer uniformly distributed in [0, max_int-1]
+    int rand_uniform_int(int max_int);
+    /**
+     * \brief gaussian distributed number with mean 0
+     *
+     * Box-Muller, the second number of each pair is kept for the next call.
+     */
+    double rand_gaussian(double sigma);
+
+    /**
+     * \brief fill out with n uniform numbers
+     *
+     * Gives the same numbers as n calls of rand_uniform, but computes
+     * several Philox blocks at once in a loop the compiler can vectorize.
+     */
+    void fill_uniform(double *out, size_t n);
+    /// \brief fill out with n integers in [0, max_int-1]
+    void fill_uniform_int(int *out, size_t n, int max_int);
+    /**
+     * \brief fill out with n gaussian numbers with mean 0
+     *
+     * Gives the same numbers as n calls of rand_gaussian.
+     */
+    void fill_gaussian(double *out, size_t n, double sigma);
+
+    /**
+     * \brief advance the stream by n 32 bit numbers in O(1)
+     *
+     * rand_uniform consumes 2 numbers, a pair of gaussians 4.
+     * A pending second gaussian number is discarded.
+     */
+    void skip(uint64_t n);
+    /// \brief number of 32 bit numbers consumed so far
+    uint64_t position() const { return _position; }
+    /// \brief jump to an absolute position
+    void seek(uint64_t position);
+
+    uint64_t seed() const { return _seed; }
+    uint64_t stream() const { return _stream; }
+
+    /**
+     * \brief the Philox4x32-10 block function
+     * @param counter 128 bit counter, replaced by the output
+     * @param key 64 bit key
+     */
+    static void philox(uint32_t counter[4], const uint32_t key[2]);
+
+private:
+    uint64_t _seed;
+    uint64_t _stream;
+    /// position of the next number
+    uint64_t _position;
+    /// output of the current block (position / 4)
+    uint32_t _block[4];
+
+    bool _has_gaussian;
+    double _gaussian;
+
+    void GenerateBlock();
+
+    friend class RNGCheckpoint;
+};
+
+inline RandomStream::uint32_t RandomStream::rand_uint32()
+{
+    unsigned int i = _position & 3;
+    if(i == 0) GenerateBlock();
+    ++_position;
+    return _block[i];
+}
+
+inline double RandomStream::rand_uniform()
+{
+    uint32_t a = rand_uint32() >> 5;
+    uint32_t b = rand_uint32() >> 6;
+    return (a * 67108864.0 + b) * (1.0 / 9007199254740992.0);
+}
+
+inline int RandomStream::rand_uniform_int(int max_int)
+{
+    return (int)(max_int * rand_uniform());
+}
+
+}}
+
+#endif	/* _VOTCA_TOOLS_RANDOMSTREAM_H */
@@ -19,6 +19,7 @@
 #define	_RANGEPARSER_H
 
 #include <list>
+#include <vector>
 #include <string>
 #include <ostream>
 
@@ -30,6 +31,14 @@ using namespace std;
  * \brief RangeParser
  *
  * parse strings like min:step:max, not flexible enough yet to be really useful
+ *
+ * Besides iterating the blocks in the given order, the range can be queried
+ * as a set of indices (Contains, size, operator[]). For this the blocks are
+ * compiled on first use into sorted, merged runs with constant stride and a
+ * bitset for membership tests. Strided blocks are kept as runs unless they
+ * overlap, only overlapping strided blocks are enumerated and re-encoded.
+ * Compiling is done lazily, call Compile before querying one RangeParser
+ * from several threads.
  */
 class RangeParser
 {
@@ -39,6 +48,39 @@ public:
     void Parse(string range);
 
     void Add(int begin, int end, int stride=1);
+
+    /// \brief build the set representation, done automatically on first query
+    void Compile() const;
+
+    /**
+     * \brief is index k selected
+     *
+     * O(1) through the bitset if all selected indices lie within 2^27 of
+     * each other, otherwise a binary search over the merged runs.
+     */
+    bool Contains(int k) const;
+    /// \brief number of distinct selected indices, O(1)
+    size_t size() const;
+    /// \brief true if nothing is selected
+    bool empty() const { return size() == 0; }
+    /**
+     * \brief i-th selected index in ascending order
+     *
+     * Costs a binary search over the merged runs, which is constant
+     * for a single block.
+     */
+    int operator[](size_t i) const;
+
+    /**
+     * \brief split the selected indices into contiguous chunks
+     * @param n number of chunks
+     * @return n ranges with (almost) equal number of indices
+     *
+     * The chunks are in ascending order and do not overlap, chunk i holds
+     * the indices (*this)[i*size()/n] ... (*this)[(i+1)*size()/n - 1].
+     * Use this to distribute a frame selection over n workers.
+     */
+    vector<RangeParser> Split(size_t n) const;
     
 private:
     struct block_t {
@@ -81,6 +123,32 @@ private:
     int ToNumber(string str);
         
     list< block_t > _blocks;    
+
+    /// ascending run of indices begin, begin+stride, ..., end
+    struct run_t {
+        int _begin, _end, _stride;
+        /// number of indices in all runs before this one
+        size_t _offset;
+        size_t count() const { return (size_t)(((long long)_end - _begin) / _stride + 1); }
+    };
+
+    // compiled representation, see Compile
+    mutable bool _compiled;
+    mutable vector<run_t> _runs;
+    mutable size_t _size;
+    /// membership bits for [_bits_begin, _bits_begin + 64*_bits.size())
+    mutable vector<unsigned long long> _bits;
+    mutable int _bits_begin;
+
+    void Invalidate() { _compiled = false; }
+    /// find the run containing or following k
+    vector<run_t>::const_iterator FindRun(int k) const;
+    static bool RunBeginLess(const run_t &a, const run_t &b);
+    /// re-encode a group of overlapping runs ending at end into _runs
+    void EncodeOverlapping(vector<run_t>::const_iterator first,
+        vector<run_t>::const_iterator last, int end) const;
+    /// append the next ascending index to _runs
+    void AppendIndex(int k) const;
     
     //bool _has_begin, _has_end;
     //int _begin, _end;
@@ -92,6 +160,26 @@ private:
 inline void RangeParser::Add(int begin, int end, int stride)
 {
     _blocks.push_back(block_t(begin, end, stride));
+    Invalidate();
+}
+
+inline bool RangeParser::Contains(int k) const
+{
+    if(!_compiled) Compile();
+    if(!_bits.empty()) {
+        if(k < _bits_begin) return false;
+        size_t bit = (size_t)((long long)k - _bits_begin);
+        if(bit >= 64*_bits.size()) return false;
+        return (_bits[bit >> 6] >> (bit & 63)) & 1;
+    }
+    vector<run_t>::const_iterator run = FindRun(k);
+    return run != _runs.end() && k >= run->_begin && (k - run->_begin) % run->_stride == 0;
+}
+
+inline size_t RangeParser::size() const
+{
+    if(!_compiled) Compile();
+    return _size;
 }
 
 inline RangeParser::iterator RangeParser::begin()
@@ -0,0 +1,123 @@
+/*
+ * Copyright 2009-2014 The VOTCA Development Team (http://www.votca.org)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#ifndef _VOTCA_TOOLS_RNGCHECKPOINT_H
+#define	_VOTCA_TOOLS_RNGCHECKPOINT_H
+
+#include <string>
+#include <vector>
+#include <iostream>
+#include <boost/cstdint.hpp>
+
+namespace votca { namespace tools {
+
+class Random2;
+class RandomStream;
+
+/**
+ * \brief portable checkpoint of random number generator states
+ *
+ * Collects the exact states of any number of generators (the global
+ * Random, Random2 objects and RandomStream objects) in one binary blob.
+ * States are restored in the order they were stored, each record carries
+ * a type tag which is checked on restore.
+ *
+ * The format is versioned and little-endian on every machine, doubles are
+ * stored bitwise, so restoring continues the sequences exactly. Read
+ * returns the number of bytes used, the blob can therefore be part of a
+ * larger checkpoint file.
+ *
+ * \code
+ *   RNGCheckpoint cp;
+ *   cp.StoreGlobalRandom();
+ *   cp.Store(streams);
+ *   cp.Write(out);
+ *   ...
+ *   RNGCheckpoint cp;
+ *   cp.Read(in);
+ *   cp.RestoreGlobalRandom();
+ *   cp.Restore(streams);
+ * \endcode
+ */
+class RNGCheckpoint
+{
+public:
+    RNGCheckpoint() : _next(0) {}
+
+    /// \brief store the state of the static Random generator
+    void StoreGlobalRandom();
+    void Store(const Random2 &rng);
+    void Store(const RandomStream &rng);
+    /// \brief store a set of streams, e.g. one per thread
+    void Store(const std::vector<RandomStream> &streams);
+
+    /**
+     * \brief restore the next stored state
+     *
+     * Throws a runtime_error if the next record is of a different type.
+     */
+    void RestoreGlobalRandom();
+    void Restore(Random2 &rng);
+    void Restore(RandomStream &rng);
+    /// \brief restore a set of streams, the vector is resized
+    void Restore(std::vector<RandomStream> &streams);
+
+    /// \brief number of stored records
+    size_t size() const { return _records.size(); }
+    /// \brief remove all records
+    void clear() { _records.clear(); _next = 0; }
+
+    /// \brief write the binary blob
+    void Write(std::ostream &out) const;
+    /// \brief the binary blob as string
+    std::string ToString() const;
+
+    /**
+     * \brief read a blob from memory
+     * @return number of bytes read
+     */
+    size_t Read(const char *data, size_t size);
+    /// \brief read a blob from a stream, leaves the stream after the blob
+    void Read(std::istream &in);
+
+private:
+    enum record_type_t {
+        RECORD_MARSAGLIA_GLOBAL = 1,
+        RECORD_MARSAGLIA = 2,
+        RECORD_STREAM = 3,
+        RECORD_STREAM_SET = 4
+    };
+
+    struct record_t {
+        boost::uint32_t type;
+        std::string data;
+    };
+
+    std::vector<record_t> _records;
+    /// next record to restore
+    size_t _next;
+
+    std::string &Add(record_type_t type);
+    const std::string &Next(record_type_t type);
+    /// set the complete state of a stream
+    static void SetState(RandomStream &rng, boost::uint64_t seed, boost::uint64_t stream,
+            boost::uint64_t position, bool has_gaussian, double gaussian);
+};
+
+}}
+
+#endif	/* _VOTCA_TOOLS_RNGCHECKPOINT_H */
@@ -0,0 +1,79 @@
+/*
+ * Copyright 2009-2014 The VOTCA Development Team (http://www.votca.org)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#ifndef _VOTCA_TOOLS_RWLOCK_H
+#define	_VOTCA_TOOLS_RWLOCK_H
+
+#include <pthread.h>
+
+namespace votca { namespace tools {
+
+/**
+ * \brief reader-writer lock
+ *
+ * Any number of threads can hold the lock for reading at the same time,
+ * a writer has exclusive access. Use it for data which is read often and
+ * changed rarely.
+ */
+class RWLock
+{
+public:
+    RWLock() { pthread_rwlock_init(&_lock, NULL); }
+    ~RWLock() { pthread_rwlock_destroy(&_lock); }
+
+    void ReadLock() { pthread_rwlock_rdlock(&_lock); }
+    void WriteLock() { pthread_rwlock_wrlock(&_lock); }
+    void Unlock() { pthread_rwlock_unlock(&_lock); }
+
+private:
+    pthread_rwlock_t _lock;
+
+    RWLock(const RWLock &);
+    RWLock &operator=(const RWLock &);
+};
+
+/// \brief holds a RWLock for reading for the lifetime of the object
+class ScopedReadLock
+{
+public:
+    explicit ScopedReadLock(RWLock &lock) : _lock(lock) { _lock.ReadLock(); }
+    ~ScopedReadLock() { _lock.Unlock(); }
+
+private:
+    RWLock &_lock;
+
+    ScopedReadLock(const ScopedReadLock &);
+    ScopedReadLock &operator=(const ScopedReadLock &);
+};
+
+/// \brief holds a RWLock for writing for the lifetime of the object
+class ScopedWriteLock
+{
+public:
+    explicit ScopedWriteLock(RWLock &lock) : _lock(lock) { _lock.WriteLock(); }
+    ~ScopedWriteLock() { _lock.Unlock(); }
+
+private:
+    RWLock &_lock;
+
+    ScopedWriteLock(const ScopedWriteLock &);
+    ScopedWriteLock &operator=(const ScopedWriteLock &);
+};
+
+}}
+
+#endif	/* _VOTCA_TOOLS_RWLOCK_H */
@@ -0,0 +1,157 @@
+/*
+ * Copyright 2009-2014 The VOTCA Development Team (http://www.votca.org)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#ifndef __VOTCA_TOOLS_SPARSEMATRIX_H
+#define	__VOTCA_TOOLS_SPARSEMATRIX_H
+
+#include <vector>
+#include <stdexcept>
+#include <boost/numeric/ublas/matrix.hpp>
+#include <boost/numeric/ublas/vector.hpp>
+
+namespace votca { namespace tools {
+    namespace ub = boost::numeric::ublas;
+
+/**
+ * \brief sparse matrix in compressed sparse row (CSR) format
+ *
+ * Row i has the entries row_ptr()[i] to row_ptr()[i+1]-1 of col_index()
+ * and values(), sorted by column. The matrix is read-only, it is created
+ * by a SparseMatrixBuilder.
+ *
+ * Besides A*x the matrix offers trans(A)*x without forming the transpose,
+ * which is all that iterative least-squares solvers need.
+ */
+class SparseMatrix
+{
+public:
+    SparseMatrix() : _size1(0), _size2(0), _row_ptr(1, 0) {}
+
+    size_t size1() const { return _size1; }
+    size_t size2() const { return _size2; }
+    /// \brief number of stored entries
+    size_t nnz() const { return _values.size(); }
+
+    const std::vector<size_t> &row_ptr() const { return _row_ptr; }
+    const std::vector<unsigned int> &col_index() const { return _col_index; }
+    const std::vector<double> &values() const { return _values; }
+
+    /// \brief entry (i,j), zero if it is not stored
+    double operator()(size_t i, size_t j) const;
+
+    /// \brief y = A*x, x has size2(), y size1() elements
+    void prod(const double *x, double *y) const;
+    /// \brief y = trans(A)*x, x has size1(), y size2() elements
+    void trans_prod(const double *x, double *y) const;
+
+    void prod(const ub::vector<double> &x, ub::vector<double> &y) const;
+    void trans_prod(const ub::vector<double> &x, ub::vector<double> &y) const;
+
+    /// \brief squared euclidean norms of the columns
+    void ColumnNorms2(ub::vector<double> &norms) const;
+
+    /// \brief copy to a dense matrix
+    void ToDense(ub::matrix<double> &A) const;
+
+    /// \brief approximate number of bytes used
+    size_t MemoryUsage() const;
+
+private:
+    size_t _size1, _size2;
+    std::vector<size_t> _row_ptr;
+    std::vector<unsigned int> _col_index;
+    std::vector<double> _values;
+
+    friend class SparseMatrixBuilder;
+};
+
+/**
+ * \brief collects the entries of a sparse matrix in any order
+ *
+ * Entries are set with Set/Add or with M(i,j) = v and M(i,j) += v, so the
+ * builder can be passed to code written for dense matrices, e.g.
+ * CubicSpline::AddToFitMatrix. Entries given several times are combined
+ * in the order they were given: "=" replaces the previous value, "+="
+ * adds to it. Build then converts to CSR in O(nnz) time.
+ */
+class SparseMatrixBuilder
+{
+public:
+    SparseMatrixBuilder(size_t size1, size_t size2) : _size1(size1), _size2(size2) {}
+
+    /// reference to an entry for M(i,j) = v and M(i,j) += v
+    class entry_t {
+    public:
+        entry_t(SparseMatrixBuilder &builder, size_t i, size_t j)
+            : _builder(builder), _i(i), _j(j) {}
+        entry_t &operator=(double v) { _builder.Set(_i, _j, v); return *this; }
+        entry_t &operator+=(double v) { _builder.Add(_i, _j, v); return *this; }
+        entry_t &operator-=(double v) { _builder.Add(_i, _j, -v); return *this; }
+    private:
+        SparseMatrixBuilder &_builder;
+        size_t _i, _j;
+    };
+
+    entry_t operator()(size_t i, size_t j) { return entry_t(*this, i, j); }
+
+    /// \brief set entry (i,j) to v
+    void Set(size_t i, size_t j, double v) { push_back(i, j, v, true); }
+    /// \brief add v to entry (i,j)
+    void Add(size_t i, size_t j, double v) { push_back(i, j, v, false); }
+
+    size_t size1() const { return _size1; }
+    size_t size2() const { return _size2; }
+    /// \brief change the dimensions, entries out of range have to be removed by clear
+    void resize(size_t size1, size_t size2) { _size1 = size1; _size2 = size2; }
+
+    /// \brief number of collected entries, including duplicates
+    size_t entries() const { return _triplets.size(); }
+    void reserve(size_t n) { _triplets.reserve(n); }
+    void clear() { _triplets.clear(); }
+
+    /**
+     * \brief create the CSR matrix
+     *
+     * Duplicates are combined and entries which end up exactly zero are
+     * not stored.
+     */
+    void Build(SparseMatrix &A) const;
+
+private:
+    struct triplet_t {
+        unsigned int row, col;
+        double value;
+        bool assign;
+    };
+
+    size_t _size1, _size2;
+    std::vector<triplet_t> _triplets;
+
+    static bool column_less(const triplet_t &a, const triplet_t &b) { return a.col < b.col; }
+
+    void push_back(size_t i, size_t j, double v, bool assign) {
+        if(i >= _size1 || j >= _size2)
+            throw std::out_of_range("SparseMatrixBuilder: index out of range");
+        triplet_t t;
+        t.row = i; t.col = j; t.value = v; t.assign = assign;
+        _triplets.push_back(t);
+    }
+};
+
+}}
+
+#endif	/* __VOTCA_TOOLS_SPARSEMATRIX_H */
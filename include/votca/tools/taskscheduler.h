@@ -0,0 +1,244 @@
+/*
+ * Copyright 2009-2014 The VOTCA Development Team (http://www.votca.org)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#ifndef _VOTCA_TOOLS_TASKSCHEDULER_H
+#define	_VOTCA_TOOLS_TASKSCHEDULER_H
+
+#include <vector>
+#include <deque>
+#include <string>
+#include "thread.h"
+#include "mutex.h"
+#include "condition.h"
+
+namespace votca { namespace tools {
+
+class TaskGroup;
+class TaskScheduler;
+
+/**
+ * \brief unit of work for the TaskScheduler
+ *
+ * Overload Execute. Task objects are owned by the caller and must stay
+ * alive until the TaskGroup they were spawned in has been waited for.
+ */
+class Task
+{
+public:
+    Task() : _group(NULL) {}
+    virtual ~Task() {}
+
+    /// \brief the actual work, may spawn more tasks
+    virtual void Execute() = 0;
+
+private:
+    TaskGroup *_group;
+
+    friend class TaskGroup;
+    friend class TaskScheduler;
+};
+
+/**
+ * \brief task computing a value
+ *
+ * The result is available after the TaskGroup was waited for.
+ */
+template<typename T>
+class FutureTask : public Task
+{
+public:
+    void Execute() { _result = Compute(); }
+    /// \brief compute the result, overload this
+    virtual T Compute() = 0;
+    /// \brief the result
+    const T &Result() const { return _result; }
+
+private:
+    T _result;
+};
+
+/**
+ * \brief run the Run function of a Thread object as a task
+ *
+ * Helps to move code written for Thread to the scheduler: instead of
+ * Start and WaitDone, spawn a ThreadTask in a TaskGroup and wait for it.
+ */
+class ThreadTask : public Task
+{
+public:
+    explicit ThreadTask(Thread &thread) : _thread(thread) {}
+    void Execute() { _thread.Run(); }
+
+private:
+    Thread &_thread;
+};
+
+/**
+ * \brief work-stealing thread pool
+ *
+ * Every worker has its own deque of tasks. A worker takes its newest task
+ * first; if its deque is empty, it takes tasks from other threads and
+ * steals the oldest tasks from the other workers. Tasks spawned by threads
+ * outside the pool go to a shared queue. Idle workers sleep until new
+ * tasks are spawned.
+ *
+ * The workers are started once and reused, Instance() returns a pool with
+ * one worker per core which lives until the end of the program.
+ */
+class TaskScheduler
+{
+public:
+    /// \brief start a pool with nworkers threads (at least one)
+    explicit TaskScheduler(int nworkers);
+    /// \brief waits for running tasks and stops the workers
+    ~TaskScheduler();
+
+    /// \brief pool shared by the whole program
+    static TaskScheduler &Instance();
+
+    /// \brief number of worker threads
+    int NumberOfWorkers() const { return _workers.size(); }
+
+private:
+    class Worker : public Thread {
+    public:
+        Worker(TaskScheduler *scheduler, int id) : _scheduler(scheduler), _id(id) {}
+        void Run();
+
+        TaskScheduler *_scheduler;
+        int _id;
+        std::deque<Task *> _tasks;
+        Mutex _mutex;
+    };
+
+    std::vector<Worker *> _workers;
+    /// tasks spawned from outside the pool
+    std::deque<Task *> _injected;
+    Mutex _injected_mutex;
+
+    /// number of queued tasks, protected by _sleep_mutex
+    size_t _pending;
+    bool _shutdown;
+    Mutex _sleep_mutex;
+    Condition _wakeup;
+
+    void Push(Task *task);
+    /// take a task for the given worker (NULL for other threads)
+    Task *Take(Worker *self);
+    void Run(Task *task);
+    /// worker of this scheduler running in the current thread or NULL
+    Worker *CurrentWorker();
+
+    friend class TaskGroup;
+};
+
+/**
+ * \brief set of tasks which are waited for together
+ *
+ * \code
+ *   MyTask a, b;
+ *   TaskGroup group;
+ *   group.Spawn(&a);
+ *   group.Spawn(&b);
+ *   group.Wait();
+ * \endcode
+ *
+ * While waiting, the calling thread executes queued tasks itself. If a
+ * task throws, Wait throws a runtime_error with the message of the first
+ * exception once all tasks of the group have finished.
+ */
+class TaskGroup
+{
+public:
+    explicit TaskGroup(TaskScheduler &scheduler = TaskScheduler::Instance());
+    /// \brief waits for outstanding tasks, exceptions are dropped
+    ~TaskGroup();
+
+    /// \brief queue a task for execution
+    void Spawn(Task *task);
+    /// \brief wait until all spawned tasks are done
+    void Wait();
+
+private:
+    TaskScheduler &_scheduler;
+    size_t _remaining;
+    bool _failed;
+    /// message of the first exception thrown by a task
+    std::string _error;
+    Mutex _mutex;
+    Condition _done;
+
+    void Finished(bool failed, const std::string &error);
+    void WaitNoThrow();
+
+    friend class TaskScheduler;
+};
+
+namespace detail {
+
+template<typename Body>
+class ForChunk : public Task
+{
+public:
+    ForChunk(const Body &body, size_t begin, size_t end)
+        : _body(body), _begin(begin), _end(end) {}
+    void Execute() { _body(_begin, _end); }
+
+private:
+    const Body &_body;
+    size_t _begin, _end;
+};
+
+}
+
+/**
+ * \brief run body over an index range in parallel
+ * @param begin first index
+ * @param end one past the last index
+ * @param grain number of indices per task, 0 chooses a size automatically
+ * @param body function object called as body(chunk_begin, chunk_end)
+ *
+ * The range is cut into chunks of grain indices which are distributed over
+ * the workers. Returns when all chunks are done.
+ */
+template<typename Body>
+void parallel_for(size_t begin, size_t end, size_t grain, const Body &body,
+        TaskScheduler &scheduler = TaskScheduler::Instance())
+{
+    if(end <= begin) return;
+    size_t n = end - begin;
+    if(grain == 0)
+        grain = std::max<size_t>(1, n / (8 * scheduler.NumberOfWorkers()));
+    if(n <= grain) {
+        body(begin, end);
+        return;
+    }
+
+    std::vector<detail::ForChunk<Body> > chunks;
+    chunks.reserve((n + grain - 1) / grain);
+    for(size_t b = begin; b < end; b += grain)
+        chunks.push_back(detail::ForChunk<Body>(body, b, std::min(b + grain, end)));
+
+    TaskGroup group(scheduler);
+    for(size_t i = 0; i < chunks.size(); ++i)
+        group.Spawn(&chunks[i]);
+    group.Wait();
+}
+
+}}
+
+#endif	/* _VOTCA_TOOLS_TASKSCHEDULER_H */
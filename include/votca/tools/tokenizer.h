@@ -20,24 +20,55 @@
 
 #include <string>
 #include <vector>
-#include <boost/tokenizer.hpp>
+#include <iterator>
+#include <cstddef>
+#include <typeinfo>
 #include <boost/lexical_cast.hpp>
+#include <boost/utility/string_ref.hpp>
 
 namespace votca { namespace tools {
 
+/**
+ * \brief convert a token to a number without creating a string
+ * @param tok characters to convert
+ * @param v converted value
+ * @return false if tok is not a valid number of that type
+ *
+ * Accepts the same input as boost::lexical_cast (no surrounding spaces).
+ */
+bool parse_token(const boost::string_ref &tok, double &v);
+bool parse_token(const boost::string_ref &tok, float &v);
+bool parse_token(const boost::string_ref &tok, int &v);
+bool parse_token(const boost::string_ref &tok, unsigned int &v);
+bool parse_token(const boost::string_ref &tok, long &v);
+
+/// \brief generic version of parse_token using boost::lexical_cast
+template<typename T>
+inline bool parse_token(const boost::string_ref &tok, T &v)
+{
+    try {
+        v = boost::lexical_cast<T>(tok.data(), tok.size());
+    }
+    catch(boost::bad_lexical_cast &err) {
+        return false;
+    }
+    return true;
+}
 
 /**
  * \brief break string into words
  *
- * This class wraps boost::tokenizer to break a string into words. A list of
- * delimeters can be freely choosen.
+ * This class breaks a string into words. A list of delimeters can be freely
+ * choosen, empty words are skipped.
+ *
+ * The words are available as strings (iterator, ToVector) or as views into
+ * the internal copy of the string (view_iterator, ToVector of string_ref),
+ * which avoids creating one string per word. Delimiters are looked up in a
+ * table, so scanning costs the same for any number of delimiters.
  */
 class Tokenizer 
 {                        
 public:
-    typedef boost::tokenizer<boost::char_separator<char> >::iterator
-        iterator;
-    
     /**
      * \brief startup tokenization
      * @param str string to break up
@@ -46,29 +77,86 @@ public:
      * After initialization,the words can be accessed using the iterator
      * interface or directly transferred to a vector ToVector of ConvertToVector.
      */
-    Tokenizer(const std::string &str, const char *separators) {
-        _str = str;
-        boost::char_separator<char> sep(separators);
-        tok = new boost::tokenizer<boost::char_separator<char> >(_str, sep);
-        //boost::escaped_list_separator<char> sep(" ", separators, "\"");
-        //tok = new boost::tokenizer<boost::escaped_list_separator<char> >(str, sep);
-        
-    }
-    
-    ~Tokenizer() {
-        delete tok;
+    Tokenizer(const std::string &str, const char *separators)
+        : _str(str) {
+        SetSeparators(separators);
     }
+
+    /// iterator over the words as views into the tokenizer
+    class view_iterator {
+    public:
+        typedef std::forward_iterator_tag iterator_category;
+        typedef boost::string_ref value_type;
+        typedef std::ptrdiff_t difference_type;
+        typedef const boost::string_ref *pointer;
+        typedef const boost::string_ref &reference;
+
+        view_iterator() : _tok(NULL), _begin(0), _end(0) {}
+        view_iterator(const Tokenizer *tok, size_t pos) : _tok(tok) { Find(pos); }
+
+        const boost::string_ref &operator*() const { return _word; }
+        const boost::string_ref *operator->() const { return &_word; }
+        view_iterator &operator++() { Find(_end); return *this; }
+        view_iterator operator++(int) { view_iterator i(*this); Find(_end); return i; }
+        bool operator==(const view_iterator &i) const { return _begin == i._begin; }
+        bool operator!=(const view_iterator &i) const { return _begin != i._begin; }
+
+    private:
+        const Tokenizer *_tok;
+        size_t _begin, _end;
+        boost::string_ref _word;
+
+        void Find(size_t pos) {
+            _begin = _tok->WordBegin(pos);
+            _end = _tok->WordEnd(_begin);
+            _word = boost::string_ref(_tok->_str.data() + _begin, _end - _begin);
+        }
+    };
+
+    /// iterator over the words as strings
+    class iterator {
+    public:
+        typedef std::forward_iterator_tag iterator_category;
+        typedef std::string value_type;
+        typedef std::ptrdiff_t difference_type;
+        typedef const std::string *pointer;
+        typedef const std::string &reference;
+
+        iterator() {}
+        explicit iterator(const view_iterator &iter) : _iter(iter) { Update(); }
+
+        const std::string &operator*() const { return _word; }
+        const std::string *operator->() const { return &_word; }
+        iterator &operator++() { ++_iter; Update(); return *this; }
+        iterator operator++(int) { iterator i(*this); ++(*this); return i; }
+        bool operator==(const iterator &i) const { return _iter == i._iter; }
+        bool operator!=(const iterator &i) const { return _iter != i._iter; }
+
+    private:
+        view_iterator _iter;
+        std::string _word;
+
+        void Update() { _word.assign(_iter->data(), _iter->size()); }
+    };
     
     /**
      * \brief iterator to first element
      * @return begin iterator
      */
-    iterator begin() { return tok->begin(); }
+    iterator begin() const { return iterator(vbegin()); }
     /**
      * \brief end iterator
      * @return end iterator
      */
-    iterator end() { return tok->end(); }
+    iterator end() const { return iterator(vend()); }
+
+    /// \brief view iterator to first element
+    view_iterator vbegin() const { return view_iterator(this, 0); }
+    /// \brief view end iterator
+    view_iterator vend() const { return view_iterator(this, _str.size()); }
+
+    /// \brief number of words
+    size_t size() const;
     
     /**
      * \brief store all words in a vector of strings.
@@ -76,8 +164,19 @@ public:
      *
      * This class appends all words to a vector of strings.
      */
-    void ToVector(std::vector<std::string> &v) {
-        for(iterator iter=begin(); iter!=end(); ++iter)
+    void ToVector(std::vector<std::string> &v) const {
+        for(view_iterator iter=vbegin(); iter!=vend(); ++iter)
+            v.push_back(std::string(iter->data(), iter->size()));
+    }
+
+    /**
+     * \brief store views of all words in a vector
+     * @param v storage vector
+     *
+     * The views point into the tokenizer and are only valid as long as it exists.
+     */
+    void ToVector(std::vector<boost::string_ref> &v) const {
+        for(view_iterator iter=vbegin(); iter!=vend(); ++iter)
             v.push_back(*iter);
     }
 
@@ -85,23 +184,41 @@ public:
      * \brief store all words in a vector with type conversion.
      * @param v storage vector
      *
-     * This class appends all words to a vector of arbitrary type (e.g. double)
-     * and also does type conversion.
+     * This class fills a vector of arbitrary type (e.g. double) with the
+     * converted words. Throws boost::bad_lexical_cast if a word cannot be
+     * converted.
      */
     template < typename T >
-    void ConvertToVector(std::vector<T> &v){
-        std::vector<std::string> tmp;
-        ToVector(tmp);
-        v.resize(tmp.size());
+    void ConvertToVector(std::vector<T> &v) const {
+        v.resize(size());
         typename std::vector<T>::iterator viter = v.begin();
-        typename std::vector<std::string>::iterator iter;
-        for(iter = tmp.begin(); iter!=tmp.end(); ++iter, ++viter)
-            *viter = boost::lexical_cast<T, std::string>(*iter);
+        for(view_iterator iter=vbegin(); iter!=vend(); ++iter, ++viter)
+            if(!parse_token(*iter, *viter))
+                throw boost::bad_lexical_cast(typeid(std::string), typeid(T));
     }
     
 private:
-    boost::tokenizer< boost::char_separator<char> > *tok;
     std::string _str;
+    /// lookup table of separators, indexed by unsigned char
+    bool _separator[256];
+
+    void SetSeparators(const char *separators);
+
+    /// begin of the next word at or after pos, size of the string if there is none
+    size_t WordBegin(size_t pos) const {
+        const size_t n = _str.size();
+        const char *s = _str.data();
+        while(pos < n && _separator[(unsigned char)s[pos]]) ++pos;
+        return pos;
+    }
+
+    /// end of the word starting at pos
+    size_t WordEnd(size_t pos) const {
+        const size_t n = _str.size();
+        const char *s = _str.data();
+        while(pos < n && !_separator[(unsigned char)s[pos]]) ++pos;
+        return pos;
+    }
 };
 
 
@@ -110,4 +227,3 @@ int wildcmp(const char *wild, const char *string);
 }}
 
 #endif	/* _tools_H */
-
@@ -27,6 +27,8 @@
 
 namespace votca { namespace tools {
 using namespace std;
+
+template<typename T> class matrix_t;
 /**
     \brief Vector class for a 3 component vector
 
@@ -35,44 +37,53 @@ using namespace std;
     you can access the elements with the functions x(), y(), z(), both reading and writing is possible;
     x + v.x();
     v.x() = 5.;
+
+    The class is a template on the scalar type, use vec (double) or vecf
+    (float, e.g. for trajectories stored in single precision).
 */
 
-class vec {
+template<typename T>
+class vec_t {
 public:
+    typedef T scalar_t;
     
-    vec();
-    vec(const vec &v);
-    vec(const double r[3]);
-    vec(const double &x, const double &y, const double &z);
-    vec(const boost::numeric::ublas::vector<double> &v);
-    vec(const string &str);
+    vec_t();
+    vec_t(const vec_t &v);
+    vec_t(const T r[3]);
+    vec_t(const T &x, const T &y, const T &z);
+    vec_t(const boost::numeric::ublas::vector<T> &v);
+    vec_t(const string &str);
+    /// \brief conversion between precisions
+    template<typename U>
+    explicit vec_t(const vec_t<U> &v)
+        : _x(v.getX()), _y(v.getY()), _z(v.getZ()) {}
     
     
-    vec &operator=(const vec &v);
-    vec &operator+=(const vec &v);
-    vec &operator-=(const vec &v);
-    vec &operator*=(const double &d);
-    vec &operator/=(const double &d);
+    vec_t &operator=(const vec_t &v);
+    vec_t &operator+=(const vec_t &v);
+    vec_t &operator-=(const vec_t &v);
+    vec_t &operator*=(const T &d);
+    vec_t &operator/=(const T &d);
     
     /**
      * \brief get full access to x element
      * @return reference to x
      */
-    double &x() { return _x; }
+    T &x() { return _x; }
     /**
      * \brief get full access to y element
      * @return reference to y
      */
-    double &y() { return _y; }
+    T &y() { return _y; }
     /**
      * \brief get full access to z element
      * @return reference to z
      */
-    double &z() { return _z; }
+    T &z() { return _z; }
     
-    void setX(const double &x) { _x = x; }
-    void setY(const double &y) { _y = y; }
-    void setZ(const double &z) { _z = z; }
+    void setX(const T &x) { _x = x; }
+    void setY(const T &y) { _y = y; }
+    void setZ(const T &z) { _z = z; }
     
     /**
      * \brief read only access to x element
@@ -81,7 +92,7 @@ public:
      * This function can be usefule when const is used to allow for better
      * optimization. Always use getX() instead of x() if possible.
      */
-    const double &getX() const { return _x; }
+    const T &getX() const { return _x; }
     /**
      * \brief read only access to y element
      * @return x const reference to y
@@ -89,7 +100,7 @@ public:
      * This function can be usefule when const is used to allow for better
      * optimization. Always use getY() instead of y() if possible.
      */
-    const double &getY() const { return _y; }
+    const T &getY() const { return _y; }
     /**
      * \brief read only access to z element
      * @return x const reference to z
@@ -97,7 +108,7 @@ public:
      * This function can be usefule when const is used to allow for better
      * optimization. Always use getZ() instead of Z() if possible.
      */
-    const double &getZ() const { return _z; }
+    const T &getZ() const { return _z; }
     
     /**
      * \brief normalize the vector
@@ -105,26 +116,110 @@ public:
      * This function normalizes the vector and returns itself after normalization.
      * After this call, the vector stores the normalized value.
      */
-    vec &normalize();
+    vec_t &normalize();
     
-    boost::numeric::ublas::vector<double> converttoub();
+    boost::numeric::ublas::vector<T> converttoub();
     
     template<class Archive>
     void serialize(Archive &arch, const unsigned int version) { arch & _x; arch & _y; arch & _z; }
     
+    /*
+     * The arithmetic operators are friends defined in the class. They are
+     * found through the vec_t argument and are no templates themselves, so
+     * implicit conversions (e.g. from ub::vector) work on both operands.
+     */
+    friend bool operator==(const vec_t &v1, const vec_t &v2)
+    {
+        return ((v1.getX()==v2.getX()) && (v1.getY()==v2.getY()) && (v1.getZ()==v2.getZ()));
+    }
+
+    friend bool operator!=(const vec_t &v1, const vec_t &v2)
+    {
+        return ((v1.getX()!=v2.getX()) || (v1.getY()!=v2.getY()) || (v1.getZ()==v2.getZ()));
+    }
+
+    friend vec_t operator+(const vec_t &v1, const vec_t &v2)
+    {
+        return (vec_t(v1)+=v2);
+    }
+
+    friend vec_t operator-(const vec_t &v1, const vec_t &v2)
+    {
+        return (vec_t(v1)-=v2);
+    }
+
+    friend vec_t operator-(const vec_t &v1)
+    {
+        return vec_t(-v1.getX(), -v1.getY(), -v1.getZ());
+    }
+
+    friend vec_t operator*(const vec_t &v1, const T &d)
+    {
+        return (vec_t(v1)*=d);
+    }
+
+    friend vec_t operator*(const T &d, const vec_t &v1)
+    {
+        return (vec_t(v1)*=d);
+    }
+
+    friend vec_t operator/(const vec_t &v1, const T &d)
+    {
+        return (vec_t(v1)/=d);
+    }
+
+    /// dot product
+    friend T operator*(const vec_t &v1, const vec_t &v2)
+    {
+        return v1.getX()*v2.getX() + v1.getY()*v2.getY() + v1.getZ()*v2.getZ();
+    }
+
+    /// cross product
+    friend vec_t operator^(const vec_t &v1, const vec_t &v2)
+    {
+        return vec_t(
+            v1.getY()*v2.getZ() - v1.getZ()*v2.getY(),
+            v1.getZ()*v2.getX() - v1.getX()*v2.getZ(),
+            v1.getX()*v2.getY() - v1.getY()*v2.getX()
+        );
+    }
+
+    /// outer product, needs matrix.h
+    friend matrix_t<T> operator|(const vec_t &a, const vec_t &b)
+    {
+        matrix_t<T> res;
+        res.set(0,0, a.getX() * b.getX());
+        res.set(0,1, a.getX() * b.getY());
+        res.set(0,2, a.getX() * b.getZ());
+        res.set(1,0, a.getY() * b.getX());
+        res.set(1,1, a.getY() * b.getY());
+        res.set(1,2, a.getY() * b.getZ());
+        res.set(2,0, a.getZ() * b.getX());
+        res.set(2,1, a.getZ() * b.getY());
+        res.set(2,2, a.getZ() * b.getZ());
+        return res;
+    }
+
     private:
-        double _x, _y, _z;
+        T _x, _y, _z;
 };
 
-inline vec::vec() {}
+typedef vec_t<double> vec;
+typedef vec_t<float> vecf;
 
-inline vec::vec(const vec &v)
+template<typename T>
+inline vec_t<T>::vec_t() {}
+
+template<typename T>
+inline vec_t<T>::vec_t(const vec_t &v)
     : _x(v._x), _y(v._y), _z(v._z) {}
         
-inline vec::vec(const double r[3])
+template<typename T>
+inline vec_t<T>::vec_t(const T r[3])
     : _x(r[0]), _y(r[1]), _z(r[2]) {}
 
-inline vec::vec(const boost::numeric::ublas::vector<double> &v)
+template<typename T>
+inline vec_t<T>::vec_t(const boost::numeric::ublas::vector<T> &v)
     {try
     {_x=v(0);
      _y=v(1);
@@ -133,106 +228,72 @@ inline vec::vec(const boost::numeric::ublas::vector<double> &v)
     catch(std::exception &err){throw std::length_error("Conversion from ub::vector to votca-vec failed");} 
 }
 
-inline vec::vec(const string &str)
+template<typename T>
+inline vec_t<T>::vec_t(const string &str)
 {
     // usage: vec(" 1  2.5  17 "); separator = spaces
     Tokenizer tok(str, " ");
-    vector< string > values;
-    tok.ToVector(values);
-    if (values.size()!=3)
-    {
-        throw std::runtime_error("\n\n\t error, string to vec, size!=3\n\n");
+    Tokenizer::view_iterator iter = tok.vbegin();
+    T *values[3] = { &_x, &_y, &_z };
+    int n = 0;
+    for(; iter != tok.vend() && n < 3; ++iter, ++n) {
+        if (!parse_token(*iter, *values[n]))
+            throw std::runtime_error("\n\n\t error, string to vec, can't convert string to double\n\n");
     }
-    try {
-        _x = boost::lexical_cast<double>(values[0]);
-        _y = boost::lexical_cast<double>(values[1]);
-        _z = boost::lexical_cast<double>(values[2]);
-    }
-    catch(const boost::bad_lexical_cast& e)
+    if (n != 3 || iter != tok.vend())
     {
-        throw std::runtime_error("\n\n\t error, string to vec, can't convert string to double\n\n");
+        throw std::runtime_error("\n\n\t error, string to vec, size!=3\n\n");
     }
 }
 
-inline vec::vec(const double &x, const double &y, const double &z)
+template<typename T>
+inline vec_t<T>::vec_t(const T &x, const T &y, const T &z)
         : _x(x), _y(y), _z(z) {}
     
-inline bool operator==(const vec &v1, const vec &v2)
-{
-    return ((v1.getX()==v2.getX()) && (v1.getY()==v2.getY()) && (v1.getZ()==v2.getZ()));
-}
-
-inline bool operator!=(const vec &v1, const vec &v2)
-{
-    return ((v1.getX()!=v2.getX()) || (v1.getY()!=v2.getY()) || (v1.getZ()==v2.getZ()));
-}
-
-inline vec &vec::operator=(const vec &v)
+template<typename T>
+inline vec_t<T> &vec_t<T>::operator=(const vec_t &v)
 { 
         _x=v._x; _y=v._y; _z=v._z;
         return *this;
 }    
 
-inline vec &vec::operator+=(const vec &v)
+template<typename T>
+inline vec_t<T> &vec_t<T>::operator+=(const vec_t &v)
 { 
         _x+=v._x; _y+=v._y; _z+=v._z;
         return *this;
 }    
         
-inline vec &vec::operator-=(const vec &v)
+template<typename T>
+inline vec_t<T> &vec_t<T>::operator-=(const vec_t &v)
 { 
         _x-=v._x; _y-=v._y; _z-=v._z;
         return *this;
 }    
 
-inline vec &vec::operator*=(const double &d)
+template<typename T>
+inline vec_t<T> &vec_t<T>::operator*=(const T &d)
 { 
         _x*=d; _y*=d; _z*=d;
         return *this;
 }    
 
-inline vec &vec::operator/=(const double &d)
+template<typename T>
+inline vec_t<T> &vec_t<T>::operator/=(const T &d)
 { 
         _x/=d; _y/=d; _z/=d;
         return *this;
 }    
 
-inline vec operator+(const vec &v1, const vec &v2)
-{
-    return (vec(v1)+=v2);
-}
-
-inline vec operator-(const vec &v1, const vec &v2)
-{
-    return (vec(v1)-=v2);
-}
-
-inline vec operator-(const vec &v1){
-    return vec (-v1.getX(), -v1.getY(), -v1.getZ());
-}
-
-inline vec operator*(const vec &v1, const double &d)
-{
-    return (vec(v1)*=d);
-}
-
-inline vec operator*(const double &d, const vec &v1)
-{
-    return (vec(v1)*=d);
-}
-
-inline vec operator/(const vec &v1, const double &d)
-{
-    return (vec(v1)/=d);
-}
-
-inline std::ostream &operator<<(std::ostream &out, const vec& v)
+template<typename T>
+inline std::ostream &operator<<(std::ostream &out, const vec_t<T>& v)
 {
       out << '[' << v.getX() << ", " << v.getY() << ", " << v.getZ() << ']';
       return out;
 }
 
-inline std::istream &operator>>(std::istream &in, vec& v)
+template<typename T>
+inline std::istream &operator>>(std::istream &in, vec_t<T>& v)
 {
     char c;
     in.get(c);
@@ -245,7 +306,7 @@ inline std::istream &operator>>(std::istream &in, vec& v)
         in.get(c);
         if(c==']') { // found end of vector
             Tokenizer tok(str, ",");
-            vector<double> d;
+            vector<T> d;
             tok.ConvertToVector(d);
             if(d.size() != 3)
                 throw std::runtime_error("error, invalid number of entries in vector");
@@ -261,28 +322,14 @@ inline std::istream &operator>>(std::istream &in, vec& v)
     return in;
 }
     
-/// dot product
-inline double operator*(const vec &v1, const vec &v2)
-{
-    return v1.getX()*v2.getX() + v1.getY()*v2.getY() + v1.getZ()*v2.getZ();
-}
-
-/// cross product
-inline vec operator^(const vec &v1, const vec &v2)
-{
-    return vec(
-        v1.getY()*v2.getZ() - v1.getZ()*v2.getY(),
-        v1.getZ()*v2.getX() - v1.getX()*v2.getZ(),
-        v1.getX()*v2.getY() - v1.getY()*v2.getX()
-    );
-}
-
-inline double abs(const vec &v)
+template<typename T>
+inline T abs(const vec_t<T> &v)
 {
     return sqrt(v*v);
 }
 
-inline double maxnorm(const vec &v) {
+template<typename T>
+inline T maxnorm(const vec_t<T> &v) {
     return ( std::abs(v.getX()) > std::abs(v.getY()) ) ?
          ( ( std::abs(v.getX()) > std::abs(v.getZ()) ) ? 
              std::abs(v.getX()) : std::abs(v.getZ()) )
@@ -290,15 +337,17 @@ inline double maxnorm(const vec &v) {
              std::abs(v.getY()) : std::abs(v.getZ()) );
 }
 
-inline vec &vec::normalize()
+template<typename T>
+inline vec_t<T> &vec_t<T>::normalize()
 { 
-    return ((*this)*=1./abs(*this));
+    return ((*this)*=T(1)/abs(*this));
 }
 
 
 
-inline boost::numeric::ublas::vector<double> vec::converttoub() {
-    boost::numeric::ublas::vector<double> temp=boost::numeric::ublas::zero_vector<double>(3);
+template<typename T>
+inline boost::numeric::ublas::vector<T> vec_t<T>::converttoub() {
+    boost::numeric::ublas::vector<T> temp=boost::numeric::ublas::zero_vector<T>(3);
     temp(0)=_x;
     temp(1)=_y;
     temp(2)=_z;
@@ -308,4 +357,3 @@ inline boost::numeric::ublas::vector<double> vec::converttoub() {
 }
 }}
 #endif	/* _vec_H */
-
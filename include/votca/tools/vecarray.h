@@ -0,0 +1,153 @@
+/*
+ * Copyright 2009-2014 The VOTCA Development Team (http://www.votca.org)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#ifndef _VOTCA_TOOLS_VECARRAY_H
+#define	_VOTCA_TOOLS_VECARRAY_H
+
+#include <vector>
+#include "vec.h"
+
+namespace votca { namespace tools {
+
+/**
+ * \brief array of 3 component vectors in structure of arrays layout
+ *
+ * The x, y and z components are stored in three separate, 64 byte aligned
+ * arrays. Loops over the components can then be vectorized by the compiler
+ * (SSE/AVX), which is not possible for a vector<vec>. Use the kernels
+ * below (dot, abs, cross, axpy, distances, center_of_mass) for geometry
+ * over many particles and convert from and to vector<vec> at the borders.
+ *
+ * VecArray stores doubles, VecArrayf floats. The float version moves half
+ * the bytes and fits twice as many elements into a SIMD register.
+ */
+template<typename T>
+class VecArray_t
+{
+public:
+    typedef T scalar_t;
+
+    VecArray_t();
+    explicit VecArray_t(size_t n);
+    template<typename U>
+    explicit VecArray_t(const std::vector< vec_t<U> > &v);
+    VecArray_t(const VecArray_t &a);
+    ~VecArray_t();
+
+    VecArray_t &operator=(const VecArray_t &a);
+
+    /// \brief number of vectors
+    size_t size() const { return _size; }
+    /// \brief change the number of vectors, new elements are uninitialized
+    void resize(size_t n);
+    /// \brief reserve memory for n vectors
+    void reserve(size_t n);
+    void clear() { _size = 0; }
+
+    /// \brief component arrays, aligned to 64 bytes
+    T *x() { return _c[0]; }
+    T *y() { return _c[1]; }
+    T *z() { return _c[2]; }
+    const T *x() const { return _c[0]; }
+    const T *y() const { return _c[1]; }
+    const T *z() const { return _c[2]; }
+
+    /// \brief copy of the i-th vector
+    vec_t<T> operator[](size_t i) const { return vec_t<T>(_c[0][i], _c[1][i], _c[2][i]); }
+    /// \brief set the i-th vector
+    void set(size_t i, const vec_t<T> &v) { _c[0][i] = v.getX(); _c[1][i] = v.getY(); _c[2][i] = v.getZ(); }
+    void push_back(const vec_t<T> &v);
+
+    /// \brief replace content by a copy of v, converts the precision if needed
+    template<typename U>
+    void FromVector(const std::vector< vec_t<U> > &v);
+    /// \brief copy content to v, v is resized
+    template<typename U>
+    void ToVector(std::vector< vec_t<U> > &v) const;
+
+private:
+    /// x, y and z arrays, all in one block owned by _c[0]
+    T *_c[3];
+    size_t _size;
+    size_t _capacity;
+};
+
+typedef VecArray_t<double> VecArray;
+typedef VecArray_t<float> VecArrayf;
+
+/// \brief out[i] = a[i]*b[i]
+template<typename T>
+void dot(const VecArray_t<T> &a, const VecArray_t<T> &b, T *out);
+/// \brief out[i] = |a[i]|
+template<typename T>
+void abs(const VecArray_t<T> &a, T *out);
+/// \brief out[i] = a[i]^b[i], out is resized and may be the same array as a or b
+template<typename T>
+void cross(const VecArray_t<T> &a, const VecArray_t<T> &b, VecArray_t<T> &out);
+/// \brief y[i] += alpha*x[i]
+template<typename T>
+void axpy(typename VecArray_t<T>::scalar_t alpha, const VecArray_t<T> &x, VecArray_t<T> &y);
+/// \brief out[i] = |a[i]-b[i]|
+template<typename T>
+void distances(const VecArray_t<T> &a, const VecArray_t<T> &b, T *out);
+/// \brief out[i] = |a[i]-p|
+template<typename T>
+void distances(const VecArray_t<T> &a, const vec_t<T> &p, T *out);
+/**
+ * \brief weighted center of the vectors
+ * @param a positions
+ * @param masses weights or NULL for the geometric center
+ *
+ * The sums are done in double precision for both types.
+ */
+template<typename T>
+vec_t<T> center_of_mass(const VecArray_t<T> &a,
+        const typename VecArray_t<T>::scalar_t *masses = NULL);
+
+template<typename T>
+template<typename U>
+inline VecArray_t<T>::VecArray_t(const std::vector< vec_t<U> > &v)
+    : _size(0), _capacity(0)
+{
+    _c[0] = _c[1] = _c[2] = NULL;
+    FromVector(v);
+}
+
+template<typename T>
+template<typename U>
+inline void VecArray_t<T>::FromVector(const std::vector< vec_t<U> > &v)
+{
+    resize(v.size());
+    for(size_t i = 0; i < v.size(); ++i) {
+        _c[0][i] = v[i].getX();
+        _c[1][i] = v[i].getY();
+        _c[2][i] = v[i].getZ();
+    }
+}
+
+template<typename T>
+template<typename U>
+inline void VecArray_t<T>::ToVector(std::vector< vec_t<U> > &v) const
+{
+    v.resize(_size);
+    for(size_t i = 0; i < _size; ++i)
+        v[i] = vec_t<U>(_c[0][i], _c[1][i], _c[2][i]);
+}
+
+}}
+
+#endif	/* _VOTCA_TOOLS_VECARRAY_H */
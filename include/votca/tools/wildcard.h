@@ -0,0 +1,122 @@
+/*
+ * Copyright 2009-2014 The VOTCA Development Team (http://www.votca.org)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#ifndef _VOTCA_TOOLS_WILDCARD_H
+#define	_VOTCA_TOOLS_WILDCARD_H
+
+#include <string>
+#include <vector>
+#include <string.h>
+
+namespace votca { namespace tools {
+
+/**
+ * \brief precompiled wildcard pattern
+ *
+ * Matches the same strings as wildcmp: "*" matches any sequence, "?" any
+ * single character. The pattern is split at "*" once into segments, so
+ * matching only compares the literal prefix and suffix and searches the
+ * segments in between. Patterns without wildcards are compared by length
+ * and memcmp.
+ *
+ * Compile a pattern once and use it for all candidates, e.g.
+ * \code
+ *   WildcardPattern pattern("bond*");
+ *   for(...)
+ *       if(pattern.Match(name)) ...
+ * \endcode
+ */
+class WildcardPattern
+{
+public:
+    WildcardPattern() { Compile(""); }
+    explicit WildcardPattern(const std::string &pattern) { Compile(pattern); }
+
+    /// \brief set a new pattern
+    void Compile(const std::string &pattern);
+
+    /// \brief does the string match the pattern
+    bool Match(const char *str, size_t len) const;
+    bool Match(const std::string &str) const { return Match(str.data(), str.size()); }
+    bool Match(const char *str) const { return Match(str, strlen(str)); }
+
+    /// \brief true if the pattern contains no wildcards
+    bool IsLiteral() const { return _literal; }
+    /// \brief the pattern as given
+    const std::string &pattern() const { return _pattern; }
+
+private:
+    struct segment_t {
+        size_t begin;
+        size_t length;
+        /// segment contains '?'
+        bool any;
+    };
+
+    std::string _pattern;
+    bool _literal;
+    /// pattern contains at least one '*'
+    bool _star;
+    /// segments between the '*', first is the prefix, last the suffix
+    std::vector<segment_t> _segments;
+    /// minimal length of a matching string
+    size_t _min_length;
+
+    bool Equals(const segment_t &seg, const char *str) const;
+};
+
+inline bool WildcardPattern::Equals(const segment_t &seg, const char *str) const
+{
+    const char *p = _pattern.data() + seg.begin;
+    if(!seg.any)
+        return memcmp(p, str, seg.length) == 0;
+    for(size_t i = 0; i < seg.length; ++i)
+        if(p[i] != str[i] && p[i] != '?')
+            return false;
+    return true;
+}
+
+inline bool WildcardPattern::Match(const char *str, size_t len) const
+{
+    if(len < _min_length)
+        return false;
+    const segment_t &prefix = _segments.front();
+    if(!_star)
+        return len == prefix.length && Equals(prefix, str);
+
+    const segment_t &suffix = _segments.back();
+    if(!Equals(prefix, str) || !Equals(suffix, str + len - suffix.length))
+        return false;
+
+    // the segments in between are searched left to right, taking the
+    // first occurrence of each is always optimal
+    size_t pos = prefix.length;
+    size_t end = len - suffix.length;
+    for(size_t s = 1; s + 1 < _segments.size(); ++s) {
+        const segment_t &seg = _segments[s];
+        while(pos + seg.length <= end && !Equals(seg, str + pos))
+            ++pos;
+        if(pos + seg.length > end)
+            return false;
+        pos += seg.length;
+    }
+    return true;
+}
+
+}}
+
+#endif	/* _VOTCA_TOOLS_WILDCARD_H */
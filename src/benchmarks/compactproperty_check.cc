@@ -0,0 +1,141 @@
+/*
+ * Copyright 2009-2014 The VOTCA Development Team (http://www.votca.org)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <stdio.h>
+#include <fstream>
+#include <string>
+#include <list>
+#include <stdexcept>
+#include <boost/filesystem.hpp>
+#include <votca/tools/property.h>
+#include <votca/tools/compactproperty.h>
+
+using namespace votca::tools;
+
+/*
+ * Checks of CompactProperty, run by ctest.
+ *
+ * usage: compactproperty_check
+ *
+ * build:  a tree built from a Property has the same names, values, paths,
+ *         attributes and child order
+ * xml:    load_compact_property_from_xml gives the same tree
+ * back:   ToProperty restores the original Property
+ * access: get, exists, Select and as agree with Property
+ */
+
+static int failures = 0;
+
+static void check(bool ok, const char *what)
+{
+    if(ok) return;
+    printf("FAILED: %s\n", what);
+    ++failures;
+}
+
+/// true if the subtrees of p and v are identical, without paths the name
+/// of the root and all paths are ignored
+static bool same(Property &p, const PropertyView &v, bool paths = true)
+{
+    if(paths && (p.name() != v.name() || p.path() != v.path()))
+        return false;
+    if(p.value() != v.value())
+        return false;
+    if(p.size() != v.size() || p.hasAttributes() != v.hasAttributes())
+        return false;
+    for(Property::AttributeIterator a = p.firstAttribute(); a != p.lastAttribute(); ++a)
+        if(!v.hasAttribute(a->first) || v.getAttribute<std::string>(a->first) != a->second)
+            return false;
+    PropertyView::iterator c = v.begin();
+    for(Property::iterator i = p.begin(); i != p.end(); ++i, ++c)
+        if(!same(*i, *c, paths) || (!paths && i->name() != (*c).name()))
+            return false;
+    return true;
+}
+
+int main()
+{
+    const std::string doc =
+        "<options>\n"
+        "  <cg kind=\"bonded\" n=\"3\">\n"
+        "    <item>1.5</item>\n"
+        "    <item id=\"x\">2</item>\n"
+        "    <item>  spaced value  </item>\n"
+        "    <name>A</name>\n"
+        "  </cg>\n"
+        "  <empty/>\n"
+        "  <deep><a><b><c>42</c></b></a></deep>\n"
+        "  <item>top</item>\n"
+        "</options>\n";
+
+    Property p;
+    load_property_from_xml_string(p, doc);
+
+    // build
+    CompactProperty c(p);
+    check(same(p, c.root()), "tree built from Property matches");
+
+    // xml
+    namespace fs = boost::filesystem;
+    fs::path file = fs::temp_directory_path() / fs::unique_path("compactproperty_check-%%%%%%%%.xml");
+    {
+        std::ofstream out(file.string().c_str());
+        out << doc;
+    }
+    CompactProperty x;
+    load_compact_property_from_xml(x, file.string());
+    fs::remove(file);
+    check(same(p, x.root()), "tree loaded from XML matches");
+    check(x.size() == c.size(), "same number of nodes");
+
+    // back
+    Property q;
+    c.root().ToProperty(q);
+    check(same(q, c.root()), "ToProperty restores the tree");
+    CompactProperty c2(q);
+    check(same(p, c2.root()), "Property -> compact -> Property -> compact round trip");
+    Property sub;
+    c.get("options.cg").ToProperty(sub);
+    // the copy of a subtree is rooted at sub, so paths start there
+    check(same(sub, c.get("options.cg"), false), "ToProperty of a subtree");
+
+    // access
+    check(c.get("options.deep.a.b.c").as<int>() == 42, "get and as<int>");
+    check(c.get("options.cg.item").value() == p.get("options.cg.item").value(),
+            "get picks the same of several matches as Property");
+    check(c.get("options.cg").getAttribute<int>("n") == 3, "getAttribute<int>");
+    check(c.root().exists("options.cg.name") && !c.root().exists("options.cg.missing"), "exists");
+    bool thrown = false;
+    try { c.get("options.missing"); }
+    catch(std::runtime_error &) { thrown = true; }
+    check(thrown, "get of a missing key throws");
+
+    const char *filters[] = { "options.cg.item", "options.*.item", "options.cg.*", "options.?eep.a", "*" };
+    for(int i = 0; i < 5; ++i) {
+        std::list<Property *> ps = p.Select(filters[i]);
+        std::list<PropertyView> vs = c.Select(filters[i]);
+        bool ok = ps.size() == vs.size();
+        std::list<PropertyView>::iterator v = vs.begin();
+        for(std::list<Property *>::iterator it = ps.begin(); ok && it != ps.end(); ++it, ++v)
+            ok = same(**it, *v);
+        check(ok, filters[i]);
+    }
+
+    if(failures)
+        printf("%d checks failed\n", failures);
+    return failures ? 1 : 0;
+}
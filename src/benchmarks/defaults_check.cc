@@ -0,0 +1,189 @@
+/*
+ * Copyright 2009-2014 The VOTCA Development Team (http://www.votca.org)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <boost/filesystem.hpp>
+#include <votca/tools/property.h>
+#include <votca/tools/defaultsregistry.h>
+#include <votca/tools/calculator.h>
+#include <votca/tools/thread.h>
+
+using namespace votca::tools;
+
+/*
+ * Checks of DefaultsRegistry, run by ctest.
+ *
+ * usage: defaults_check
+ *
+ * merge:    missing tags with a default are added, user values are kept,
+ *           empty tags get the default, sections are only created if they
+ *           contain defaults, merging twice changes nothing
+ * registry: a file is parsed once and shared, also between threads
+ * update:   Calculator::UpdateWithDefaults updates the options in place
+ */
+
+static int failures = 0;
+
+static void check(bool ok, const char *what)
+{
+    if(ok) return;
+    printf("FAILED: %s\n", what);
+    ++failures;
+}
+
+static const char *defaults_xml =
+    "<options><calc>"
+    "<a default=\"1\">1</a>"
+    "<b default=\"2\">2</b>"
+    "<c default=\"3\">3</c>"
+    "<nodefault>9</nodefault>"
+    "<section><d default=\"4\">4</d><plain>5</plain></section>"
+    "<empty_section><plain>6</plain></empty_section>"
+    "<deep><er><e default=\"7\">7</e></er></deep>"
+    "<parent default=\"8\">8<child default=\"x\">x</child></parent>"
+    "</calc></options>";
+
+static const char *user_xml =
+    "<options><calc>"
+    "<a>user</a>"
+    "<b>  </b>"
+    "<section><plain>mine</plain></section>"
+    "<parent><child>y</child></parent>"
+    "</calc></options>";
+
+static std::string value(Property &p, const std::string &key)
+{
+    return p.exists(key) ? p.get(key).value() : std::string("<missing>");
+}
+
+static void check_merge()
+{
+    Property defaults, options;
+    load_property_from_xml_string(defaults, defaults_xml);
+    load_property_from_xml_string(options, user_xml);
+    DefaultsRegistry::Merge(options.get("options.calc"), defaults.get("options.calc"));
+
+    check(value(options, "options.calc.a") == "user", "user value is kept");
+    check(value(options, "options.calc.b") == "2", "blank value gets the default");
+    check(value(options, "options.calc.c") == "3", "missing tag is added");
+    check(!options.exists("options.calc.nodefault"), "tag without default is not added");
+    check(value(options, "options.calc.section.d") == "4", "default is added to an existing section");
+    check(value(options, "options.calc.section.plain") == "mine", "user value in a section is kept");
+    check(!options.exists("options.calc.empty_section"), "section without defaults is not created");
+    check(value(options, "options.calc.deep.er.e") == "7", "nested sections with defaults are created");
+    check(value(options, "options.calc.parent.child") == "y", "user value of a child is kept");
+    check(options.get("options.calc.parent").value().find('8') == std::string::npos,
+            "a tag with childs is not overwritten");
+    check(options.get("options.calc.section").Select("d").size() == 1, "defaults are not duplicated");
+
+    Property twice = options;
+    DefaultsRegistry::Merge(twice.get("options.calc"), defaults.get("options.calc"));
+    check(twice.get("options.calc").size() == options.get("options.calc").size()
+            && twice.get("options.calc.section").size() == options.get("options.calc.section").size(),
+            "merging twice changes nothing");
+}
+
+class GetThread : public Thread
+{
+public:
+    GetThread(const std::string &file) : result(NULL), _file(file) {}
+    void Run() { result = &DefaultsRegistry::Instance().Get(_file); }
+
+    Property *result;
+
+private:
+    std::string _file;
+};
+
+static void check_registry(const std::string &file)
+{
+    std::vector<GetThread *> threads;
+    for(int i = 0; i < 8; ++i)
+        threads.push_back(new GetThread(file));
+    for(size_t i = 0; i < threads.size(); ++i)
+        threads[i]->Start();
+    bool same = true;
+    for(size_t i = 0; i < threads.size(); ++i) {
+        threads[i]->WaitDone();
+        same = same && threads[i]->result == threads[0]->result;
+    }
+    check(same, "threads get the same tree");
+
+    Property &first = DefaultsRegistry::Instance().Get(file);
+    check(&first == threads[0]->result, "the tree is shared");
+    for(size_t i = 0; i < threads.size(); ++i)
+        delete threads[i];
+
+    // the file is not parsed again
+    {
+        std::ofstream out(file.c_str());
+        out << "<options><calc><a default=\"changed\">changed</a></calc></options>";
+    }
+    check(DefaultsRegistry::Instance().Get(file).get("options.calc.a").value() == "1",
+            "a file is parsed only once");
+
+    bool thrown = false;
+    try { DefaultsRegistry::Instance().Get(file + ".missing"); }
+    catch(std::exception &) { thrown = true; }
+    check(thrown, "missing file throws");
+}
+
+class TestCalculator : public votca::ctp::Calculator
+{
+public:
+    std::string Identify() { return "calc"; }
+    void Initialize(Property *) {}
+};
+
+static void check_update(const std::string &share)
+{
+    setenv("VOTCASHARE", share.c_str(), 1);
+    Property options;
+    load_property_from_xml_string(options, user_xml);
+    Property &calc = options.get("options.calc");
+    TestCalculator c;
+    c.UpdateWithDefaults(&options);
+    check(&calc == &options.get("options.calc"), "options are updated in place");
+    check(value(options, "options.calc.a") == "user" && value(options, "options.calc.c") == "3",
+            "UpdateWithDefaults merges the defaults");
+}
+
+int main()
+{
+    namespace fs = boost::filesystem;
+    fs::path dir = fs::temp_directory_path() / fs::unique_path("defaults_check-%%%%%%%%");
+    fs::create_directories(dir / "ctp" / "xml");
+    std::string file = (dir / "ctp" / "xml" / "calc.xml").string();
+    {
+        std::ofstream out(file.c_str());
+        out << defaults_xml;
+    }
+
+    check_merge();
+    // before the registry test changes the file on disk
+    check_update(dir.string());
+    check_registry(file);
+
+    fs::remove_all(dir);
+    if(failures)
+        printf("%d checks failed\n", failures);
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,274 @@
+/*
+ * Copyright 2009-2014 The VOTCA Development Team (http://www.votca.org)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <stdio.h>
+#include <math.h>
+#include <string.h>
+#include <algorithm>
+#include <string>
+#include <vector>
+#include <boost/format.hpp>
+#include <votca/tools/matrix.h>
+#include <votca/tools/randomstream.h>
+
+using namespace votca::tools;
+
+/*
+ * Checks of the symmetric 3x3 eigensystem solver, run by ctest.
+ *
+ * usage: eigensystem_check
+ *
+ * known:   matrices R diag(l) R^T give the eigenvalues l in ascending
+ *          order, residuals |A v - l v| and orthonormality errors are at
+ *          rounding level, also for degenerate pairs (rank-1, rank-2),
+ *          nearly degenerate and isotropic matrices and extreme scales
+ * jacobi:  eigenvalues and well separated eigenvectors agree with cjcbi
+ * float:   matrix_t<float> has residuals at float rounding level
+ * batch:   SolveEigensystems gives the same bits as SolveEigensystem
+ */
+
+static int failures = 0;
+
+static void check(bool ok, const std::string &what)
+{
+    if(ok) return;
+    printf("FAILED: %s\n", what.c_str());
+    ++failures;
+}
+
+/// a symmetric matrix with known eigenvalues
+struct testcase_t {
+    matrix a;
+    double l[3];
+    std::string name;
+};
+
+static testcase_t make_case(double l0, double l1, double l2, double scale,
+        const matrix &rot, const std::string &name)
+{
+    testcase_t c;
+    c.l[0] = l0 * scale; c.l[1] = l1 * scale; c.l[2] = l2 * scale;
+    std::sort(c.l, c.l + 3);
+    matrix d;
+    d.ZeroMatrix();
+    d[0][0] = l0 * scale; d[1][1] = l1 * scale; d[2][2] = l2 * scale;
+    matrix rt(rot);
+    rt.Transpose();
+    c.a = rot * d * rt;
+    // symmetric up to the last bit
+    for(int i = 0; i < 3; ++i)
+        for(int j = 0; j < i; ++j)
+            c.a[j][i] = c.a[i][j];
+    c.name = (boost::format("%s, l=(%.10g,%.10g,%.10g)*%g") % name % l0 % l1 % l2 % scale).str();
+    return c;
+}
+
+static std::vector<testcase_t> make_cases()
+{
+    const double special[][3] = {
+        {1, 2, 3}, {-5, 0.3, 7}, {0, 0, 1}, {0, 1, 1}, {1, 1, 3}, {1, 3, 3},
+        {-1, -1, 2}, {2, 2, 2}, {0, 0, 0}, {1, 1 + 1e-9, 3}, {1, 1 + 1e-6, 3},
+        {1, 3 - 1e-9, 3}, {1, 1 + 1e-7, 1 + 2e-7}, {1, 1 + 1e-4, 1 + 2e-4},
+        {1e-8, 1, 1e8}, {-1, 0, 1}
+    };
+    const double scales[] = { 1, 1e-100, 1e100, 3.7e-5 };
+
+    RandomStream rng(42);
+    matrix unit;
+    unit.UnitMatrix();
+    std::vector<testcase_t> cases;
+    for(size_t s = 0; s < sizeof(scales)/sizeof(scales[0]); ++s)
+        for(size_t i = 0; i < sizeof(special)/sizeof(special[0]); ++i) {
+            const double *l = special[i];
+            cases.push_back(make_case(l[0], l[1], l[2], scales[s], unit, "diagonal"));
+            for(int k = 0; k < 4; ++k) {
+                matrix rot;
+                rot.RandomRotation(rng);
+                cases.push_back(make_case(l[0], l[1], l[2], scales[s], rot, "rotated"));
+            }
+        }
+    for(int k = 0; k < 200; ++k) {
+        matrix rot;
+        rot.RandomRotation(rng);
+        cases.push_back(make_case(rng.rand_uniform() - 0.5, rng.rand_uniform() - 0.5,
+                rng.rand_uniform() - 0.5, 1, rot, "random"));
+    }
+    return cases;
+}
+
+static double max_abs(const double l[3])
+{
+    return std::max(fabs(l[0]), std::max(fabs(l[1]), fabs(l[2])));
+}
+
+/// largest residual |A v - l v| and orthonormality error, relative to scale
+template<typename T>
+static double max_error(const matrix &a, const typename matrix_t<T>::eigensystem_t &e, double scale)
+{
+    double err = 0;
+    for(int i = 0; i < 3; ++i) {
+        vec v(e.eigenvecs[i]);
+        err = std::max(err, abs(a * v - double(e.eigenvalues[i]) * v) / scale);
+        for(int j = 0; j < 3; ++j)
+            err = std::max(err, fabs(v * vec(e.eigenvecs[j]) - (i == j ? 1. : 0.)));
+    }
+    return err;
+}
+
+/// cjcbi with the eigenvalues sorted in ascending order
+static void jacobi(const matrix &a, double l[3], vec v[3])
+{
+    matrix m(a), vecs;
+    cjcbi(m, vecs);
+    int order[3] = { 0, 1, 2 };
+    for(int i = 0; i < 3; ++i)
+        for(int j = i + 1; j < 3; ++j)
+            if(m[order[j]][order[j]] < m[order[i]][order[i]])
+                std::swap(order[i], order[j]);
+    for(int i = 0; i < 3; ++i) {
+        l[i] = m[order[i]][order[i]];
+        v[i] = vecs.getCol(order[i]);
+        v[i].normalize();
+    }
+}
+
+static void check_double(const std::vector<testcase_t> &cases)
+{
+    for(size_t c = 0; c < cases.size(); ++c) {
+        const testcase_t &t = cases[c];
+        double scale = max_abs(t.l);
+        if(scale == 0) scale = 1;
+        matrix a(t.a);
+        matrix::eigensystem_t e;
+        a.SolveEigensystem(e);
+
+        bool sorted = e.eigenvalues[0] <= e.eigenvalues[1] && e.eigenvalues[1] <= e.eigenvalues[2];
+        double lerr = 0;
+        for(int i = 0; i < 3; ++i)
+            lerr = std::max(lerr, fabs(e.eigenvalues[i] - t.l[i]) / scale);
+        check(sorted && lerr < 1e-13, t.name + ": eigenvalues");
+        check(max_error<double>(t.a, e, scale) < 1e-13, t.name + ": residual");
+
+        // cjcbi stops at an absolute threshold, compare at unit scale only
+        if(scale < 0.1 || scale > 10) continue;
+        double jl[3];
+        vec jv[3];
+        jacobi(t.a, jl, jv);
+        bool same = true;
+        for(int i = 0; i < 3; ++i) {
+            same = same && fabs(jl[i] - e.eigenvalues[i]) < 1e-9 * scale;
+            double gap = std::min(i > 0 ? jl[i] - jl[i-1] : HUGE_VAL,
+                    i < 2 ? jl[i+1] - jl[i] : HUGE_VAL);
+            if(gap > 1e-3 * scale)
+                same = same && fabs(jv[i] * e.eigenvecs[i]) > 1 - 1e-9;
+        }
+        check(same, t.name + ": agrees with cjcbi");
+    }
+}
+
+static matrixf to_float(const matrix &a)
+{
+    matrixf f;
+    for(int i = 0; i < 3; ++i)
+        for(int j = 0; j < 3; ++j)
+            f[i][j] = (float)a.get(i, j);
+    return f;
+}
+
+static matrix to_double(const matrixf &f)
+{
+    matrix a;
+    for(int i = 0; i < 3; ++i)
+        for(int j = 0; j < 3; ++j)
+            a[i][j] = f.get(i, j);
+    return a;
+}
+
+static void check_float(const std::vector<testcase_t> &cases)
+{
+    for(size_t c = 0; c < cases.size(); ++c) {
+        const testcase_t &t = cases[c];
+        double scale = max_abs(t.l);
+        if(scale > 1e30 || (scale < 1e-30 && scale != 0)) continue;
+        if(scale == 0) scale = 1;
+        matrixf f = to_float(t.a);
+        matrixf::eigensystem_t e;
+        f.SolveEigensystem(e);
+        // the eigenvalues of the rounded matrix differ by float rounding
+        double lerr = 0;
+        for(int i = 0; i < 3; ++i)
+            lerr = std::max(lerr, fabs(e.eigenvalues[i] - t.l[i]) / scale);
+        check(lerr < 1e-6, t.name + ": float eigenvalues");
+        check(max_error<float>(to_double(f), e, scale) < 1e-6, t.name + ": float residual");
+    }
+}
+
+template<typename T>
+static bool same_bits(const typename matrix_t<T>::eigensystem_t &a,
+        const typename matrix_t<T>::eigensystem_t &b)
+{
+    for(int i = 0; i < 3; ++i) {
+        if(memcmp(&a.eigenvalues[i], &b.eigenvalues[i], sizeof(T)) != 0)
+            return false;
+        T va[3] = { a.eigenvecs[i].getX(), a.eigenvecs[i].getY(), a.eigenvecs[i].getZ() };
+        T vb[3] = { b.eigenvecs[i].getX(), b.eigenvecs[i].getY(), b.eigenvecs[i].getZ() };
+        if(memcmp(va, vb, sizeof(va)) != 0)
+            return false;
+    }
+    return true;
+}
+
+static void check_batch(const std::vector<testcase_t> &cases)
+{
+    std::vector<matrix> m;
+    std::vector<matrixf> mf;
+    for(size_t c = 0; c < cases.size(); ++c) {
+        m.push_back(cases[c].a);
+        if(max_abs(cases[c].l) < 1e30)
+            mf.push_back(to_float(cases[c].a));
+    }
+    std::vector<matrix::eigensystem_t> e(m.size());
+    SolveEigensystems(&m[0], &e[0], m.size());
+    bool same = true;
+    for(size_t c = 0; c < m.size(); ++c) {
+        matrix::eigensystem_t single;
+        m[c].SolveEigensystem(single);
+        same = same && same_bits<double>(single, e[c]);
+    }
+    check(same, "batched double eigensystems");
+
+    std::vector<matrixf::eigensystem_t> ef(mf.size());
+    SolveEigensystems(&mf[0], &ef[0], mf.size());
+    same = true;
+    for(size_t c = 0; c < mf.size(); ++c) {
+        matrixf::eigensystem_t single;
+        mf[c].SolveEigensystem(single);
+        same = same && same_bits<float>(single, ef[c]);
+    }
+    check(same, "batched float eigensystems");
+}
+
+int main()
+{
+    std::vector<testcase_t> cases = make_cases();
+    check_double(cases);
+    check_float(cases);
+    check_batch(cases);
+    if(failures)
+        printf("%d checks failed\n", failures);
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,280 @@
+/*
+ * Copyright 2009-2014 The VOTCA Development Team (http://www.votca.org)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+#include <stdexcept>
+#include <boost/numeric/ublas/matrix_proxy.hpp>
+#include <boost/numeric/ublas/vector_proxy.hpp>
+#include <votca/tools/linalg.h>
+#include <votca/tools/linalgsolvers.h>
+#include <votca/tools/lanczos.h>
+#include <votca/tools/sparsematrix.h>
+#include <votca/tools/leastsquares.h>
+
+using namespace votca::tools;
+
+/*
+ * Agreement of the linear algebra solvers, run by ctest.
+ *
+ * usage: linalg_check
+ *
+ * eigen:   full and partial (nmax, Lanczos) eigensystems agree and nmax
+ *          is validated
+ * solvers: the solver objects agree with the linalg_* functions
+ * lsqr:    the iterative least-squares solvers agree with dense QR and
+ *          with the damped normal equations
+ *
+ * Without a linalg backend the dense parts are skipped, Lanczos and the
+ * iterative solvers are checked on their own.
+ */
+
+static int failures = 0;
+
+static void check(bool ok, const char *what)
+{
+    if(ok) return;
+    printf("FAILED: %s\n", what);
+    ++failures;
+}
+
+/// true if err is the error of a missing linalg backend
+static bool not_compiled_in(const std::runtime_error &err)
+{
+    return strstr(err.what(), "not compiled-in") != NULL;
+}
+
+static double max_diff(const ub::matrix<double> &a, const ub::matrix<double> &b)
+{
+    double m = 0;
+    for(size_t i = 0; i < a.size1(); ++i)
+        for(size_t j = 0; j < a.size2(); ++j)
+            m = std::max(m, fabs(a(i,j) - b(i,j)));
+    return m;
+}
+
+/// random symmetric matrix with eigenvalues spread over [1, 2n]
+static ub::matrix<double> random_symmetric(size_t n)
+{
+    ub::matrix<double> A(n, n);
+    for(size_t i = 0; i < n; ++i)
+        for(size_t j = 0; j <= i; ++j)
+            A(i,j) = A(j,i) = drand48() - 0.5;
+    for(size_t i = 0; i < n; ++i)
+        A(i,i) += 1.0 + 2.0*i;
+    return A;
+}
+
+/// |A*V - V*diag(E)| relative to |A|
+static double eigen_residual(const ub::matrix<double> &A, const ub::vector<double> &E,
+        const ub::matrix<double> &V)
+{
+    ub::matrix<double> AV = ub::prod(A, V);
+    for(size_t j = 0; j < E.size(); ++j)
+        ub::column(AV, j) -= E(j)*ub::column(V, j);
+    return ub::norm_inf(AV) / ub::norm_inf(A);
+}
+
+static void check_eigen()
+{
+    const size_t n = 150;
+    ub::matrix<double> A = random_symmetric(n);
+
+    // Lanczos needs no backend
+    LanczosSolver lanczos;
+    MatrixOperator op(A);
+    ub::vector<double> El, Eh;
+    ub::matrix<double> Vl, Vh;
+    check(lanczos.Solve(op, 6, El, Vl), "Lanczos lowest converges");
+    check(eigen_residual(A, El, Vl) < 1e-8, "Lanczos lowest residual");
+    check(lanczos.Solve(op, 4, Eh, Vh, LanczosSolver::highest), "Lanczos highest converges");
+    check(eigen_residual(A, Eh, Vh) < 1e-8, "Lanczos highest residual");
+
+    bool thrown = false;
+    try {
+        ub::vector<double> E;
+        ub::matrix<double> V;
+        ub::matrix<double> B = A;
+        linalg_eigenvalues(B, E, V, 0);
+    }
+    catch(std::invalid_argument &err) {
+        thrown = true;
+    }
+    check(thrown, "nmax = 0 throws");
+    thrown = false;
+    try {
+        ub::vector<double> E;
+        ub::matrix<double> V;
+        ub::matrix<double> B = A;
+        linalg_eigenvalues(B, E, V, n + 1);
+    }
+    catch(std::invalid_argument &err) {
+        thrown = true;
+    }
+    check(thrown, "nmax > n throws");
+
+    try {
+        ub::vector<double> E;
+        ub::matrix<double> V = A;
+        linalg_eigenvalues(E, V);
+        check(eigen_residual(A, E, V) < 1e-12, "full eigensystem residual");
+        check(ub::norm_inf(ub::subrange(E, 0, 6) - El) < 1e-9, "Lanczos lowest agrees with full");
+        check(ub::norm_inf(ub::subrange(E, n - 4, n) - Eh) < 1e-9, "Lanczos highest agrees with full");
+
+        ub::vector<double> Ep;
+        ub::matrix<double> Vp;
+        ub::matrix<double> B = A;
+        linalg_eigenvalues(B, Ep, Vp, 10);
+        check(Ep.size() == 10 && Vp.size1() == n && Vp.size2() == 10, "nmax eigensystem size");
+        check(ub::norm_inf(Ep - ub::subrange(E, 0, 10)) < 1e-9, "nmax eigenvalues agree with full");
+        check(eigen_residual(A, Ep, Vp) < 1e-8, "nmax eigensystem residual");
+
+        EigenSolver solver;
+        ub::vector<double> Es;
+        ub::matrix<double> Vs;
+        solver.Solve(A, Es, Vs);
+        check(ub::norm_inf(Es - E) < 1e-12, "EigenSolver agrees with linalg_eigenvalues");
+    }
+    catch(std::runtime_error &err) {
+        if(!not_compiled_in(err)) throw;
+        printf("skipped: dense eigensystems, no linalg backend\n");
+    }
+}
+
+static void check_solvers()
+{
+    const size_t n = 60, m = 200;
+    ub::matrix<double> A = random_symmetric(n);
+    ub::matrix<double> B(m, n);
+    for(size_t i = 0; i < m; ++i)
+        for(size_t j = 0; j < n; ++j)
+            B(i,j) = drand48() - 0.5;
+    ub::vector<double> a(n), b(m);
+    for(size_t i = 0; i < n; ++i) a(i) = drand48();
+    for(size_t i = 0; i < m; ++i) b(i) = drand48();
+
+    try {
+        // least squares
+        ub::vector<double> x(n), xq;
+        ub::matrix<double> Bc = B;
+        ub::vector<double> bc = b;
+        linalg_qrsolve(x, Bc, bc);
+        QRSolver qr;
+        qr.Decompose(B);
+        qr.Solve(xq, b);
+        check(ub::norm_inf(x - xq) < 1e-12, "QRSolver agrees with linalg_qrsolve");
+        ub::vector<double> r = ub::prod(B, xq) - b;
+        check(ub::norm_inf(ub::prod(ub::trans(B), r)) < 1e-12, "QR solution is a least-squares solution");
+
+        // square systems, A is positive definite
+        ub::vector<double> xc, xl;
+        CholeskySolver cholesky;
+        cholesky.Decompose(A);
+        cholesky.Solve(xc, a);
+        LUSolver lu;
+        lu.Decompose(A);
+        lu.Solve(xl, a);
+        check(ub::norm_inf(xc - xl) < 1e-12, "CholeskySolver agrees with LUSolver");
+        check(ub::norm_inf(ub::prod(A, xl) - a) < 1e-12, "LUSolver residual");
+
+        ub::matrix<double> Ainv;
+        lu.Invert(Ainv);
+        check(max_diff(ub::prod(A, Ainv), ub::identity_matrix<double>(n)) < 1e-12, "LUSolver inverse");
+
+        bool thrown = false;
+        try {
+            lu.Decompose(ub::zero_matrix<double>(n, n));
+        }
+        catch(std::runtime_error &err) {
+            thrown = true;
+        }
+        check(thrown, "LUSolver rejects a singular matrix");
+    }
+    catch(std::runtime_error &err) {
+        if(!not_compiled_in(err)) throw;
+        printf("skipped: dense solvers, no linalg backend\n");
+    }
+}
+
+static void check_lsqr()
+{
+    // sparse overdetermined system with badly scaled columns
+    const size_t m = 300, n = 40;
+    SparseMatrixBuilder builder(m, n);
+    for(size_t i = 0; i < m; ++i)
+        for(int k = 0; k < 5; ++k) {
+            size_t j = lrand48() % n;
+            builder.Add(i, j, (drand48() - 0.5)*(j % 7 == 0 ? 1000 : 1));
+        }
+    for(size_t j = 0; j < n; ++j)
+        builder.Add(j, j, 1.0);
+    SparseMatrix A;
+    builder.Build(A);
+    ub::matrix<double> Ad;
+    A.ToDense(Ad);
+    ub::vector<double> b(m);
+    for(size_t i = 0; i < m; ++i) b(i) = drand48();
+
+    const double lambda = 0.7;
+    for(int method = 0; method < 2; ++method)
+        for(int jacobi = 0; jacobi < 2; ++jacobi) {
+            LeastSquaresSolver solver;
+            solver.setMethod(method ? LeastSquaresSolver::lsqr : LeastSquaresSolver::cgls);
+            solver.setJacobiPreconditioner(jacobi);
+
+            ub::vector<double> x;
+            check(solver.Solve(A, b, x), "least squares converges");
+            ub::vector<double> r = ub::prod(Ad, x) - b;
+            check(ub::norm_inf(ub::prod(ub::trans(Ad), r)) < 1e-6*ub::norm_inf(b)*ub::norm_frobenius(Ad),
+                    "least-squares optimality");
+            check(fabs(solver.getResidualNorm() - ub::norm_2(r)) < 1e-8*ub::norm_2(r), "residual norm");
+
+            // the damped solution solves (trans(A)*A + lambda^2) x = trans(A)*b
+            solver.setDamping(lambda);
+            ub::vector<double> xd;
+            check(solver.Solve(A, b, xd), "damped least squares converges");
+            ub::vector<double> g = ub::prod(ub::trans(Ad), ub::vector<double>(ub::prod(Ad, xd) - b))
+                    + lambda*lambda*xd;
+            check(ub::norm_inf(g) < 1e-6*ub::norm_inf(b)*ub::norm_frobenius(Ad), "damped optimality");
+
+            try {
+                ub::vector<double> xq(n);
+                ub::matrix<double> Ac = Ad;
+                ub::vector<double> bc = b;
+                linalg_qrsolve(xq, Ac, bc);
+                // without scaling the badly scaled columns limit the accuracy
+                double tol = jacobi ? 1e-8 : 1e-5;
+                check(ub::norm_inf(x - xq) < tol*ub::norm_inf(xq), "least squares agrees with QR");
+            }
+            catch(std::runtime_error &err) {
+                if(!not_compiled_in(err)) throw;
+            }
+        }
+}
+
+int main()
+{
+    srand48(1);
+    check_eigen();
+    check_solvers();
+    check_lsqr();
+    if(failures)
+        printf("%d checks failed\n", failures);
+    return failures ? 1 : 0;
+}
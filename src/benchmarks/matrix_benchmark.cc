@@ -0,0 +1,143 @@
+/*
+ * Copyright 2009-2014 The VOTCA Development Team (http://www.votca.org)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <stdlib.h>
+#include <sys/time.h>
+#include <iostream>
+#include <vector>
+#include <boost/format.hpp>
+#include <votca/tools/matrix.h>
+#include <votca/tools/matrixarray.h>
+
+using namespace votca::tools;
+
+/*
+ * Loops over matrix objects against the batched MatrixArray kernels.
+ *
+ * usage: matrix_benchmark [n] [repeat]
+ */
+
+static double now()
+{
+    struct timeval tv;
+    gettimeofday(&tv, NULL);
+    return tv.tv_sec + 1e-6 * tv.tv_usec;
+}
+
+static void report(const char *name, size_t n, double t, double checksum)
+{
+    // print a checksum so the work cannot be optimized away
+    std::cout << boost::format("%-32s %8.3f s %10.1f M/s  (sum %g)\n")
+            % name % t % (n / t * 1e-6) % checksum;
+}
+
+static double sum(const std::vector<matrix> &m)
+{
+    double s = 0;
+    for(size_t k = 0; k < m.size(); ++k)
+        s += m[k].get(0,0) + m[k].get(1,2) + m[k].get(2,1);
+    return s;
+}
+
+static double sum(const MatrixArray &m)
+{
+    double s = 0;
+    for(size_t k = 0; k < m.size(); ++k)
+        s += m.element(0,0)[k] + m.element(1,2)[k] + m.element(2,1)[k];
+    return s;
+}
+
+int main(int argc, char **argv)
+{
+    size_t n = argc > 1 ? atol(argv[1]) : 100000;
+    int repeat = argc > 2 ? atoi(argv[2]) : 100;
+    size_t total = n * repeat;
+    std::cout << n << " matrices, " << repeat << " repetitions\n";
+
+    srand48(42);
+    std::vector<matrix> a(n), b(n), c(n);
+    std::vector<vec> v(n), w(n);
+    for(size_t k = 0; k < n; ++k) {
+        a[k].RandomRotation();
+        b[k].RandomRotation();
+        v[k] = vec(drand48(), drand48(), drand48());
+    }
+    MatrixArray A(a), B(b), C;
+    VecArray V(v), W;
+    std::vector<double> det(n);
+    double start;
+
+    start = now();
+    for(int r = 0; r < repeat; ++r)
+        for(size_t k = 0; k < n; ++k)
+            c[k] = a[k] * b[k];
+    report("matrix multiply", total, now() - start, sum(c));
+
+    start = now();
+    for(int r = 0; r < repeat; ++r)
+        multiply(A, B, C);
+    report("MatrixArray multiply", total, now() - start, sum(C));
+
+    start = now();
+    for(int r = 0; r < repeat; ++r)
+        for(size_t k = 0; k < n; ++k)
+            w[k] = a[k] * v[k];
+    double s = 0;
+    for(size_t k = 0; k < n; ++k) s += w[k].getX();
+    report("matrix * vec", total, now() - start, s);
+
+    start = now();
+    for(int r = 0; r < repeat; ++r)
+        multiply(A, V, W);
+    s = 0;
+    for(size_t k = 0; k < n; ++k) s += W.x()[k];
+    report("MatrixArray * VecArray", total, now() - start, s);
+
+    start = now();
+    for(int r = 0; r < repeat; ++r)
+        for(size_t k = 0; k < n; ++k) {
+            c[k] = a[k];
+            c[k].Invert();
+        }
+    report("matrix Invert", total, now() - start, sum(c));
+
+    start = now();
+    for(int r = 0; r < repeat; ++r)
+        invert(A, C);
+    report("MatrixArray invert", total, now() - start, sum(C));
+
+    start = now();
+    for(int r = 0; r < repeat; ++r)
+        for(size_t k = 0; k < n; ++k) {
+            c[k] = a[k];
+            c[k].Transpose();
+        }
+    report("matrix Transpose", total, now() - start, sum(c));
+
+    start = now();
+    for(int r = 0; r < repeat; ++r)
+        transpose(A, C);
+    report("MatrixArray transpose", total, now() - start, sum(C));
+
+    start = now();
+    for(int r = 0; r < repeat; ++r)
+        determinant(A, &det[0]);
+    s = 0;
+    for(size_t k = 0; k < n; ++k) s += det[k];
+    report("MatrixArray determinant", total, now() - start, s);
+    return 0;
+}
@@ -0,0 +1,239 @@
+/*
+ * Copyright 2009-2014 The VOTCA Development Team (http://www.votca.org)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <stdio.h>
+#include <math.h>
+#include <algorithm>
+#include <string>
+#include <vector>
+#include <boost/format.hpp>
+#include <votca/tools/matrixarray.h>
+#include <votca/tools/randomstream.h>
+
+using namespace votca::tools;
+
+/*
+ * Checks of the MatrixArray kernels against matrix, run by ctest.
+ *
+ * usage: matrixarray_check
+ *
+ * invert:      agrees with matrix::Invert, a*inv(a) is the identity, also
+ *              in place, singular matrices give inf or nan
+ * determinant: agrees with the triple product of the rows, rotations
+ *              have determinant 1 and det(a*b) = det(a)*det(b)
+ * kernels:     multiply and transpose agree with matrix, also in place
+ * storage:     set, operator[], copies, resize and vector conversion
+ *
+ * All sizes from 0 to 70 and a large one are used, so that every
+ * remainder of the vectorized loops is covered.
+ */
+
+static int failures = 0;
+
+static void check(bool ok, const std::string &what)
+{
+    if(ok) return;
+    printf("FAILED: %s\n", what.c_str());
+    ++failures;
+}
+
+static double max_diff(const matrix &a, const matrix &b)
+{
+    double m = 0;
+    for(int i = 0; i < 3; ++i)
+        for(int j = 0; j < 3; ++j)
+            m = std::max(m, fabs(a.get(i,j) - b.get(i,j)));
+    return m;
+}
+
+/// well conditioned random matrix, elements of order 1
+static matrix random_matrix(RandomStream &rng)
+{
+    matrix m;
+    for(int i = 0; i < 3; ++i)
+        for(int j = 0; j < 3; ++j)
+            m[i][j] = rng.rand_uniform() - 0.5 + (i == j ? 2. : 0.);
+    return m;
+}
+
+static std::vector<matrix> random_matrices(RandomStream &rng, size_t n)
+{
+    std::vector<matrix> m;
+    for(size_t k = 0; k < n; ++k)
+        m.push_back(random_matrix(rng));
+    return m;
+}
+
+static matrix unit_matrix()
+{
+    matrix u;
+    u.UnitMatrix();
+    return u;
+}
+
+static void check_invert(RandomStream &rng, size_t n)
+{
+    std::string size = (boost::format(" of %d matrices") % n).str();
+    std::vector<matrix> m = random_matrices(rng, n);
+    MatrixArray a(m), inv;
+    invert(a, inv);
+    bool same = inv.size() == n, identity = true;
+    for(size_t k = 0; k < n && same; ++k) {
+        matrix ref(m[k]);
+        ref.Invert();
+        same = max_diff(inv[k], ref) < 1e-14;
+        identity = identity && max_diff(m[k] * inv[k], unit_matrix()) < 1e-14;
+    }
+    check(same, "invert agrees with matrix::Invert" + size);
+    check(identity, "a*inv(a) is the identity" + size);
+
+    invert(a, a);
+    same = true;
+    for(size_t k = 0; k < n && same; ++k)
+        same = max_diff(a[k], inv[k]) == 0;
+    check(same, "invert in place" + size);
+}
+
+/// det as triple product of the rows
+static double triple_product(const matrix &m)
+{
+    return m.getRow(0) * (m.getRow(1) ^ m.getRow(2));
+}
+
+static void check_determinant(RandomStream &rng, size_t n)
+{
+    std::string size = (boost::format(" of %d matrices") % n).str();
+    std::vector<matrix> m = random_matrices(rng, n), r(n);
+    for(size_t k = 0; k < n; ++k)
+        r[k].RandomRotation(rng);
+    MatrixArray a(m), rot(r), prod;
+    std::vector<double> det(n + 1), det_rot(n + 1), det_prod(n + 1);
+    determinant(a, &det[0]);
+    determinant(rot, &det_rot[0]);
+    multiply(a, rot, prod);
+    determinant(prod, &det_prod[0]);
+
+    bool same = true, unit = true, product = true;
+    for(size_t k = 0; k < n; ++k) {
+        same = same && fabs(det[k] - triple_product(m[k])) < 1e-14 * fabs(det[k]);
+        unit = unit && fabs(det_rot[k] - 1) < 1e-14;
+        product = product && fabs(det_prod[k] - det[k]*det_rot[k]) < 1e-13 * fabs(det[k]);
+    }
+    check(same, "determinant agrees with the triple product" + size);
+    check(unit, "rotations have determinant 1" + size);
+    check(product, "det(a*b) = det(a)*det(b)" + size);
+}
+
+static void check_kernels(RandomStream &rng, size_t n)
+{
+    std::string size = (boost::format(" of %d matrices") % n).str();
+    std::vector<matrix> m = random_matrices(rng, n), m2 = random_matrices(rng, n);
+    matrix r = random_matrix(rng);
+    VecArray v;
+    for(size_t k = 0; k < n; ++k)
+        v.push_back(vec(rng.rand_uniform(), rng.rand_uniform(), rng.rand_uniform()));
+    MatrixArray a(m), b(m2), ab, ra, at;
+    VecArray av;
+    multiply(a, b, ab);
+    multiply(r, a, ra);
+    multiply(a, v, av);
+    transpose(a, at);
+
+    bool same = true;
+    for(size_t k = 0; k < n; ++k) {
+        matrix t(m[k]);
+        t.Transpose();
+        same = same && max_diff(ab[k], m[k] * m2[k]) < 1e-15
+            && max_diff(ra[k], r * m[k]) < 1e-15
+            && abs(av[k] - m[k] * v[k]) < 1e-15
+            && max_diff(at[k], t) == 0;
+    }
+    check(same, "multiply and transpose agree with matrix" + size);
+
+    // in place, out is one of the inputs
+    MatrixArray c(a);
+    multiply(c, b, c);
+    VecArray w(v);
+    multiply(a, w, w);
+    MatrixArray d(a);
+    transpose(d, d);
+    same = true;
+    for(size_t k = 0; k < n; ++k)
+        same = same && max_diff(c[k], ab[k]) == 0 && abs(w[k] - av[k]) == 0
+            && max_diff(d[k], at[k]) == 0;
+    check(same, "multiply and transpose in place" + size);
+}
+
+static void check_singular()
+{
+    matrix s;
+    s.ZeroMatrix();
+    s[0][0] = 1; s[1][1] = 1;
+    MatrixArray a(std::vector<matrix>(3, s)), inv;
+    double det[3];
+    determinant(a, det);
+    invert(a, inv);
+    bool finite = true;
+    for(int i = 0; i < 3; ++i)
+        for(int j = 0; j < 3; ++j)
+            finite = finite && isfinite(inv[1].get(i,j));
+    check(det[1] == 0 && !finite, "singular matrices give inf or nan");
+}
+
+static void check_storage(RandomStream &rng)
+{
+    std::vector<matrix> m = random_matrices(rng, 37);
+    MatrixArray a;
+    for(size_t k = 0; k < m.size(); ++k)
+        a.push_back(m[k]);
+    MatrixArray copy(a), assigned;
+    assigned = a;
+    a.reserve(1000);
+    a.resize(40);
+    std::vector<matrix> back;
+    a.ToVector(back);
+    bool same = a.size() == 40 && copy.size() == 37 && assigned.size() == 37;
+    for(size_t k = 0; k < m.size() && same; ++k)
+        same = max_diff(a[k], m[k]) == 0 && max_diff(copy[k], m[k]) == 0
+            && max_diff(assigned[k], m[k]) == 0 && max_diff(back[k], m[k]) == 0
+            && a.element(1, 2)[k] == m[k].get(1, 2);
+    check(same, "storage keeps the matrices");
+
+    a.set(3, unit_matrix());
+    check(max_diff(a[3], unit_matrix()) == 0 && max_diff(copy[3], m[3]) == 0,
+            "set changes only one array");
+    a.clear();
+    check(a.size() == 0, "clear");
+}
+
+int main()
+{
+    RandomStream rng(17);
+    for(size_t n = 0; n <= 70; ++n) {
+        check_invert(rng, n);
+        check_determinant(rng, n);
+        check_kernels(rng, n);
+    }
+    check_invert(rng, 10007);
+    check_determinant(rng, 10007);
+    check_kernels(rng, 10007);
+    check_singular();
+    check_storage(rng);
+    if(failures)
+        printf("%d checks failed\n", failures);
+    return failures ? 1 : 0;
+}
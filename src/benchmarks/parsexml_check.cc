@@ -0,0 +1,200 @@
+/*
+ * Copyright 2009-2014 The VOTCA Development Team (http://www.votca.org)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <stdio.h>
+#include <map>
+#include <string>
+#include <stdexcept>
+#include <boost/lexical_cast.hpp>
+#include <boost/utility/string_ref.hpp>
+#include <votca/tools/parsexml.h>
+
+using namespace votca::tools;
+
+/*
+ * Checks of the ParseXML handler interface, run by ctest.
+ *
+ * usage: parsexml_check
+ *
+ * handlers:   string_ref and map handlers see the same elements and
+ *             attributes, also when mixed within one document
+ * ignore:     IgnoreChilds skips whole subtrees, elements without handler
+ *             are skipped
+ * slots:      deep nesting and repeated parsing with one ParseXML reuse
+ *             the handler slots
+ * attributes: size, find, has and get of XMLAttributes
+ */
+
+static int failures = 0;
+
+static void check(bool ok, const char *what)
+{
+    if(ok) return;
+    printf("FAILED: %s\n", what);
+    ++failures;
+}
+
+/// writes every element as name[attr=value,...] into log
+class Recorder
+{
+public:
+    explicit Recorder(ParseXML &parser) : _parser(parser) {}
+
+    void Ref(const boost::string_ref &el, const XMLAttributes &attr) {
+        log += std::string(el.data(), el.size()) + "[";
+        for(size_t i = 0; i < attr.size(); ++i)
+            log += std::string(i ? "," : "") + attr.name(i) + "=" + attr.value(i);
+        log += "]";
+        Next(el == "skip", el == "map");
+    }
+
+    void Map(const std::string &el, std::map<std::string, std::string> &attr) {
+        log += el + "[";
+        for(std::map<std::string, std::string>::iterator a = attr.begin(); a != attr.end(); ++a)
+            log += std::string(a == attr.begin() ? "" : ",") + a->first + "=" + a->second;
+        log += "]";
+        Next(el == "skip", el != "ref");
+    }
+
+    std::string log;
+
+private:
+    ParseXML &_parser;
+
+    void Next(bool skip, bool map) {
+        if(skip) _parser.IgnoreChilds();
+        else if(map) _parser.NextHandler(this, &Recorder::Map);
+        else _parser.NextHandler(this, &Recorder::Ref);
+    }
+};
+
+/// counts elements and checks the depth given in the attribute d
+class DepthCounter
+{
+public:
+    explicit DepthCounter(ParseXML &parser) : elements(0), ok(true), _parser(parser) {}
+
+    void Element(const boost::string_ref &, const XMLAttributes &attr) {
+        ok = ok && attr.get<long>("d") == elements;
+        ++elements;
+        _parser.NextHandler(this, &DepthCounter::Element);
+    }
+
+    long elements;
+    bool ok;
+
+private:
+    ParseXML &_parser;
+};
+
+/// checks the XMLAttributes accessors on the element it sees
+class AttributeChecker
+{
+public:
+    void Element(const boost::string_ref &, const XMLAttributes &attr) {
+        check(attr.size() == 3, "XMLAttributes size");
+        check(attr.has("i") && attr.has("x") && !attr.has("missing"), "XMLAttributes has");
+        check(std::string(attr.find("s")) == "a b" && attr.find("missing") == NULL, "XMLAttributes find");
+        check(attr.get<int>("i") == -7 && attr.get<double>("x") == 2.5, "XMLAttributes get");
+        check(std::string(attr.name(0)) == "i" && std::string(attr.value(2)) == "a b",
+                "XMLAttributes name and value keep the document order");
+        bool thrown = false;
+        try { attr.get<int>("missing"); }
+        catch(std::runtime_error &) { thrown = true; }
+        check(thrown, "get of a missing attribute throws");
+        thrown = false;
+        try { attr.get<int>("s"); }
+        catch(std::runtime_error &) { thrown = true; }
+        check(thrown, "get with the wrong type throws");
+    }
+};
+
+static std::string parse(const std::string &doc, bool map)
+{
+    ParseXML parser;
+    Recorder r(parser);
+    if(map) parser.NextHandler(&r, &Recorder::Map);
+    else parser.NextHandler(&r, &Recorder::Ref);
+    parser.OpenBuffer(doc.data(), doc.size());
+    return r.log;
+}
+
+int main()
+{
+    // handlers, ignore
+    const std::string doc =
+        "<top a=\"1\" b=\"two\">"
+        "<x/><y c=\"3\"><z/></y>"
+        "<skip k=\"v\"><hidden><deeper/></hidden></skip>"
+        "<after/>"
+        "</top>";
+    const std::string expected = "top[a=1,b=two]x[]y[c=3]z[]skip[k=v]after[]";
+    check(parse(doc, false) == expected, "string_ref handlers");
+    check(parse(doc, true) == expected, "map handlers");
+
+    // the map handler is used below <map>, the string_ref handler below <ref>
+    const std::string mixed = "<top><map q=\"1\"><ref r=\"2\"><x s=\"3\"/></ref></map><x/></top>";
+    const std::string mixed_expected = "top[]map[q=1]ref[r=2]x[s=3]x[]";
+    check(parse(mixed, false) == mixed_expected, "mixed handlers, starting with string_ref");
+    check(parse(mixed, true) == mixed_expected, "mixed handlers, starting with map");
+
+    {
+        // no handler at all, everything is skipped
+        ParseXML parser;
+        parser.OpenBuffer(doc.data(), doc.size());
+    }
+
+    // slots
+    const int depth = 5000;
+    std::string deep;
+    for(int d = 0; d < depth; ++d)
+        deep += "<e d=\"" + boost::lexical_cast<std::string>(d) + "\">";
+    for(int d = 0; d < depth; ++d)
+        deep += "</e>";
+    {
+        ParseXML parser;
+        DepthCounter c(parser);
+        parser.NextHandler(&c, &DepthCounter::Element);
+        parser.OpenBuffer(deep.data(), deep.size());
+        check(c.elements == depth && c.ok, "deep nesting");
+        // the first handler stays set, parse again with the same slots
+        c.elements = 0;
+        parser.OpenBuffer(deep.data(), deep.size());
+        check(c.elements == depth && c.ok, "second parse with the same ParseXML");
+    }
+    {
+        ParseXML parser;
+        Recorder r(parser);
+        parser.NextHandler(&r, &Recorder::Ref);
+        for(int i = 0; i < 3; ++i)
+            parser.OpenBuffer(doc.data(), doc.size());
+        check(r.log == expected + expected + expected, "repeated parsing");
+    }
+
+    // attributes
+    {
+        ParseXML parser;
+        AttributeChecker a;
+        parser.NextHandler(&a, &AttributeChecker::Element);
+        const std::string attrdoc = "<e i=\"-7\" x=\"2.5\" s=\"a b\"/>";
+        parser.OpenBuffer(attrdoc.data(), attrdoc.size());
+    }
+
+    if(failures)
+        printf("%d checks failed\n", failures);
+    return failures ? 1 : 0;
+}
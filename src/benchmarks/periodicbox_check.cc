@@ -0,0 +1,166 @@
+/*
+ * Copyright 2009-2014 The VOTCA Development Team (http://www.votca.org)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <stdio.h>
+#include <math.h>
+#include <vector>
+#include <algorithm>
+#include <votca/tools/periodicbox.h>
+#include <votca/tools/randomstream.h>
+
+using namespace votca::tools;
+
+/*
+ * Checks of PeriodicBox, run by ctest.
+ *
+ * usage: periodicbox_check
+ *
+ * For an open, an orthorhombic, a reduced triclinic and a strongly skewed
+ * triclinic box, random pairs of points spread over several cells are
+ * compared against a brute-force search over the neighbouring images.
+ * Whenever the shortest image is shorter than MaxCutoff, all kernels
+ * (scalar, pair and point versions, double and float) must find it.
+ * Longer displacements must still differ from the input by a lattice
+ * vector.
+ */
+
+static int failures = 0;
+
+static void check(bool ok, const char *what, int i = -1)
+{
+    if(ok) return;
+    if(i >= 0) printf("FAILED: %s (case %d)\n", what, i);
+    else printf("FAILED: %s\n", what);
+    ++failures;
+}
+
+/// shortest image of d, searched over the cells around the reduced d
+static vec brute_force_image(const matrix &box, const matrix &inverse, const vec &d)
+{
+    vec s = inverse*d;
+    vec base(floor(s.getX() + 0.5), floor(s.getY() + 0.5), floor(s.getZ() + 0.5));
+    vec best = d;
+    for(int i = -3; i <= 3; ++i)
+        for(int j = -3; j <= 3; ++j)
+            for(int k = -3; k <= 3; ++k) {
+                vec image = d - box*(base + vec(i, j, k));
+                if(abs(image) < abs(best))
+                    best = image;
+            }
+    return best;
+}
+
+/// true if d2 - d1 is a lattice vector
+static bool same_lattice(const matrix &inverse, const vec &d1, const vec &d2, double tol)
+{
+    vec s = inverse*(d2 - d1);
+    return fabs(s.getX() - floor(s.getX() + 0.5)) < tol
+        && fabs(s.getY() - floor(s.getY() + 0.5)) < tol
+        && fabs(s.getZ() - floor(s.getZ() + 0.5)) < tol;
+}
+
+template<typename T>
+static void check_box(const matrix &box, int boxid, double tol)
+{
+    PeriodicBox pbc(box);
+    matrix inverse;
+    if(pbc.getType() == PeriodicBox::typeOpen)
+        inverse.ZeroMatrix();
+    else {
+        inverse = box;
+        inverse.Invert();
+    }
+    const double cutoff = pbc.MaxCutoff();
+    // spread the points over a few cells, scaled by the longest box vector
+    double scale = 0;
+    for(int c = 0; c < 3; ++c)
+        scale = std::max(scale, abs(box.getCol(c)));
+    if(scale == 0) scale = 10;
+
+    const size_t n = 2000;
+    RandomStream rng(17, boxid);
+    VecArray_t<T> a(n), b(n);
+    for(size_t i = 0; i < n; ++i) {
+        a.set(i, vec_t<T>(vec(rng.rand_uniform(), rng.rand_uniform(), rng.rand_uniform())*2*scale));
+        // every fourth point is close to a, so short images are common
+        double r = (i % 4 == 0) ? std::min(cutoff, scale) : 2*scale;
+        b.set(i, a[i] + vec_t<T>(vec(rng.rand_uniform() - 0.5, rng.rand_uniform() - 0.5,
+                rng.rand_uniform() - 0.5)*2*r));
+    }
+    const vec_t<T> p = a[0];
+
+    VecArray_t<T> disp, pdisp, inplace(n);
+    std::vector<T> dist(n), dist2(n), pdist(n), pdist2(n);
+    pbc.Displacements(a, b, disp);
+    pbc.Distances(a, b, &dist[0]);
+    pbc.Distances2(a, b, &dist2[0]);
+    pbc.Displacements(p, b, pdisp);
+    pbc.Distances(p, b, &pdist[0]);
+    pbc.Distances2(p, b, &pdist2[0]);
+    for(size_t i = 0; i < n; ++i)
+        inplace.set(i, b[i] - a[i]);
+    pbc.MinimumImage(inplace);
+
+    int tested = 0;
+    for(size_t i = 0; i < n; ++i) {
+        int id = boxid*100000 + (int)i;
+        vec d = vec(b[i]) - vec(a[i]), pd = vec(b[i]) - vec(p);
+        vec best = brute_force_image(box, inverse, d), pbest = brute_force_image(box, inverse, pd);
+
+        if(abs(best) < cutoff*(1 - 1e-6)) {
+            ++tested;
+            check(abs(vec(disp[i]) - best) < tol, "Displacements is the shortest image", id);
+            check(abs(vec(inplace[i]) - best) < tol, "MinimumImage(VecArray) is the shortest image", id);
+            check(fabs(dist[i] - abs(best)) < tol, "Distances is the shortest distance", id);
+            check(fabs(dist2[i] - best*best) < tol*scale, "Distances2 is the shortest squared distance", id);
+            check(abs(pbc.MinimumImage(d) - best) < 1e-9*scale, "MinimumImage(vec) is the shortest image", id);
+            check(fabs(pbc.Distance(vec(a[i]), vec(b[i])) - abs(best)) < 1e-9*scale, "Distance is the shortest distance", id);
+        }
+        else
+            check(same_lattice(inverse, d, vec(disp[i]), tol/scale), "long displacement differs by a lattice vector", id);
+
+        if(abs(pbest) < cutoff*(1 - 1e-6)) {
+            check(abs(vec(pdisp[i]) - pbest) < tol, "point Displacements is the shortest image", id);
+            check(fabs(pdist[i] - abs(pbest)) < tol, "point Distances is the shortest distance", id);
+            check(fabs(pdist2[i] - pbest*pbest) < tol*scale, "point Distances2 is the shortest squared distance", id);
+        }
+    }
+    check(tested > (int)n/16, "enough pairs within MaxCutoff", boxid);
+}
+
+template<typename T>
+static void check_all(double tol)
+{
+    // open box, everything is within MaxCutoff
+    matrix open;
+    open.ZeroMatrix();
+    check_box<T>(open, 0, tol);
+    check_box<T>(matrix(vec(5, 0, 0), vec(0, 7, 0), vec(0, 0, 6)), 1, tol);
+    // GROMACS style reduced triclinic box
+    check_box<T>(matrix(vec(6, 0, 0), vec(2.5, 5, 0), vec(-1.5, 2, 5.5)), 2, tol);
+    // strongly skewed, not reduced
+    check_box<T>(matrix(vec(6, 0, 0), vec(5, 5, 0), vec(4, -4, 4)), 3, tol);
+}
+
+int main()
+{
+    check_all<double>(1e-9);
+    check_all<float>(1e-4);
+    if(failures)
+        printf("%d checks failed\n", failures);
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,212 @@
+/*
+ * Copyright 2009-2014 The VOTCA Development Team (http://www.votca.org)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <stdio.h>
+#include <math.h>
+#include <algorithm>
+#include <string>
+#include <vector>
+#include <votca/tools/quaternion.h>
+#include <votca/tools/randomstream.h>
+
+using namespace votca::tools;
+
+/*
+ * Checks of quaternion rotations, run by ctest.
+ *
+ * usage: quaternion_check
+ *
+ * matrix:  ToMatrix gives a proper rotation, FromMatrix inverts it (up to
+ *          the sign of q) for random rotations and for the half turns
+ *          which need the other branches of Shepperd's method
+ * rotate:  Rotate, composition and FromAxisAngle agree with the matrices,
+ *          the batched rotate agrees with Rotate
+ * slerp:   hits both ends, stays normalized and moves with constant
+ *          angular speed along the shorter arc, also for nearly parallel
+ *          and nearly opposite rotations
+ */
+
+static int failures = 0;
+
+static void check(bool ok, const std::string &what)
+{
+    if(ok) return;
+    printf("FAILED: %s\n", what.c_str());
+    ++failures;
+}
+
+static double max_diff(const matrix &a, const matrix &b)
+{
+    double m = 0;
+    for(int i = 0; i < 3; ++i)
+        for(int j = 0; j < 3; ++j)
+            m = std::max(m, fabs(a.get(i,j) - b.get(i,j)));
+    return m;
+}
+
+static double norm(const quaternion &q) { return q.norm(); }
+
+/// angle between q1 and q2 as 4d vectors, accurate also for small angles
+static double angle(const quaternion &q1, const quaternion &q2)
+{
+    return 2.*atan2(norm(q1 - q2), norm(q1 + q2));
+}
+
+/// distance of two quaternions describing the same rotation
+static double same_rotation(const quaternion &q1, const quaternion &q2)
+{
+    return std::min(norm(q1 - q2), norm(q1 + q2));
+}
+
+static std::vector<quaternion> test_rotations(RandomStream &rng)
+{
+    std::vector<quaternion> q;
+    q.push_back(quaternion::Identity());
+    // half turns have w = 0, FromMatrix has to use the x, y or z branch
+    q.push_back(quaternion(0, 1, 0, 0));
+    q.push_back(quaternion(0, 0, 1, 0));
+    q.push_back(quaternion(0, 0, 0, 1));
+    q.push_back(quaternion::FromAxisAngle(vec(1, 1, 0), M_PI));
+    q.push_back(quaternion::FromAxisAngle(vec(-1, 2, 3), M_PI - 1e-9));
+    q.push_back(quaternion::FromAxisAngle(vec(0, 0, 1), 1e-9));
+    for(int i = 0; i < 1000; ++i) {
+        quaternion r;
+        r.RandomRotation(rng);
+        q.push_back(r);
+    }
+    return q;
+}
+
+static void check_matrix(const std::vector<quaternion> &q, RandomStream &rng)
+{
+    bool proper = true, roundtrip = true, positive = true;
+    for(size_t i = 0; i < q.size(); ++i) {
+        matrix R = q[i].ToMatrix();
+        matrix Rt(R);
+        Rt.Transpose();
+        matrix unit;
+        unit.UnitMatrix();
+        double det = R.getRow(0) * (R.getRow(1) ^ R.getRow(2));
+        proper = proper && max_diff(R * Rt, unit) < 1e-14 && fabs(det - 1) < 1e-14;
+        quaternion back(R);
+        roundtrip = roundtrip && same_rotation(back, q[i]) < 1e-15;
+        positive = positive && back.getW() >= 0 && fabs(back.norm() - 1) < 1e-15;
+    }
+    check(proper, "ToMatrix gives a proper rotation");
+    check(roundtrip, "FromMatrix inverts ToMatrix");
+    check(positive, "FromMatrix gives w >= 0 and unit norm");
+
+    bool same = true;
+    for(int i = 0; i < 1000; ++i) {
+        matrix R;
+        R.RandomRotation(rng);
+        same = same && max_diff(quaternion(R).ToMatrix(), R) < 1e-14;
+    }
+    check(same, "matrix to quaternion and back");
+}
+
+static void check_rotate(const std::vector<quaternion> &q, RandomStream &rng)
+{
+    bool rotated = true, compose = true;
+    for(size_t i = 0; i + 1 < q.size(); ++i) {
+        vec v(rng.rand_uniform() - 0.5, rng.rand_uniform() - 0.5, rng.rand_uniform() - 0.5);
+        rotated = rotated && abs(q[i].Rotate(v) - q[i].ToMatrix() * v) < 1e-15;
+        compose = compose
+            && max_diff((q[i] * q[i+1]).ToMatrix(), q[i].ToMatrix() * q[i+1].ToMatrix()) < 1e-14
+            && same_rotation(q[i] * q[i].conjugate(), quaternion::Identity()) < 1e-15;
+    }
+    check(rotated, "Rotate agrees with the matrix");
+    check(compose, "composition agrees with the matrix product");
+
+    // a quarter turn around z maps x to y
+    quaternion z90 = quaternion::FromAxisAngle(vec(0, 0, 2), 0.5*M_PI);
+    check(abs(z90.Rotate(vec(1, 0, 0)) - vec(0, 1, 0)) < 1e-15, "FromAxisAngle");
+
+    VecArray v, out;
+    VecArray_t<float> vf, outf;
+    vec center(0.3, -1, 2);
+    for(int i = 0; i < 101; ++i) {
+        v.push_back(vec(rng.rand_uniform(), rng.rand_uniform(), rng.rand_uniform()));
+        vf.push_back(vec_t<float>(v[i]));
+    }
+    quaternion r = q.back();
+    bool same = true, same_f = true;
+    rotate(r, v, out);
+    for(size_t i = 0; i < v.size(); ++i)
+        same = same && abs(out[i] - r.Rotate(v[i])) < 1e-15;
+    rotate(r, center, v, out);
+    for(size_t i = 0; i < v.size(); ++i)
+        same = same && abs(out[i] - (center + r.Rotate(v[i] - center))) < 1e-14;
+    rotate(r, vf, outf);
+    for(size_t i = 0; i < vf.size(); ++i)
+        same_f = same_f && abs(vec(outf[i]) - r.Rotate(vec(vf[i]))) < 1e-6;
+    VecArray w(v);
+    rotate(r, w, w);
+    rotate(r, v, out);
+    for(size_t i = 0; i < v.size(); ++i)
+        same = same && abs(w[i] - out[i]) == 0;
+    check(same, "batched rotate agrees with Rotate");
+    check(same_f, "batched float rotate agrees with Rotate");
+}
+
+static void check_slerp_pair(const quaternion &q1, const quaternion &q2, const std::string &what)
+{
+    // the shorter arc ends at q2 or -q2
+    quaternion end = dot(q1, q2) < 0 ? q2*(-1.) : q2;
+    double total = angle(q1, end);
+    bool ends = norm(slerp(q1, q2, 0.) - q1) < 1e-15 && norm(slerp(q1, q2, 1.) - end) < 1e-15;
+    bool unit = true, speed = true;
+    for(int k = 0; k <= 16; ++k) {
+        double t = k/16.;
+        quaternion q = slerp(q1, q2, t);
+        unit = unit && fabs(q.norm() - 1) < 1e-15;
+        // the angle covered grows linearly with t, the remainder is left
+        speed = speed && fabs(angle(q1, q) - t*total) < 1e-14
+            && fabs(angle(q, end) - (1 - t)*total) < 1e-14;
+    }
+    check(ends, "slerp ends, " + what);
+    check(unit, "slerp stays normalized, " + what);
+    check(speed, "slerp has constant angular speed, " + what);
+}
+
+static void check_slerp(const std::vector<quaternion> &q)
+{
+    for(size_t i = 7; i + 1 < q.size(); i += 2)
+        check_slerp_pair(q[i], q[i+1], "random");
+    for(size_t i = 7; i < 100; ++i) {
+        const double small[] = { 1e-1, 1e-2, 1e-3, 1e-6, 1e-9 };
+        for(int k = 0; k < 5; ++k) {
+            quaternion step = quaternion::FromAxisAngle(q[i+1].getVector(), small[k]);
+            check_slerp_pair(q[i], q[i] * step, "nearly parallel");
+            check_slerp_pair(q[i], q[i] * step * (-1.), "nearly opposite");
+        }
+    }
+    check_slerp_pair(quaternion::Identity(), quaternion(0, 1, 0, 0), "half turn");
+    check_slerp_pair(q[100], q[100], "equal");
+}
+
+int main()
+{
+    RandomStream rng(23);
+    std::vector<quaternion> q = test_rotations(rng);
+    check_matrix(q, rng);
+    check_rotate(q, rng);
+    check_slerp(q);
+    if(failures)
+        printf("%d checks failed\n", failures);
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,93 @@
+/*
+ * Copyright 2009-2014 The VOTCA Development Team (http://www.votca.org)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <stdlib.h>
+#include <sys/time.h>
+#include <iostream>
+#include <vector>
+#include <boost/format.hpp>
+#include <votca/tools/random.h>
+#include <votca/tools/random2.h>
+#include <votca/tools/randomstream.h>
+
+using namespace votca::tools;
+
+/*
+ * Scalar calls against the bulk fill functions of the random generators.
+ *
+ * usage: random_benchmark [n]
+ */
+
+static double now()
+{
+    struct timeval tv;
+    gettimeofday(&tv, NULL);
+    return tv.tv_sec + 1e-6 * tv.tv_usec;
+}
+
+static void report(const char *name, size_t n, double t, const std::vector<double> &data)
+{
+    // print a checksum so the work cannot be optimized away
+    double sum = 0;
+    for(size_t i = 0; i < data.size(); ++i)
+        sum += data[i];
+    std::cout << boost::format("%-32s %8.3f s %10.1f M/s  (sum %g)\n")
+            % name % t % (n / t * 1e-6) % sum;
+}
+
+template<typename RNG>
+void run(const char *name, RNG &rng, size_t n)
+{
+    std::vector<double> data(n);
+    double start;
+
+    start = now();
+    for(size_t i = 0; i < n; ++i)
+        data[i] = rng.rand_uniform();
+    report((std::string(name) + " rand_uniform").c_str(), n, now() - start, data);
+
+    start = now();
+    rng.fill_uniform(&data[0], n);
+    report((std::string(name) + " fill_uniform").c_str(), n, now() - start, data);
+
+    start = now();
+    for(size_t i = 0; i < n; ++i)
+        data[i] = rng.rand_gaussian(1.0);
+    report((std::string(name) + " rand_gaussian").c_str(), n, now() - start, data);
+
+    start = now();
+    rng.fill_gaussian(&data[0], n, 1.0);
+    report((std::string(name) + " fill_gaussian").c_str(), n, now() - start, data);
+}
+
+int main(int argc, char **argv)
+{
+    size_t n = argc > 1 ? atol(argv[1]) : 10000000;
+    std::cout << n << " numbers per test\n";
+
+    Random::init(14, 122, 40, 4);
+    Random random;
+    run("Random", random, n);
+
+    Random2 random2;
+    random2.init(14, 122, 40, 4);
+    run("Random2", random2, n);
+
+    RandomStream stream(42);
+    run("RandomStream", stream, n);
+    return 0;
+}
@@ -0,0 +1,122 @@
+/*
+ * Copyright 2009-2014 The VOTCA Development Team (http://www.votca.org)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <vector>
+#include <votca/tools/randomstream.h>
+
+using namespace votca::tools;
+
+/*
+ * Checks of RandomStream, run by ctest.
+ *
+ * usage: random_check
+ *
+ * philox: known answers of Philox4x32-10 from the Random123 distribution
+ * fill:   the fill functions give the same numbers as the scalar calls,
+ *         for all lengths and start positions around the block sizes
+ * skip:   skip and seek agree with drawing the numbers
+ */
+
+static int failures = 0;
+
+static void check(bool ok, const char *what, int i = -1)
+{
+    if(ok) return;
+    if(i >= 0) printf("FAILED: %s (case %d)\n", what, i);
+    else printf("FAILED: %s\n", what);
+    ++failures;
+}
+
+static void check_philox()
+{
+    static const RandomStream::uint32_t kat[3][10] = {
+        // counter, key, result
+        { 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+          0x6627e8d5, 0xe169c58d, 0xbc57ac4c, 0x9b00dbd8 },
+        { 0xffffffff, 0xffffffff, 0xffffffff, 0xffffffff, 0xffffffff, 0xffffffff,
+          0x408f276d, 0x41c83b0e, 0xa20bc7c6, 0x6d5451fd },
+        { 0x243f6a88, 0x85a308d3, 0x13198a2e, 0x03707344, 0xa4093822, 0x299f31d0,
+          0xd16cfe09, 0x94fdcceb, 0x5001e420, 0x24126ea1 }
+    };
+    for(int i = 0; i < 3; ++i) {
+        RandomStream::uint32_t counter[4] = { kat[i][0], kat[i][1], kat[i][2], kat[i][3] };
+        RandomStream::uint32_t key[2] = { kat[i][4], kat[i][5] };
+        RandomStream::philox(counter, key);
+        check(counter[0] == kat[i][6] && counter[1] == kat[i][7]
+                && counter[2] == kat[i][8] && counter[3] == kat[i][9],
+                "philox known answer", i);
+    }
+}
+
+static void check_fill()
+{
+    for(int start = 0; start < 9; ++start) {
+        for(size_t n = 0; n < 70; ++n) {
+            RandomStream a(7, 3), b(7, 3);
+            a.skip(start);
+            b.skip(start);
+
+            std::vector<double> u(n + 1);
+            a.fill_uniform(&u[0], n);
+            bool same = true;
+            for(size_t i = 0; i < n; ++i)
+                same = same && u[i] == b.rand_uniform();
+            same = same && a.position() == b.position();
+            check(same, "fill_uniform equals rand_uniform", start*100 + n);
+
+            std::vector<int> k(n + 1);
+            a.fill_uniform_int(&k[0], n, 1000);
+            same = true;
+            for(size_t i = 0; i < n; ++i)
+                same = same && k[i] == b.rand_uniform_int(1000);
+            check(same, "fill_uniform_int equals rand_uniform_int", start*100 + n);
+
+            std::vector<double> g(n + 1);
+            a.fill_gaussian(&g[0], n, 2.0);
+            same = true;
+            for(size_t i = 0; i < n; ++i)
+                same = same && g[i] == b.rand_gaussian(2.0);
+            check(same, "fill_gaussian equals rand_gaussian", start*100 + n);
+        }
+    }
+}
+
+static void check_skip()
+{
+    RandomStream a(11, 5), b(11, 5), c(11, 5);
+    for(int i = 0; i < 1001; ++i)
+        a.rand_uint32();
+    b.skip(1001);
+    c.seek(1001);
+    RandomStream::uint32_t x = a.rand_uint32();
+    check(x == b.rand_uint32() && x == c.rand_uint32(), "skip and seek");
+
+    RandomStream s0(11, 0), s1(11, 1);
+    check(s0.rand_uint32() != s1.rand_uint32(), "streams differ");
+}
+
+int main()
+{
+    check_philox();
+    check_fill();
+    check_skip();
+    if(failures)
+        printf("%d checks failed\n", failures);
+    return failures ? 1 : 0;
+}
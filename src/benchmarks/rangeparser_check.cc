@@ -0,0 +1,156 @@
+/*
+ * Copyright 2009-2014 The VOTCA Development Team (http://www.votca.org)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <set>
+#include <vector>
+#include <stdexcept>
+#include <votca/tools/rangeparser.h>
+
+using namespace votca::tools;
+
+/*
+ * Checks of the set queries of RangeParser, run by ctest.
+ *
+ * usage: rangeparser_check
+ *
+ * random: random blocks (mixed strides, both directions, overlapping)
+ *         against a std::set of the selected indices
+ * edge:   ranges near the int limits, long strided ranges and invalid input
+ * split:  the chunks of Split cover the selection in order
+ */
+
+static int failures = 0;
+
+static void check(bool ok, const char *what, int i = -1)
+{
+    if(ok) return;
+    if(i >= 0) printf("FAILED: %s (case %d)\n", what, i);
+    else printf("FAILED: %s\n", what);
+    ++failures;
+}
+
+static void check_random()
+{
+    srand48(1);
+    for(int c = 0; c < 2000; ++c) {
+        RangeParser r;
+        std::set<int> ref;
+        int nblocks = 1 + (int)(4*drand48());
+        for(int b = 0; b < nblocks; ++b) {
+            int stride = 1 + (int)(5*drand48());
+            int begin = (int)(60*drand48()) - 20;
+            int end = begin + (int)(40*drand48());
+            if(drand48() < 0.5) {
+                r.Add(end, begin, -stride);
+                for(int k = end; k >= begin; k -= stride) ref.insert(k);
+            }
+            else {
+                r.Add(begin, end, stride);
+                for(int k = begin; k <= end; k += stride) ref.insert(k);
+            }
+        }
+
+        check(r.size() == ref.size(), "size", c);
+        if(r.size() != ref.size()) continue;
+        size_t i = 0;
+        bool ok = true;
+        for(std::set<int>::iterator k = ref.begin(); k != ref.end(); ++k, ++i)
+            ok = ok && r[i] == *k;
+        check(ok, "operator[]", c);
+        ok = true;
+        for(int k = -30; k < 90; ++k)
+            ok = ok && r.Contains(k) == (ref.count(k) > 0);
+        check(ok, "Contains", c);
+    }
+}
+
+static void check_edge()
+{
+    RangeParser all;
+    all.Parse("-2000000000:2000000000");
+    check(all.size() == 4000000001ULL, "size of a range wider than INT_MAX");
+    check(all[4000000000ULL] == 2000000000, "last index of a wide range");
+    check(all.Contains(-2000000000) && !all.Contains(2000000001), "Contains of a wide range");
+
+    // a long strided range is stored as one run, not enumerated
+    RangeParser strided;
+    strided.Parse("0:3:300000000");
+    check(strided.size() == 100000001, "size of a long strided range");
+    check(strided.Contains(299999997) && !strided.Contains(299999998), "Contains of a long strided range");
+    check(strided[100000000] == 300000000, "last index of a long strided range");
+
+    RangeParser wide_stride;
+    wide_stride.Parse("-2000000000:1000:2000000000,0:7:100");
+    check(wide_stride.size() == 4000001 + 14, "overlapping wide strided ranges");
+    check(wide_stride.Contains(14) && wide_stride.Contains(1000) && !wide_stride.Contains(15),
+            "Contains of overlapping wide strided ranges");
+
+    RangeParser down;
+    down.Parse("10:-1:-5");
+    check(down.size() == 16 && down[0] == -5 && down[15] == 10, "negative stride");
+
+    RangeParser empty;
+    check(empty.empty() && !empty.Contains(0), "empty range");
+
+    bool thrown = false;
+    try {
+        RangeParser bad;
+        bad.Parse("5:1");
+    }
+    catch(std::runtime_error &err) {
+        thrown = true;
+    }
+    check(thrown, "invalid range throws");
+
+    thrown = false;
+    try {
+        all[4000000001ULL];
+    }
+    catch(std::out_of_range &err) {
+        thrown = true;
+    }
+    check(thrown, "operator[] out of range throws");
+}
+
+static void check_split()
+{
+    RangeParser r;
+    r.Parse("0:2:20,5:9,100:-10:40,7");
+    for(size_t n = 1; n < 12; ++n) {
+        std::vector<RangeParser> chunks = r.Split(n);
+        size_t i = 0;
+        bool ok = chunks.size() == n;
+        for(size_t c = 0; c < chunks.size(); ++c) {
+            ok = ok && chunks[c].size() == (c + 1)*r.size()/n - c*r.size()/n;
+            for(size_t j = 0; j < chunks[c].size(); ++j, ++i)
+                ok = ok && chunks[c][j] == r[i];
+        }
+        check(ok && i == r.size(), "Split", n);
+    }
+}
+
+int main()
+{
+    check_random();
+    check_edge();
+    check_split();
+    if(failures)
+        printf("%d checks failed\n", failures);
+    return failures ? 1 : 0;
+}
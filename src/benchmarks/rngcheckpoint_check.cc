@@ -0,0 +1,248 @@
+/*
+ * Copyright 2009-2014 The VOTCA Development Team (http://www.votca.org)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <sstream>
+#include <stdexcept>
+#include <vector>
+#include <votca/tools/rngcheckpoint.h>
+#include <votca/tools/random.h>
+#include <votca/tools/random2.h>
+#include <votca/tools/randomstream.h>
+
+using namespace votca::tools;
+
+/*
+ * Checks of RNGCheckpoint, run by ctest.
+ *
+ * usage: rngcheckpoint_check
+ *
+ * roundtrip: every generator type continues its sequence exactly after a
+ *            restore, from memory and from a stream
+ * truncated: every prefix of a blob is rejected, from memory and from a
+ *            stream
+ * corrupt:   wrong magic, version, record counts, lengths and Marsaglia
+ *            indices are rejected
+ */
+
+static int failures = 0;
+
+static void check(bool ok, const char *what, int i = -1)
+{
+    if(ok) return;
+    if(i >= 0) printf("FAILED: %s (case %d)\n", what, i);
+    else printf("FAILED: %s\n", what);
+    ++failures;
+}
+
+/// offset of the first record's data in a blob
+static const size_t FIRST_RECORD = 16 + 8;
+
+static void put_u32(std::string &blob, size_t pos, unsigned int v)
+{
+    for(int i = 0; i < 4; ++i) blob[pos + i] = (char)((v >> (8*i)) & 0xff);
+}
+
+static bool read_throws(const std::string &blob)
+{
+    RNGCheckpoint cp;
+    try { cp.Read(blob.data(), blob.size()); }
+    catch(std::runtime_error &) { return true; }
+    return false;
+}
+
+static bool stream_read_throws(const std::string &blob)
+{
+    RNGCheckpoint cp;
+    std::istringstream in(blob);
+    try { cp.Read(in); }
+    catch(std::runtime_error &) { return true; }
+    return false;
+}
+
+/// read the blob and restore a Random2 from the first record
+static bool restore_throws(const std::string &blob)
+{
+    RNGCheckpoint cp;
+    Random2 rng;
+    try {
+        cp.Read(blob.data(), blob.size());
+        cp.Restore(rng);
+    }
+    catch(std::runtime_error &) { return true; }
+    return false;
+}
+
+static std::string make_blob()
+{
+    Random2 r2;
+    r2.init(12, 34, 56, 78);
+    std::vector<RandomStream> streams;
+    for(int i = 0; i < 4; ++i)
+        streams.push_back(RandomStream(5, i));
+    RNGCheckpoint cp;
+    cp.Store(r2);
+    cp.Store(RandomStream(3, 1));
+    cp.Store(streams);
+    return cp.ToString();
+}
+
+static void check_roundtrip()
+{
+    Random::init(12, 34, 56, 78);
+    Random2 r2;
+    r2.init(21, 43, 65, 87);
+    RandomStream s(9, 2);
+    std::vector<RandomStream> streams;
+    for(int i = 0; i < 3; ++i)
+        streams.push_back(RandomStream(4, i));
+    for(int i = 0; i < 10; ++i) {
+        Random::rand_uniform();
+        r2.rand_uniform();
+        streams[i % 3].rand_uniform();
+    }
+    // leaves a cached second gaussian in the stream
+    s.rand_gaussian(1.0);
+
+    RNGCheckpoint cp;
+    cp.StoreGlobalRandom();
+    cp.Store(r2);
+    cp.Store(s);
+    cp.Store(streams);
+    std::ostringstream out;
+    cp.Write(out);
+    std::string blob = cp.ToString();
+    check(out.str() == blob, "Write equals ToString");
+
+    double global = Random::rand_uniform(), marsaglia = r2.rand_uniform();
+    double gaussian = s.rand_gaussian(1.0), uniform = s.rand_uniform();
+    std::vector<double> next(streams.size());
+    for(size_t i = 0; i < streams.size(); ++i)
+        next[i] = streams[i].rand_uniform();
+
+    for(int from_stream = 0; from_stream < 2; ++from_stream) {
+        RNGCheckpoint in;
+        if(from_stream) {
+            // trailing data has to stay in the stream
+            std::istringstream is(blob + "tail");
+            in.Read(is);
+            std::string rest;
+            is >> rest;
+            check(rest == "tail", "stream is left after the blob");
+        }
+        else
+            check(in.Read(blob.data(), blob.size()) == blob.size(), "Read returns the blob size");
+
+        Random2 r;
+        RandomStream t;
+        std::vector<RandomStream> ts;
+        in.RestoreGlobalRandom();
+        in.Restore(r);
+        in.Restore(t);
+        in.Restore(ts);
+        check(Random::rand_uniform() == global, "global Random continues", from_stream);
+        check(r.rand_uniform() == marsaglia, "Random2 continues", from_stream);
+        check(t.rand_gaussian(1.0) == gaussian, "cached gaussian is restored", from_stream);
+        check(t.rand_uniform() == uniform, "RandomStream continues", from_stream);
+        bool same = ts.size() == streams.size();
+        for(size_t i = 0; same && i < ts.size(); ++i)
+            same = ts[i].rand_uniform() == next[i];
+        check(same, "stream set continues", from_stream);
+
+        bool thrown = false;
+        try { in.Restore(t); }
+        catch(std::runtime_error &) { thrown = true; }
+        check(thrown, "restoring past the last record throws", from_stream);
+    }
+
+    RNGCheckpoint cp2;
+    cp2.Store(s);
+    bool thrown = false;
+    try { cp2.Restore(r2); }
+    catch(std::runtime_error &) { thrown = true; }
+    check(thrown, "restoring a different type throws");
+}
+
+static void check_truncated()
+{
+    std::string blob = make_blob();
+    for(size_t n = 0; n < blob.size(); ++n) {
+        check(read_throws(blob.substr(0, n)), "truncated blob throws", n);
+        check(stream_read_throws(blob.substr(0, n)), "truncated stream throws", n);
+    }
+}
+
+static void check_corrupt()
+{
+    const std::string blob = make_blob();
+    std::string b;
+
+    b = blob; b[0] = 'X';
+    check(read_throws(b) && stream_read_throws(b), "wrong magic throws");
+    b = blob; put_u32(b, 8, 2);
+    check(read_throws(b) && stream_read_throws(b), "wrong version throws");
+    // a huge count must not allocate the records before reading them
+    b = blob; put_u32(b, 12, 0xffffffff);
+    check(read_throws(b) && stream_read_throws(b), "huge record count throws");
+    // the stream reader must not allocate the claimed length up front
+    b = blob; put_u32(b, FIRST_RECORD - 4, 0xfffffff0);
+    check(read_throws(b) && stream_read_throws(b), "huge record length throws");
+
+    check(!restore_throws(blob), "unmodified Marsaglia state restores");
+    int i = 0;
+    const unsigned int indices[] = { 0, 98, 0x80000000 };
+    for(int k = 0; k < 3; ++k) {
+        b = blob; put_u32(b, FIRST_RECORD, indices[k]);
+        check(restore_throws(b), "Marsaglia i out of range throws", i++);
+        b = blob; put_u32(b, FIRST_RECORD + 4, indices[k]);
+        check(restore_throws(b), "Marsaglia j out of range throws", i++);
+    }
+
+    // shorten the Marsaglia record by 8 bytes but keep the blob consistent
+    b = blob;
+    put_u32(b, FIRST_RECORD - 4, 816 - 8);
+    b.erase(FIRST_RECORD + 816 - 8, 8);
+    check(restore_throws(b), "short Marsaglia record throws");
+    b = blob;
+    put_u32(b, FIRST_RECORD - 4, 816 + 8);
+    b.insert(FIRST_RECORD + 816, 8, '\0');
+    check(restore_throws(b), "long Marsaglia record throws");
+
+    // the stream set claims more streams than it contains
+    RNGCheckpoint cp;
+    std::vector<RandomStream> streams(2);
+    cp.Store(streams);
+    b = cp.ToString();
+    put_u32(b, FIRST_RECORD, 1000000);
+    RNGCheckpoint in;
+    in.Read(b.data(), b.size());
+    bool thrown = false;
+    try { in.Restore(streams); }
+    catch(std::runtime_error &) { thrown = true; }
+    check(thrown && streams.size() == 2, "wrong stream count throws before resizing");
+}
+
+int main()
+{
+    check_roundtrip();
+    check_truncated();
+    check_corrupt();
+    if(failures)
+        printf("%d checks failed\n", failures);
+    return failures ? 1 : 0;
+}
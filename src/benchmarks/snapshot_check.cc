@@ -0,0 +1,123 @@
+/*
+ * Copyright 2009-2014 The VOTCA Development Team (http://www.votca.org)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <unistd.h>
+#include <utime.h>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <boost/filesystem.hpp>
+#include <votca/tools/property.h>
+#include <votca/tools/propertysnapshot.h>
+
+using namespace votca::tools;
+
+/*
+ * Checks of the snapshot cache of parsed XML files, run by ctest.
+ *
+ * usage: snapshot_check
+ *
+ * roundtrip:  a stored snapshot loads into the same tree
+ * invalidate: changed content (even with same size and time), size or
+ *             path never loads a stale snapshot
+ * load:       load_property_from_xml with VOTCA_PROPERTY_CACHE set sees
+ *             changes of the file
+ */
+
+static int failures = 0;
+
+static void check(bool ok, const char *what)
+{
+    if(ok) return;
+    printf("FAILED: %s\n", what);
+    ++failures;
+}
+
+static void write_file(const std::string &name, const std::string &content, time_t mtime = 0)
+{
+    std::ofstream out(name.c_str());
+    out << content;
+    out.close();
+    if(mtime) {
+        struct utimbuf times;
+        times.actime = times.modtime = mtime;
+        utime(name.c_str(), &times);
+    }
+}
+
+static std::string value(const std::string &file, const std::string &key)
+{
+    Property p;
+    load_property_from_xml(p, file);
+    return p.get(key).as<std::string>();
+}
+
+int main()
+{
+    namespace fs = boost::filesystem;
+    fs::path dir = fs::temp_directory_path() / fs::unique_path("snapshot_check-%%%%%%%%");
+    fs::create_directories(dir);
+    std::string xml = (dir / "test.xml").string();
+    PropertySnapshotCache cache((dir / "cache").string());
+
+    // roundtrip
+    const std::string doc = "<options><a x=\"1\"><b>one</b><b>two</b></a></options>";
+    write_file(xml, doc, 1000000000);
+    Property p;
+    load_property_from_xml_string(p, doc);
+    cache.Store(p, xml);
+    Property q;
+    check(cache.Load(q, xml), "load stored snapshot");
+    check(q.get("options.a.b").as<std::string>() == "two"
+            && q.get("options.a").getAttribute<int>("x") == 1
+            && q.Select("options.a.b").size() == 2, "snapshot content");
+
+    // same size and modification time, different content
+    write_file(xml, "<options><a x=\"1\"><b>one</b><b>TWO</b></a></options>", 1000000000);
+    Property r;
+    check(!cache.Load(r, xml) && r.size() == 0, "changed content invalidates");
+
+    // a snapshot tagged with the data it was parsed from does not match
+    // a file changed afterwards
+    snapshot_source_t source;
+    std::vector<char> content;
+    source.FromFile(xml, &content);
+    write_file(xml, doc, 1000000000);
+    cache.Store(p, source);
+    check(!cache.Load(r, xml), "snapshot of older data invalidates");
+
+    // different size
+    write_file(xml, "<options><a x=\"1\"><b>one</b></a></options>", 1000000000);
+    check(!cache.Load(r, xml), "changed size invalidates");
+
+    // load_property_from_xml uses the cache and sees changes
+    setenv("VOTCA_PROPERTY_CACHE", (dir / "default").string().c_str(), 1);
+    write_file(xml, "<options><b>1</b></options>", 1000000000);
+    check(value(xml, "options.b") == "1", "first load");
+    check(value(xml, "options.b") == "1", "cached load");
+    write_file(xml, "<options><b>2</b></options>", 1000000000);
+    check(value(xml, "options.b") == "2", "load after change");
+    check(PropertySnapshotCache::Default() != NULL
+            && fs::exists(PropertySnapshotCache::Default()->SnapshotFile(xml)), "snapshot written");
+
+    fs::remove_all(dir);
+    if(failures)
+        printf("%d checks failed\n", failures);
+    return failures ? 1 : 0;
+}
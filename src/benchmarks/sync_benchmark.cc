@@ -0,0 +1,235 @@
+/*
+ * Copyright 2009-2014 The VOTCA Development Team (http://www.votca.org)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <stdlib.h>
+#include <sys/time.h>
+#include <iostream>
+#include <deque>
+#include <vector>
+#include <boost/format.hpp>
+#include <votca/tools/thread.h>
+#include <votca/tools/mutex.h>
+#include <votca/tools/condition.h>
+#include <votca/tools/rwlock.h>
+#include <votca/tools/boundedqueue.h>
+
+using namespace votca::tools;
+
+/*
+ * Throughput of the synchronization primitives.
+ *
+ * usage: sync_benchmark [nproducers] [nitems]
+ *
+ * queue: nproducers threads push nitems integers each, the same number of
+ *        consumers pop them; compares a deque guarded by Mutex (polling,
+ *        as done so far), Mutex + Condition and the lock-free BoundedQueue
+ * locks: 4 threads doing 95% reads, 5% writes on a shared vector with
+ *        Mutex and RWLock
+ */
+
+static double now()
+{
+    struct timeval tv;
+    gettimeofday(&tv, NULL);
+    return tv.tv_sec + 1e-6 * tv.tv_usec;
+}
+
+/// deque guarded by a mutex, consumers poll
+class MutexQueue
+{
+public:
+    void Push(int v) {
+        ScopedLock lock(_mutex);
+        _queue.push_back(v);
+    }
+    void Pop(int &v) {
+        while(true) {
+            {
+                ScopedLock lock(_mutex);
+                if(!_queue.empty()) {
+                    v = _queue.front();
+                    _queue.pop_front();
+                    return;
+                }
+            }
+            sched_yield();
+        }
+    }
+private:
+    Mutex _mutex;
+    std::deque<int> _queue;
+};
+
+/// deque guarded by a mutex, consumers sleep on a condition
+class ConditionQueue
+{
+public:
+    void Push(int v) {
+        ScopedLock lock(_mutex);
+        _queue.push_back(v);
+        _nonempty.Signal();
+    }
+    void Pop(int &v) {
+        ScopedLock lock(_mutex);
+        while(_queue.empty())
+            _nonempty.Wait(_mutex);
+        v = _queue.front();
+        _queue.pop_front();
+    }
+private:
+    Mutex _mutex;
+    Condition _nonempty;
+    std::deque<int> _queue;
+};
+
+template<typename Queue>
+class Producer : public Thread
+{
+public:
+    Producer(Queue &queue, int n) : _queue(queue), _n(n) {}
+    void Run() { for(int i = 1; i <= _n; ++i) _queue.Push(i); }
+private:
+    Queue &_queue;
+    int _n;
+};
+
+template<typename Queue>
+class Consumer : public Thread
+{
+public:
+    Consumer(Queue &queue, int n) : _queue(queue), _n(n), _sum(0) {}
+    void Run() { int v; for(int i = 0; i < _n; ++i) { _queue.Pop(v); _sum += v; } }
+    long long Sum() const { return _sum; }
+private:
+    Queue &_queue;
+    int _n;
+    long long _sum;
+};
+
+template<typename Queue>
+void run_queue(const char *name, Queue &queue, int nthreads, int nitems)
+{
+    std::vector<Producer<Queue> *> producers;
+    std::vector<Consumer<Queue> *> consumers;
+    for(int i = 0; i < nthreads; ++i) {
+        producers.push_back(new Producer<Queue>(queue, nitems));
+        consumers.push_back(new Consumer<Queue>(queue, nitems));
+    }
+    double start = now();
+    for(int i = 0; i < nthreads; ++i) {
+        consumers[i]->Start();
+        producers[i]->Start();
+    }
+    long long sum = 0;
+    for(int i = 0; i < nthreads; ++i) {
+        producers[i]->WaitDone();
+        consumers[i]->WaitDone();
+        sum += consumers[i]->Sum();
+        delete producers[i];
+        delete consumers[i];
+    }
+    double t = now() - start;
+    long long expected = (long long)nthreads * nitems * (nitems + 1) / 2;
+    std::cout << boost::format("%-20s %8.3f s %12.0f items/s %s\n")
+            % name % t % (nthreads * (double)nitems / t)
+            % (sum == expected ? "" : "WRONG RESULT");
+}
+
+template<typename Lock>
+class Reader : public Thread
+{
+public:
+    Reader(Lock &lock, std::vector<int> &data, int n) : _lock(lock), _data(data), _n(n), _sum(0) {}
+    void Run();
+private:
+    Lock &_lock;
+    std::vector<int> &_data;
+    int _n;
+    long long _sum;
+};
+
+template<>
+void Reader<Mutex>::Run()
+{
+    for(int i = 0; i < _n; ++i) {
+        ScopedLock lock(_lock);
+        if(i % 20 == 0) _data[i % _data.size()]++;
+        else _sum += _data[i % _data.size()];
+    }
+}
+
+template<>
+void Reader<RWLock>::Run()
+{
+    for(int i = 0; i < _n; ++i) {
+        if(i % 20 == 0) {
+            ScopedWriteLock lock(_lock);
+            _data[i % _data.size()]++;
+        }
+        else {
+            ScopedReadLock lock(_lock);
+            _sum += _data[i % _data.size()];
+        }
+    }
+}
+
+template<typename Lock>
+void run_lock(const char *name, int nitems)
+{
+    const int nthreads = 4;
+    Lock lock;
+    std::vector<int> data(1024, 1);
+    std::vector<Reader<Lock> *> readers;
+    for(int i = 0; i < nthreads; ++i)
+        readers.push_back(new Reader<Lock>(lock, data, nitems));
+    double start = now();
+    for(int i = 0; i < nthreads; ++i)
+        readers[i]->Start();
+    for(int i = 0; i < nthreads; ++i) {
+        readers[i]->WaitDone();
+        delete readers[i];
+    }
+    double t = now() - start;
+    std::cout << boost::format("%-20s %8.3f s %12.0f ops/s\n")
+            % name % t % (nthreads * (double)nitems / t);
+}
+
+int main(int argc, char **argv)
+{
+    int nthreads = argc > 1 ? atoi(argv[1]) : 2;
+    int nitems = argc > 2 ? atoi(argv[2]) : 1000000;
+
+    std::cout << nthreads << " producers, " << nthreads << " consumers, "
+            << nitems << " items each\n";
+    {
+        MutexQueue queue;
+        run_queue("Mutex", queue, nthreads, nitems);
+    }
+    {
+        ConditionQueue queue;
+        run_queue("Mutex+Condition", queue, nthreads, nitems);
+    }
+    {
+        BoundedQueue<int> queue(1024);
+        run_queue("BoundedQueue", queue, nthreads, nitems);
+    }
+
+    std::cout << "\nshared data, 95% reads\n";
+    run_lock<Mutex>("Mutex", nitems);
+    run_lock<RWLock>("RWLock", nitems);
+    return 0;
+}
@@ -0,0 +1,284 @@
+/*
+ * Copyright 2009-2014 The VOTCA Development Team (http://www.votca.org)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <stdio.h>
+#include <time.h>
+#include <string>
+#include <vector>
+#include <votca/tools/boundedqueue.h>
+#include <votca/tools/rwlock.h>
+#include <votca/tools/thread.h>
+
+using namespace votca::tools;
+
+/*
+ * Checks of BoundedQueue and RWLock, run by ctest.
+ *
+ * usage: sync_check
+ *
+ * queue:   capacity is rounded up to a power of two, a full queue rejects
+ *          pushes, an empty one pops, order is FIFO across many wraps
+ * mpmc:    several producers and consumers, every item is popped exactly
+ *          once and each consumer sees the items of one producer in order
+ * readers: several readers hold the lock at the same time
+ * writers: a writer is alone, readers never see a half written pair
+ */
+
+static int failures = 0;
+
+static void check(bool ok, const std::string &what)
+{
+    if(ok) return;
+    printf("FAILED: %s\n", what.c_str());
+    ++failures;
+}
+
+static double now()
+{
+    timespec t;
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return t.tv_sec + 1e-9 * t.tv_nsec;
+}
+
+static void check_queue()
+{
+    check(BoundedQueue<int>(1).capacity() == 2 && BoundedQueue<int>(3).capacity() == 4
+            && BoundedQueue<int>(4).capacity() == 4 && BoundedQueue<int>(5).capacity() == 8,
+            "capacity is rounded up to a power of two");
+
+    BoundedQueue<int> queue(8);
+    int v = -1;
+    check(!queue.TryPop(v) && v == -1, "pop from an empty queue");
+    bool ok = true;
+    for(int i = 0; i < 8; ++i)
+        ok = ok && queue.TryPush(i);
+    check(ok && !queue.TryPush(8), "push into a full queue");
+    for(int i = 0; i < 8; ++i)
+        ok = ok && queue.TryPop(v) && v == i;
+    check(ok && !queue.TryPop(v), "queue drains in order");
+
+    // fill levels from 1 to capacity, wrapping the counters many times
+    int next_in = 0, next_out = 0;
+    for(int round = 0; round < 1000 && ok; ++round) {
+        int fill = 1 + round % 8;
+        for(int i = 0; i < fill; ++i)
+            ok = ok && queue.TryPush(next_in++);
+        for(int i = 0; i < fill; ++i)
+            ok = ok && queue.TryPop(v) && v == next_out++;
+        ok = ok && !queue.TryPop(v);
+    }
+    check(ok, "queue stays in order across wraps");
+}
+
+/// items are producer * nitems + sequence number
+class QueueProducer : public Thread
+{
+public:
+    QueueProducer(BoundedQueue<int> &queue, int id, int n) : _queue(queue), _id(id), _n(n) {}
+    void Run() { for(int i = 0; i < _n; ++i) _queue.Push(_id * _n + i); }
+
+private:
+    BoundedQueue<int> &_queue;
+    int _id;
+    int _n;
+};
+
+class QueueConsumer : public Thread
+{
+public:
+    QueueConsumer(BoundedQueue<int> &queue, std::vector<int> &seen, int nproducers, int nitems, int n)
+        : ordered(true), _queue(queue), _seen(seen), _last(nproducers, -1), _nitems(nitems), _n(n) {}
+    void Run();
+
+    bool ordered;
+
+private:
+    BoundedQueue<int> &_queue;
+    std::vector<int> &_seen;
+    std::vector<int> _last;
+    int _nitems;
+    int _n;
+};
+
+void QueueConsumer::Run()
+{
+    for(int i = 0; i < _n; ++i) {
+        int v;
+        _queue.Pop(v);
+        int producer = v / _nitems, seq = v % _nitems;
+        if(seq <= _last[producer]) ordered = false;
+        _last[producer] = seq;
+        __atomic_add_fetch(&_seen[v], 1, __ATOMIC_RELAXED);
+    }
+}
+
+static void check_mpmc()
+{
+    const int nthreads = 4, nitems = 100000;
+    // a small queue so that producers and consumers both have to wait
+    BoundedQueue<int> queue(16);
+    std::vector<int> seen(nthreads * nitems, 0);
+    std::vector<QueueProducer *> producers;
+    std::vector<QueueConsumer *> consumers;
+    for(int i = 0; i < nthreads; ++i) {
+        producers.push_back(new QueueProducer(queue, i, nitems));
+        consumers.push_back(new QueueConsumer(queue, seen, nthreads, nitems, nitems));
+    }
+    for(int i = 0; i < nthreads; ++i) {
+        consumers[i]->Start();
+        producers[i]->Start();
+    }
+    bool ordered = true;
+    for(int i = 0; i < nthreads; ++i) {
+        producers[i]->WaitDone();
+        consumers[i]->WaitDone();
+        ordered = ordered && consumers[i]->ordered;
+        delete producers[i];
+        delete consumers[i];
+    }
+    bool once = true;
+    for(size_t i = 0; i < seen.size(); ++i)
+        once = once && seen[i] == 1;
+    int v;
+    check(once, "every item is popped exactly once");
+    check(ordered, "items of one producer arrive in order");
+    check(!queue.TryPop(v), "queue is empty afterwards");
+}
+
+/// takes the read lock and waits until all readers hold it
+class ConcurrentReader : public Thread
+{
+public:
+    ConcurrentReader(RWLock &lock, int &inside, int n) : all(false), _lock(lock), _inside(inside), _n(n) {}
+    void Run();
+
+    bool all;
+
+private:
+    RWLock &_lock;
+    int &_inside;
+    int _n;
+};
+
+void ConcurrentReader::Run()
+{
+    ScopedReadLock lock(_lock);
+    __atomic_add_fetch(&_inside, 1, __ATOMIC_SEQ_CST);
+    double timeout = now() + 10;
+    while(!all && now() < timeout) {
+        all = __atomic_load_n(&_inside, __ATOMIC_SEQ_CST) == _n;
+        sched_yield();
+    }
+}
+
+static void check_readers()
+{
+    const int nthreads = 4;
+    RWLock lock;
+    int inside = 0;
+    std::vector<ConcurrentReader *> readers;
+    for(int i = 0; i < nthreads; ++i)
+        readers.push_back(new ConcurrentReader(lock, inside, nthreads));
+    for(int i = 0; i < nthreads; ++i)
+        readers[i]->Start();
+    bool all = true;
+    for(int i = 0; i < nthreads; ++i) {
+        readers[i]->WaitDone();
+        all = all && readers[i]->all;
+        delete readers[i];
+    }
+    check(all, "readers hold the lock at the same time");
+}
+
+struct shared_t {
+    RWLock lock;
+    // written in two steps, a reader must never see them differ
+    long a, b;
+    int readers, writers;
+    bool exclusive, consistent;
+};
+
+/// every 10th access writes, the others read
+class ReaderWriter : public Thread
+{
+public:
+    ReaderWriter(shared_t &shared, int n) : _shared(shared), _n(n) {}
+    void Run();
+
+private:
+    shared_t &_shared;
+    int _n;
+};
+
+void ReaderWriter::Run()
+{
+    for(int i = 0; i < _n; ++i) {
+        if(i % 10 == 0) {
+            ScopedWriteLock lock(_shared.lock);
+            int w = __atomic_add_fetch(&_shared.writers, 1, __ATOMIC_SEQ_CST);
+            if(w != 1 || __atomic_load_n(&_shared.readers, __ATOMIC_SEQ_CST) != 0)
+                _shared.exclusive = false;
+            long v = _shared.a + 1;
+            __atomic_store_n(&_shared.a, v, __ATOMIC_RELAXED);
+            sched_yield();
+            __atomic_store_n(&_shared.b, v, __ATOMIC_RELAXED);
+            __atomic_sub_fetch(&_shared.writers, 1, __ATOMIC_SEQ_CST);
+        }
+        else {
+            ScopedReadLock lock(_shared.lock);
+            __atomic_add_fetch(&_shared.readers, 1, __ATOMIC_SEQ_CST);
+            if(__atomic_load_n(&_shared.writers, __ATOMIC_SEQ_CST) != 0)
+                _shared.exclusive = false;
+            if(__atomic_load_n(&_shared.a, __ATOMIC_RELAXED)
+                    != __atomic_load_n(&_shared.b, __ATOMIC_RELAXED))
+                _shared.consistent = false;
+            __atomic_sub_fetch(&_shared.readers, 1, __ATOMIC_SEQ_CST);
+        }
+    }
+}
+
+static void check_writers()
+{
+    const int nthreads = 4, n = 20000;
+    shared_t shared;
+    shared.a = shared.b = 0;
+    shared.readers = shared.writers = 0;
+    shared.exclusive = shared.consistent = true;
+    std::vector<ReaderWriter *> threads;
+    for(int i = 0; i < nthreads; ++i)
+        threads.push_back(new ReaderWriter(shared, n));
+    for(int i = 0; i < nthreads; ++i)
+        threads[i]->Start();
+    for(int i = 0; i < nthreads; ++i) {
+        threads[i]->WaitDone();
+        delete threads[i];
+    }
+    check(shared.exclusive, "writers are exclusive");
+    check(shared.consistent, "readers never see a partial write");
+    check(shared.a == nthreads * (n / 10) && shared.b == shared.a, "no write is lost");
+}
+
+int main()
+{
+    check_queue();
+    check_mpmc();
+    check_readers();
+    check_writers();
+    if(failures)
+        printf("%d checks failed\n", failures);
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,178 @@
+/*
+ * Copyright 2009-2014 The VOTCA Development Team (http://www.votca.org)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <stdio.h>
+#include <math.h>
+#include <string.h>
+#include <string>
+#include <vector>
+#include <boost/tokenizer.hpp>
+#include <votca/tools/tokenizer.h>
+#include <votca/tools/randomstream.h>
+
+using namespace votca::tools;
+
+/*
+ * Checks of Tokenizer and parse_token, run by ctest.
+ *
+ * usage: tokenizer_check
+ *
+ * split:   random strings split the same as with boost::char_separator,
+ *          through all iterators and ToVector, empty tokens are skipped
+ * numbers: parse_token accepts and rejects the same input as
+ *          boost::lexical_cast and gives the same value, e.g. "1e5" is a
+ *          double but not an int and "0x1" is rejected
+ * convert: ConvertToVector converts all words or throws bad_lexical_cast
+ */
+
+static int failures = 0;
+
+static void check(bool ok, const std::string &what)
+{
+    if(ok) return;
+    printf("FAILED: %s\n", what.c_str());
+    ++failures;
+}
+
+static void check_split(const std::string &str, const char *separators)
+{
+    typedef boost::tokenizer<boost::char_separator<char> > boost_tokenizer;
+    boost::char_separator<char> sep(separators);
+    boost_tokenizer reference(str, sep);
+    std::vector<std::string> expected(reference.begin(), reference.end());
+
+    Tokenizer tok(str, separators);
+    std::vector<std::string> words;
+    tok.ToVector(words);
+    std::vector<boost::string_ref> views;
+    tok.ToVector(views);
+    std::vector<std::string> iterated(tok.begin(), tok.end());
+    std::vector<std::string> viewed;
+    for(Tokenizer::view_iterator i = tok.vbegin(); i != tok.vend(); ++i)
+        viewed.push_back(std::string(i->data(), i->size()));
+
+    bool same = words == expected && iterated == expected && viewed == expected
+        && views.size() == expected.size() && tok.size() == expected.size();
+    for(size_t i = 0; same && i < views.size(); ++i)
+        same = std::string(views[i].data(), views[i].size()) == expected[i];
+    check(same, "split of \"" + str + "\"");
+}
+
+static void check_splits()
+{
+    check_split("", " ");
+    check_split("   ", " ");
+    check_split("a", " ");
+    check_split("a,,b,", ",");
+    check_split(",a, b ,,c,", ", ");
+    check_split("one two\tthree\n", " \t\n");
+    check_split("\xff" "a" "\xfe" "b\xff", "\xff\xfe");
+
+    // random strings over a small alphabet, half of it separators
+    RandomStream rng(5);
+    const char alphabet[] = "ab, \t";
+    for(int i = 0; i < 2000; ++i) {
+        std::string s(rng.rand_uniform_int(20), ' ');
+        for(size_t k = 0; k < s.size(); ++k)
+            s[k] = alphabet[rng.rand_uniform_int(5)];
+        check_split(s, ", \t");
+    }
+}
+
+template<typename T>
+static void check_number(const char *str, const char *type)
+{
+    T expected = T(), v = T();
+    bool ok = true;
+    try { expected = boost::lexical_cast<T>(std::string(str)); }
+    catch(boost::bad_lexical_cast &) { ok = false; }
+    bool parsed = parse_token(boost::string_ref(str), v);
+    bool same = parsed == ok;
+    if(same && ok)
+        same = v == expected || (v != v && expected != expected);
+    check(same, std::string("parse_token<") + type + "> of \"" + str + "\" "
+            + (ok ? "as lexical_cast" : "rejected by lexical_cast"));
+}
+
+static void check_numbers()
+{
+    const char *inputs[] = {
+        "0", "1", "-1", "+1", "-0", "007", "1e5", "1E5", "1e-5", "-1.5e+3", ".5", "5.",
+        "1.5", "0x1", "0X1F", "1e", "1e+", "e5", "", " ", " 1", "1 ", "1,5", "1.2.3",
+        "--1", "+-1", "inf", "-inf", "infinity", "nan", "NaN", "2147483647",
+        "-2147483648", "2147483648", "-2147483649", "4294967295", "4294967296",
+        "9223372036854775807", "9223372036854775808", "1e308", "1e309", "4.9e-324",
+        "1e-400", "3.4028235e38", "3.5e38", "0.1", "123456789012345678901234567890",
+        "1a", "a1", "\t1", "1\n"
+    };
+    for(size_t i = 0; i < sizeof(inputs)/sizeof(inputs[0]); ++i) {
+        check_number<double>(inputs[i], "double");
+        check_number<float>(inputs[i], "float");
+        check_number<int>(inputs[i], "int");
+        check_number<unsigned int>(inputs[i], "unsigned int");
+        check_number<long>(inputs[i], "long");
+    }
+
+    // the view need not be zero terminated
+    double d = 0;
+    check(parse_token(boost::string_ref("1.25e2xyz", 6), d) && d == 125, "parse_token of a view");
+    int k = 0;
+    check(parse_token(boost::string_ref("123456", 2), k) && k == 12, "parse_token<int> of a view");
+
+    // random doubles round trip through their shortest representation
+    RandomStream rng(9);
+    bool same = true;
+    for(int i = 0; i < 10000 && same; ++i) {
+        double x = (rng.rand_uniform() - 0.5) * pow(10., rng.rand_uniform_int(40) - 20);
+        char buf[32];
+        snprintf(buf, sizeof(buf), "%.17g", x);
+        same = parse_token(boost::string_ref(buf), d) && d == x;
+    }
+    check(same, "random doubles round trip");
+}
+
+static void check_convert()
+{
+    std::vector<double> v;
+    Tokenizer("1 2.5  -3e2 ", " ").ConvertToVector(v);
+    check(v.size() == 3 && v[0] == 1 && v[1] == 2.5 && v[2] == -300, "ConvertToVector<double>");
+
+    std::vector<int> n;
+    bool thrown = false;
+    try { Tokenizer("1 0x1 3", " ").ConvertToVector(n); }
+    catch(boost::bad_lexical_cast &) { thrown = true; }
+    check(thrown, "ConvertToVector<int> of 0x1 throws");
+
+    thrown = false;
+    try { Tokenizer("1 1e5", " ").ConvertToVector(n); }
+    catch(boost::bad_lexical_cast &) { thrown = true; }
+    check(thrown, "ConvertToVector<int> of 1e5 throws");
+
+    std::vector<std::string> s;
+    Tokenizer("a,,b", ",").ConvertToVector(s);
+    check(s.size() == 2 && s[0] == "a" && s[1] == "b", "ConvertToVector<string> skips empty words");
+}
+
+int main()
+{
+    check_splits();
+    check_numbers();
+    check_convert();
+    if(failures)
+        printf("%d checks failed\n", failures);
+    return failures ? 1 : 0;
+}
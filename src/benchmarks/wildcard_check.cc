@@ -0,0 +1,128 @@
+/*
+ * Copyright 2009-2014 The VOTCA Development Team (http://www.votca.org)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <stdio.h>
+#include <string>
+#include <vector>
+#include <votca/tools/wildcard.h>
+#include <votca/tools/tokenizer.h>
+
+using namespace votca::tools;
+
+/*
+ * Checks of WildcardPattern, run by ctest.
+ *
+ * usage: wildcard_check
+ *
+ * exhaustive: every pattern over "ab?*" up to 6 characters against every
+ *             string over "abc" up to 7 characters gives the same answer
+ *             as wildcmp, through all Match overloads
+ * names:      typical selection patterns against typical names
+ * recompile:  Compile replaces the previous pattern completely
+ */
+
+static int failures = 0;
+
+static void check(bool ok, const std::string &what)
+{
+    if(ok) return;
+    printf("FAILED: %s\n", what.c_str());
+    ++failures;
+}
+
+/// all strings over the alphabet with up to max characters
+static std::vector<std::string> all_strings(const std::string &alphabet, size_t max)
+{
+    std::vector<std::string> out(1, "");
+    for(size_t begin = 0, len = 1; len <= max; ++len) {
+        size_t end = out.size();
+        for(size_t i = begin; i < end; ++i)
+            for(size_t k = 0; k < alphabet.size(); ++k)
+                out.push_back(out[i] + alphabet[k]);
+        begin = end;
+    }
+    return out;
+}
+
+static bool has_wildcard(const std::string &s)
+{
+    return s.find_first_of("*?") != std::string::npos;
+}
+
+static void check_pattern(const WildcardPattern &pattern, const std::string &str)
+{
+    bool expected = wildcmp(pattern.pattern().c_str(), str.c_str()) != 0;
+    bool same = pattern.Match(str) == expected
+        && pattern.Match(str.c_str()) == expected
+        && pattern.Match(str.data(), str.size()) == expected;
+    check(same, "\"" + pattern.pattern() + "\" against \"" + str + "\"");
+}
+
+static void check_exhaustive()
+{
+    std::vector<std::string> patterns = all_strings("ab?*", 6);
+    std::vector<std::string> strings = all_strings("abc", 7);
+    for(size_t p = 0; p < patterns.size(); ++p) {
+        WildcardPattern pattern(patterns[p]);
+        check(pattern.IsLiteral() == !has_wildcard(patterns[p]),
+                "IsLiteral of \"" + patterns[p] + "\"");
+        for(size_t s = 0; s < strings.size(); ++s)
+            check_pattern(pattern, strings[s]);
+    }
+}
+
+static void check_names()
+{
+    const char *patterns[] = {
+        "", "*", "**", "bond", "bond*", "*bond", "*bond*", "bond?", "b*d",
+        "cg.*.bond", "cg.non-bonded.*", "?*?", "*.*", "options.*.method",
+        "a*b*c*d", "*x*"
+    };
+    const char *names[] = {
+        "", "bond", "bonds", "bond1", "angle", "cg.non-bonded.name",
+        "cg.bonded.bond", "cg..bond", "options.cg.method", "options.method",
+        "abcd", "aXbXcXd", "ab", "x", ".", "bbond", "bondbond"
+    };
+    for(size_t p = 0; p < sizeof(patterns)/sizeof(patterns[0]); ++p) {
+        WildcardPattern pattern(patterns[p]);
+        for(size_t n = 0; n < sizeof(names)/sizeof(names[0]); ++n)
+            check_pattern(pattern, names[n]);
+    }
+}
+
+static void check_recompile()
+{
+    WildcardPattern pattern;
+    check(pattern.Match("") && !pattern.Match("a") && pattern.IsLiteral(), "default pattern");
+    pattern.Compile("a*?b");
+    check(pattern.Match("axb") && !pattern.Match("ab") && !pattern.IsLiteral(), "a*?b");
+    pattern.Compile("ab");
+    check(pattern.Match("ab") && !pattern.Match("axb") && pattern.IsLiteral()
+            && pattern.pattern() == "ab", "recompiled to ab");
+    // a length given explicitly need not end at a terminator
+    check(pattern.Match("abc", 2) && !pattern.Match("abc", 3), "Match of a prefix");
+}
+
+int main()
+{
+    check_exhaustive();
+    check_names();
+    check_recompile();
+    if(failures)
+        printf("%d checks failed\n", failures);
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,214 @@
+/*
+ * Copyright 2009-2014 The VOTCA Development Team (http://www.votca.org)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <boost/filesystem.hpp>
+#include <boost/utility/string_ref.hpp>
+#include <votca/tools/property.h>
+#include <votca/tools/compactproperty.h>
+#include <votca/tools/parsexml.h>
+
+using namespace votca::tools;
+
+/*
+ * Checks of the block-wise and in-memory XML loading, run by ctest.
+ *
+ * usage: xmlparse_check
+ *
+ * same:   files spanning several 1 MB blocks, ending exactly on a block
+ *         boundary or being tiny give the same tree when loaded from the
+ *         file and from memory, with Property, CompactProperty and ParseXML
+ * errors: malformed, truncated, empty and missing documents throw from
+ *         both paths
+ */
+
+static int failures = 0;
+
+static void check(bool ok, const std::string &what)
+{
+    if(ok) return;
+    printf("FAILED: %s\n", what.c_str());
+    ++failures;
+}
+
+static bool same(Property &a, Property &b)
+{
+    if(a.name() != b.name() || a.value() != b.value() || a.path() != b.path()
+            || a.size() != b.size())
+        return false;
+    Property::AttributeIterator x = a.firstAttribute(), y = b.firstAttribute();
+    for(; x != a.lastAttribute() && y != b.lastAttribute(); ++x, ++y)
+        if(x->first != y->first || x->second != y->second)
+            return false;
+    if(x != a.lastAttribute() || y != b.lastAttribute())
+        return false;
+    Property::iterator i = a.begin(), j = b.begin();
+    for(; i != a.end(); ++i, ++j)
+        if(!same(*i, *j))
+            return false;
+    return true;
+}
+
+/// counts elements and sums the n attributes
+class Counter
+{
+public:
+    Counter(ParseXML &parser) : elements(0), sum(0), _parser(parser) {}
+
+    void Element(const boost::string_ref &, const XMLAttributes &attr) {
+        ++elements;
+        if(attr.has("n"))
+            sum += attr.get<long>("n");
+        _parser.NextHandler(this, &Counter::Element);
+    }
+
+    long elements, sum;
+
+private:
+    ParseXML &_parser;
+};
+
+static void count_file(const std::string &file, long &elements, long &sum)
+{
+    ParseXML parser;
+    Counter c(parser);
+    parser.NextHandler(&c, &Counter::Element);
+    parser.Open(file);
+    elements = c.elements;
+    sum = c.sum;
+}
+
+static void count_buffer(const std::string &doc, long &elements, long &sum)
+{
+    ParseXML parser;
+    Counter c(parser);
+    parser.NextHandler(&c, &Counter::Element);
+    parser.OpenBuffer(doc.data(), doc.size());
+    elements = c.elements;
+    sum = c.sum;
+}
+
+/// document with n items, padded with spaces to size bytes if size is given
+static std::string make_doc(int n, size_t size = 0)
+{
+    std::ostringstream out;
+    out << "<options>\n";
+    for(int i = 0; i < n; ++i)
+        out << "  <item n=\"" << i << "\" name=\"item" << i << "\"><value>" << 0.5*i
+            << "</value><text>some text to fill the block " << i << "</text></item>\n";
+    std::string doc = out.str() + "</options>\n";
+    if(size > doc.size())
+        doc.insert(doc.size() - 1, size - doc.size(), ' ');
+    return doc;
+}
+
+static void write_file(const std::string &file, const std::string &content)
+{
+    std::ofstream out(file.c_str(), std::ios::binary);
+    out << content;
+}
+
+static void check_same(const std::string &file, const std::string &doc, const std::string &what)
+{
+    write_file(file, doc);
+
+    Property pf, pb;
+    load_property_from_xml(pf, file);
+    load_property_from_xml_string(pb, doc);
+    check(same(pf, pb), what + ": Property from file and memory agree");
+
+    CompactProperty cf;
+    load_compact_property_from_xml(cf, file);
+    CompactProperty cb(pb);
+    check(cf.size() == cb.size(), what + ": CompactProperty from file has all nodes");
+    Property back;
+    cf.root().ToProperty(back);
+    check(same(back, pb), what + ": CompactProperty from file agrees");
+
+    long ef, sf, eb, sb;
+    count_file(file, ef, sf);
+    count_buffer(doc, eb, sb);
+    check(ef == eb && sf == sb, what + ": ParseXML Open and OpenBuffer agree");
+    check(ef == (long)pb.Select("options.item").size()*3 + 1,
+            what + ": ParseXML sees every element");
+}
+
+static bool throws_file(const std::string &file)
+{
+    Property p;
+    try { load_property_from_xml(p, file); }
+    catch(std::exception &) {
+        long e, s;
+        try { count_file(file, e, s); }
+        catch(std::exception &) { return true; }
+    }
+    return false;
+}
+
+static bool throws_buffer(const std::string &doc)
+{
+    Property p;
+    try { load_property_from_xml_string(p, doc); }
+    catch(std::exception &) {
+        long e, s;
+        try { count_buffer(doc, e, s); }
+        catch(std::exception &) { return true; }
+    }
+    return false;
+}
+
+int main()
+{
+    // loading must not go through a snapshot cache
+    unsetenv("VOTCA_PROPERTY_CACHE");
+
+    namespace fs = boost::filesystem;
+    fs::path dir = fs::temp_directory_path() / fs::unique_path("xmlparse_check-%%%%%%%%");
+    fs::create_directories(dir);
+    std::string file = (dir / "test.xml").string();
+
+    check_same(file, make_doc(3), "small");
+    check_same(file, make_doc(30000), "several blocks");
+    check_same(file, make_doc(7000, 1 << 20), "exactly one block");
+    check_same(file, make_doc(15000, 2 << 20), "exactly two blocks");
+    check(fs::file_size(file) == (2 << 20), "padded file has two blocks");
+
+    const std::string bad[] = {
+        "",
+        "<options><a></options>",
+        "<options><a>1</a>",
+        make_doc(30000).substr(0, 1500000),
+        "<options></options><second/>"
+    };
+    for(int i = 0; i < 5; ++i) {
+        write_file(file, bad[i]);
+        std::ostringstream what;
+        what << "malformed document " << i;
+        check(throws_file(file), what.str() + " throws from file");
+        check(throws_buffer(bad[i]), what.str() + " throws from memory");
+    }
+    check(throws_file((dir / "missing.xml").string()), "missing file throws");
+
+    fs::remove_all(dir);
+    if(failures)
+        printf("%d checks failed\n", failures);
+    return failures ? 1 : 0;
+}
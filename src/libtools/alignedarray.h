@@ -0,0 +1,93 @@
+/*
+ * Copyright 2009-2014 The VOTCA Development Team (http://www.votca.org)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#ifndef _VOTCA_TOOLS_ALIGNEDARRAY_H
+#define	_VOTCA_TOOLS_ALIGNEDARRAY_H
+
+#include <stdlib.h>
+#include <string.h>
+#include <new>
+#include <stdexcept>
+
+namespace votca { namespace tools {
+
+/// alignment of the component arrays of VecArray and MatrixArray (one cache line)
+const size_t ARRAY_ALIGNMENT = 64;
+
+/// round n up, so arrays of n elements of type T placed one after another stay aligned
+template<typename T>
+inline size_t aligned_size(size_t n)
+{
+    const size_t per_line = ARRAY_ALIGNMENT / sizeof(T);
+    return (n + per_line - 1) / per_line * per_line;
+}
+
+/**
+ * \brief (re)allocate ncomponents aligned arrays in one block
+ * @param components pointers to the arrays, updated
+ * @param ncomponents number of arrays
+ * @param size number of elements to keep
+ * @param capacity old capacity, updated to the new one (at least n)
+ * @param n requested capacity
+ *
+ * The block is owned by components[0] and has to be released with free.
+ */
+template<typename T>
+inline void aligned_reserve(T **components, int ncomponents, size_t size,
+        size_t &capacity, size_t n)
+{
+    if(n <= capacity) return;
+    size_t newcapacity = aligned_size<T>(n);
+    void *mem;
+    if(posix_memalign(&mem, ARRAY_ALIGNMENT, ncomponents*newcapacity*sizeof(T)) != 0)
+        throw std::bad_alloc();
+    T *block = (T *)mem;
+    for(int c = 0; c < ncomponents; ++c) {
+        if(size > 0)
+            memcpy(block + c*newcapacity, components[c], size*sizeof(T));
+    }
+    free(components[0]);
+    for(int c = 0; c < ncomponents; ++c)
+        components[c] = block + c*newcapacity;
+    capacity = newcapacity;
+}
+
+/// tell the compiler that p is aligned to ARRAY_ALIGNMENT
+template<typename T>
+inline T *assume_aligned(T *p)
+{
+    return (T *)__builtin_assume_aligned(p, ARRAY_ALIGNMENT);
+}
+
+/*
+ * The kernels over these arrays read all inputs of element i into locals
+ * before they write element i of the output, so they may work in place,
+ * and different i never overlap. GCC ignores restrict on local pointers
+ * and gives up its runtime overlap checks for many arrays, the loops are
+ * therefore marked with #pragma GCC ivdep.
+ */
+
+/// \brief throw invalid_argument if the arrays have different sizes
+inline void check_size(size_t a, size_t b)
+{
+    if(a != b)
+        throw std::invalid_argument("array sizes do not match");
+}
+
+}}
+
+#endif	/* _VOTCA_TOOLS_ALIGNEDARRAY_H */
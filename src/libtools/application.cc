@@ -16,10 +16,13 @@
  */
 
 #include <iostream>
+#include <unistd.h>
 #include <votca/tools/application.h>
 #include <votca/tools/version.h>
 #include <votca/tools/globals.h>
 #include <votca/tools/propertyiomanipulator.h>
+#include <votca/tools/thread.h>
+#include <votca/tools/calculator.h>
 
 #include <boost/format.hpp>
 #include <boost/algorithm/string/replace.hpp>
@@ -28,7 +31,8 @@
 namespace votca { namespace tools {
 
 Application::Application()
-    : _op_desc("Allowed options"), _continue_execution(true)
+    : _op_desc("Allowed options"), _continue_execution(true),
+      _nthreads(1), _stop(false)
 {
 }
 
@@ -109,11 +113,24 @@ void Application::ShowTEXPage(std::ostream &out) {
 }
 
 int Application::Exec(int argc, char **argv)
+{
+    return Execute(argc, argv, false);
+}
+
+int Application::ExecThreaded(int argc, char **argv)
+{
+    return Execute(argc, argv, true);
+}
+
+int Application::Execute(int argc, char **argv, bool threaded)
 {
     try {
         //_continue_execution = true;
 	AddProgramOptions()("help,h", "  display this help and exit");
 	AddProgramOptions()("verbose,v", "  be loud and noisy");
+        if (threaded)
+            AddProgramOptions()("nthreads", boost::program_options::value<int>()->default_value(1),
+                "  number of threads, 0 for one per core");
 	AddProgramOptions("Hidden")("man", "  output man-formatted manual pages");
 	AddProgramOptions("Hidden")("tex", "  output tex-formatted manual pages");
 	
@@ -124,6 +141,14 @@ int Application::Exec(int argc, char **argv)
         if (_op_vm.count("verbose")) {
 	  globals::verbose = true;
         }
+
+        if (threaded) {
+            _nthreads = _op_vm["nthreads"].as<int>();
+            if (_nthreads == 0)
+                _nthreads = std::max(1L, sysconf(_SC_NPROCESSORS_ONLN));
+            if (_nthreads < 0)
+                throw runtime_error("number of threads must not be negative");
+        }
         
         if (_op_vm.count("man")) {
             ShowManPage(cout);
@@ -145,8 +170,10 @@ int Application::Exec(int argc, char **argv)
             return -1;
         }
 
-        if(_continue_execution)
-            Run();
+        if(_continue_execution) {
+            if (threaded) RunThreaded();
+            else Run();
+        }
 	else cout << "nothing to be done - stopping here\n";
     }
     catch(std::exception &error) {
@@ -156,6 +183,99 @@ int Application::Exec(int argc, char **argv)
     return 0;
 }
 
+namespace {
+
+/// thread of the default RunThreaded, calls Application::RunWorker
+class ApplicationWorker : public Thread
+{
+public:
+    ApplicationWorker(Application *app, int id) : _app(app), _id(id), _failed(false) {}
+
+    void Run() {
+        try {
+            _app->RunWorker(_id);
+        }
+        catch(std::exception &error) {
+            _failed = true;
+            _error = error.what();
+            _app->RequestStop();
+        }
+        catch(...) {
+            _failed = true;
+            _error = "unknown exception in worker thread";
+            _app->RequestStop();
+        }
+    }
+
+    bool Failed() const { return _failed; }
+    /// \brief message of the exception thrown by RunWorker
+    const string &Error() const { return _error; }
+
+private:
+    Application *_app;
+    int _id;
+    bool _failed;
+    string _error;
+};
+
+}
+
+void Application::RunThreaded()
+{
+    {
+        ScopedLock lock(_stop_mutex);
+        _stop = false;
+    }
+
+    std::vector<ApplicationWorker *> workers;
+    for (int id = 0; id < NumberOfThreads(); ++id)
+        workers.push_back(new ApplicationWorker(this, id));
+
+    // if starting a thread fails, stop and wait for the ones running
+    size_t started = 0;
+    bool failed = false;
+    string error;
+    try {
+        for (; started < workers.size(); ++started)
+            workers[started]->Start();
+    }
+    catch(std::exception &e) {
+        failed = true;
+        error = e.what();
+        RequestStop();
+    }
+
+    for (size_t i = 0; i < started; ++i) {
+        workers[i]->WaitDone();
+        if (!failed && workers[i]->Failed()) {
+            failed = true;
+            error = workers[i]->Error();
+        }
+    }
+    for (size_t i = 0; i < workers.size(); ++i)
+        delete workers[i];
+
+    if (failed)
+        throw runtime_error(error);
+}
+
+void Application::RequestStop()
+{
+    ScopedLock lock(_stop_mutex);
+    _stop = true;
+}
+
+bool Application::StopRequested()
+{
+    ScopedLock lock(_stop_mutex);
+    return _stop;
+}
+
+void Application::ConfigureCalculator(votca::ctp::Calculator *calculator)
+{
+    calculator->setnThreads(NumberOfThreads());
+}
+
 boost::program_options::options_description_easy_init
     Application::AddProgramOptions(const string &group)
 {
@@ -193,8 +313,10 @@ void Application::ParseCommandLine(int argc, char **argv)
     
     // parse the command line
     try {
-        po::store(po::parse_command_line(argc, argv, _op_desc), _op_vm);
+        po::parsed_options parsed = po::parse_command_line(argc, argv, _op_desc);
+        po::store(parsed, _op_vm);
         po::notify(_op_vm);
+        _op_parsed = parsed.options;
     }
     catch(boost::program_options::error err) {
         throw runtime_error(string("error parsing command line: ") + err.what());
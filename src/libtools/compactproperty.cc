@@ -0,0 +1,445 @@
+/*
+ * Copyright 2009-2014 The VOTCA Development Team (http://www.votca.org)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <string.h>
+#include <expat.h>
+#include <stdexcept>
+#include <votca/tools/compactproperty.h>
+#include <votca/tools/tokenizer.h>
+#include <votca/tools/wildcard.h>
+#include "xmlbuffer.h"
+
+namespace votca { namespace tools {
+
+const StringPool::id_t StringPool::npos;
+
+StringPool::StringPool()
+{
+    clear();
+}
+
+void StringPool::clear()
+{
+    _chars.clear();
+    _offsets.clear();
+    _offsets.push_back(0);
+    _table.assign(64, npos);
+}
+
+void StringPool::shrink()
+{
+    vector<char>(_chars).swap(_chars);
+    vector<size_t>(_offsets).swap(_offsets);
+}
+
+size_t StringPool::MemoryUsage() const
+{
+    return _chars.capacity()*sizeof(char) + _offsets.capacity()*sizeof(size_t)
+        + _table.capacity()*sizeof(id_t);
+}
+
+size_t StringPool::Hash(const char *str, size_t len)
+{
+    // FNV-1a
+    size_t h = 2166136261u;
+    for(size_t i=0; i<len; ++i) {
+        h ^= (unsigned char)str[i];
+        h *= 16777619u;
+    }
+    return h;
+}
+
+StringPool::id_t StringPool::Find(const char *str, size_t len) const
+{
+    size_t mask = _table.size() - 1;
+    for(size_t slot = Hash(str, len) & mask; ; slot = (slot + 1) & mask) {
+        id_t id = _table[slot];
+        if(id == npos)
+            return npos;
+        if(length(id) == len && memcmp(c_str(id), str, len) == 0)
+            return id;
+    }
+}
+
+StringPool::id_t StringPool::Intern(const char *str, size_t len)
+{
+    id_t id = Find(str, len);
+    if(id != npos)
+        return id;
+
+    id = size();
+    _chars.insert(_chars.end(), str, str + len);
+    _chars.push_back('\0');
+    _offsets.push_back(_chars.size());
+
+    // keep the load factor below 1/2
+    if(2*size() > _table.size())
+        Rehash(2*_table.size());
+    else {
+        size_t mask = _table.size() - 1;
+        size_t slot = Hash(str, len) & mask;
+        while(_table[slot] != npos)
+            slot = (slot + 1) & mask;
+        _table[slot] = id;
+    }
+    return id;
+}
+
+void StringPool::Rehash(size_t nslots)
+{
+    _table.assign(nslots, npos);
+    size_t mask = nslots - 1;
+    for(id_t id=0; id<size(); ++id) {
+        size_t slot = Hash(c_str(id), length(id)) & mask;
+        while(_table[slot] != npos)
+            slot = (slot + 1) & mask;
+        _table[slot] = id;
+    }
+}
+
+/**
+ * \brief helper to assemble a CompactProperty
+ *
+ * Nodes are first collected in depth first order as a linked tree and
+ * then relayed out in breadth first order, which puts the childs of
+ * every node into a contiguous range.
+ */
+class CompactPropertyBuilder
+{
+public:
+    static const unsigned int none = ~0u;
+
+    CompactPropertyBuilder(CompactProperty &tree);
+
+    /// add a node below parent, returns its index
+    unsigned int AddNode(unsigned int parent, const char *name, size_t len);
+    void SetValue(unsigned int node, const char *value, size_t len);
+    void AddAttribute(unsigned int node, const char *name, const char *value);
+    /// copy a Property (recursively) below parent
+    void AddProperty(unsigned int node, Property &p);
+
+    /// move the collected nodes into the tree
+    void Finish();
+
+private:
+    struct stage_t {
+        CompactProperty::id_t name, path, value, child_path;
+        unsigned int parent, first_child, last_child, next_sibling, nchilds;
+        unsigned int first_attribute, nattributes;
+    };
+
+    CompactProperty &_tree;
+    vector<stage_t> _stage;
+    string _buffer;
+
+    CompactProperty::id_t ChildPath(unsigned int node);
+};
+
+const unsigned int CompactPropertyBuilder::none;
+
+CompactPropertyBuilder::CompactPropertyBuilder(CompactProperty &tree)
+    : _tree(tree)
+{
+    _tree._nodes.clear();
+    _tree._attributes.clear();
+    _tree._names.clear();
+    _tree._values.clear();
+
+    stage_t root;
+    root.name = root.path = _tree._names.Intern("", 0);
+    root.value = _tree._values.Intern("", 0);
+    root.child_path = none;
+    root.parent = 0;
+    root.first_child = root.last_child = root.next_sibling = none;
+    root.nchilds = root.first_attribute = root.nattributes = 0;
+    _stage.push_back(root);
+}
+
+CompactProperty::id_t CompactPropertyBuilder::ChildPath(unsigned int node)
+{
+    // all childs share the same path, so it is only assembled once
+    stage_t &s = _stage[node];
+    if(s.child_path == none) {
+        _buffer.assign(_tree._names.c_str(s.path), _tree._names.length(s.path));
+        if(!_buffer.empty()) _buffer += ".";
+        _buffer.append(_tree._names.c_str(s.name), _tree._names.length(s.name));
+        s.child_path = _tree._names.Intern(_buffer);
+    }
+    return s.child_path;
+}
+
+unsigned int CompactPropertyBuilder::AddNode(unsigned int parent, const char *name, size_t len)
+{
+    stage_t s;
+    s.name = _tree._names.Intern(name, len);
+    s.path = ChildPath(parent);
+    s.value = _tree._values.Intern("", 0);
+    s.child_path = none;
+    s.parent = parent;
+    s.first_child = s.last_child = s.next_sibling = none;
+    s.nchilds = 0;
+    s.first_attribute = _tree._attributes.size();
+    s.nattributes = 0;
+
+    unsigned int index = _stage.size();
+    _stage.push_back(s);
+
+    stage_t &p = _stage[parent];
+    if(p.last_child == none)
+        p.first_child = index;
+    else
+        _stage[p.last_child].next_sibling = index;
+    p.last_child = index;
+    p.nchilds++;
+    return index;
+}
+
+void CompactPropertyBuilder::SetValue(unsigned int node, const char *value, size_t len)
+{
+    _stage[node].value = _tree._values.Intern(value, len);
+}
+
+void CompactPropertyBuilder::AddAttribute(unsigned int node, const char *name, const char *value)
+{
+    // attributes of a node have to be added in one go
+    CompactProperty::attribute_t a;
+    a.name = _tree._names.Intern(name, strlen(name));
+    a.value = _tree._values.Intern(value, strlen(value));
+    _tree._attributes.push_back(a);
+    _stage[node].nattributes++;
+}
+
+void CompactPropertyBuilder::AddProperty(unsigned int node, Property &p)
+{
+    for(Property::AttributeIterator ia = p.firstAttribute(); ia != p.lastAttribute(); ++ia)
+        AddAttribute(node, ia->first.c_str(), ia->second.c_str());
+    SetValue(node, p.value().data(), p.value().size());
+
+    for(Property::iterator iter = p.begin(); iter != p.end(); ++iter) {
+        string name = (*iter).name();
+        AddProperty(AddNode(node, name.data(), name.size()), *iter);
+    }
+}
+
+void CompactPropertyBuilder::Finish()
+{
+    vector<unsigned int> order;
+    order.reserve(_stage.size());
+    order.push_back(0);
+    for(size_t i=0; i<order.size(); ++i)
+        for(unsigned int c = _stage[order[i]].first_child; c != none; c = _stage[c].next_sibling)
+            order.push_back(c);
+
+    vector<unsigned int> new_index(_stage.size());
+    for(size_t i=0; i<order.size(); ++i)
+        new_index[order[i]] = i;
+
+    _tree._nodes.resize(order.size());
+    for(size_t i=0; i<order.size(); ++i) {
+        const stage_t &s = _stage[order[i]];
+        CompactProperty::node_t &n = _tree._nodes[i];
+        n.name = s.name;
+        n.path = s.path;
+        n.value = s.value;
+        n.parent = new_index[s.parent];
+        n.first_child = s.nchilds ? new_index[s.first_child] : 0;
+        n.nchilds = s.nchilds;
+        n.first_attribute = s.first_attribute;
+        n.nattributes = s.nattributes;
+    }
+
+    vector<stage_t>().swap(_stage);
+    vector<CompactProperty::node_t>(_tree._nodes).swap(_tree._nodes);
+    vector<CompactProperty::attribute_t>(_tree._attributes).swap(_tree._attributes);
+    _tree._names.shrink();
+    _tree._values.shrink();
+}
+
+void CompactProperty::Assign(Property &p)
+{
+    CompactPropertyBuilder builder(*this);
+    builder.AddProperty(0, p);
+    builder.Finish();
+}
+
+void CompactProperty::clear()
+{
+    CompactPropertyBuilder builder(*this);
+    builder.Finish();
+}
+
+size_t CompactProperty::MemoryUsage() const
+{
+    return sizeof(*this) + _nodes.capacity()*sizeof(node_t)
+        + _attributes.capacity()*sizeof(attribute_t)
+        + _names.MemoryUsage() + _values.MemoryUsage();
+}
+
+PropertyView PropertyView::get(const string &key) const
+{
+    Tokenizer tok(key, ".");
+    unsigned int current = _node;
+
+    for(Tokenizer::iterator n = tok.begin(); n != tok.end(); ++n) {
+        CompactProperty::id_t name = _tree->names().Find(*n);
+        if(name == StringPool::npos)
+            throw runtime_error("property not found: " + key);
+
+        // like Property::get, the last child with a matching name wins
+        const CompactProperty::node_t &node = _tree->node(current);
+        unsigned int found = StringPool::npos;
+        for(unsigned int c = node.first_child + node.nchilds; c > node.first_child; --c)
+            if(_tree->node(c-1).name == name) {
+                found = c-1;
+                break;
+            }
+        if(found == StringPool::npos)
+            throw runtime_error("property not found: " + key);
+        current = found;
+    }
+    return PropertyView(_tree, current);
+}
+
+std::list<PropertyView> PropertyView::Select(const string &filter) const
+{
+    Tokenizer tok(filter, ".");
+    std::list<PropertyView> selection;
+
+    if(tok.begin()==tok.end()) return selection;
+
+    selection.push_back(*this);
+
+    for(Tokenizer::iterator n = tok.begin(); n != tok.end(); ++n) {
+        WildcardPattern pattern(*n);
+        std::list<PropertyView> childs;
+        if(pattern.IsLiteral()) {
+            // names are interned, compare ids instead of strings
+            CompactProperty::id_t name = _tree->names().Find(*n);
+            if(name == StringPool::npos)
+                return std::list<PropertyView>();
+            for(std::list<PropertyView>::iterator p = selection.begin(); p != selection.end(); ++p)
+                for(iterator c = p->begin(); c != p->end(); ++c)
+                    if(_tree->node((*c).index()).name == name)
+                        childs.push_back(*c);
+        }
+        else {
+            for(std::list<PropertyView>::iterator p = selection.begin(); p != selection.end(); ++p)
+                for(iterator c = p->begin(); c != p->end(); ++c) {
+                    CompactProperty::id_t name = _tree->node((*c).index()).name;
+                    if(pattern.Match(_tree->names().c_str(name), _tree->names().length(name)))
+                        childs.push_back(*c);
+                }
+        }
+        selection.swap(childs);
+    }
+    return selection;
+}
+
+const char *PropertyView::FindAttribute(const string &attribute) const
+{
+    const CompactProperty::node_t &n = _tree->node(_node);
+    CompactProperty::id_t name = _tree->names().Find(attribute);
+    if(name == StringPool::npos)
+        return NULL;
+    for(unsigned int i = n.first_attribute; i < n.first_attribute + n.nattributes; ++i)
+        if(_tree->attribute(i).name == name)
+            return _tree->values().c_str(_tree->attribute(i).value);
+    return NULL;
+}
+
+void PropertyView::ToProperty(Property &p) const
+{
+    const CompactProperty::node_t &n = _tree->node(_node);
+    for(unsigned int i = n.first_attribute; i < n.first_attribute + n.nattributes; ++i)
+        p.setAttribute(_tree->names().str(_tree->attribute(i).name),
+                _tree->values().str(_tree->attribute(i).value));
+    p.value() = value();
+    for(iterator c = begin(); c != end(); ++c)
+        (*c).ToProperty(p.add((*c).name(), ""));
+}
+
+/// state of the expat handlers while loading a compact tree
+struct compact_xml_state_t {
+    CompactPropertyBuilder *builder;
+    vector<unsigned int> nodes;
+    /// text content per open element, buffers are reused between elements
+    vector<string> values;
+};
+
+static void compact_start_hndl(void *data, const char *el, const char **attr)
+{
+    compact_xml_state_t *state =
+        (compact_xml_state_t *)XML_GetUserData((XML_Parser*)data);
+
+    unsigned int node = state->builder->AddNode(state->nodes.back(), el, strlen(el));
+    for (int i = 0; attr[i]; i += 2)
+        state->builder->AddAttribute(node, attr[i], attr[i + 1]);
+
+    state->nodes.push_back(node);
+    if(state->values.size() < state->nodes.size())
+        state->values.resize(state->nodes.size());
+    state->values[state->nodes.size()-1].clear();
+}
+
+static void compact_end_hndl(void *data, const char *)
+{
+    compact_xml_state_t *state =
+        (compact_xml_state_t *)XML_GetUserData((XML_Parser*)data);
+
+    const string &value = state->values[state->nodes.size()-1];
+    state->builder->SetValue(state->nodes.back(), value.data(), value.size());
+    state->nodes.pop_back();
+}
+
+static void compact_char_hndl(void *data, const char *txt, int txtlen)
+{
+    compact_xml_state_t *state =
+        (compact_xml_state_t *)XML_GetUserData((XML_Parser*)data);
+    state->values[state->nodes.size()-1].append(txt, txtlen);
+}
+
+bool load_compact_property_from_xml(CompactProperty &p, const string &filename)
+{
+  XML_Parser parser = XML_ParserCreate(NULL);
+  if (! parser)
+    throw std::runtime_error("Couldn't allocate memory for xml parser");
+
+  XML_UseParserAsHandlerArg(parser);
+  XML_SetElementHandler(parser, compact_start_hndl, compact_end_hndl);
+  XML_SetCharacterDataHandler(parser, compact_char_hndl);
+
+  CompactPropertyBuilder builder(p);
+  compact_xml_state_t state;
+  state.builder = &builder;
+  state.nodes.push_back(0);
+  state.values.resize(1);
+
+  XML_SetUserData(parser, (void*)&state);
+  try {
+    xml_parse_file(parser, filename);
+  }
+  catch(std::exception &err) {
+    XML_ParserFree(parser);
+    throw;
+  }
+  XML_ParserFree(parser);
+
+  builder.Finish();
+  return true;
+}
+
+}}
@@ -0,0 +1,60 @@
+/*
+ * Copyright 2009-2014 The VOTCA Development Team (http://www.votca.org)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <errno.h>
+#include <sys/time.h>
+#include <votca/tools/condition.h>
+
+namespace votca { namespace tools {
+
+Condition::Condition()
+{
+    pthread_cond_init(&_cond, NULL);
+}
+
+Condition::~Condition()
+{
+    pthread_cond_destroy(&_cond);
+}
+
+void Condition::Wait(Mutex &mutex)
+{
+    pthread_cond_wait(&_cond, &mutex._mutexVar);
+}
+
+bool Condition::TimedWait(Mutex &mutex, double seconds)
+{
+    struct timeval now;
+    gettimeofday(&now, NULL);
+    long long nsec = (long long)now.tv_usec * 1000 + (long long)(seconds * 1e9);
+    struct timespec timeout;
+    timeout.tv_sec = now.tv_sec + nsec / 1000000000LL;
+    timeout.tv_nsec = nsec % 1000000000LL;
+    return pthread_cond_timedwait(&_cond, &mutex._mutexVar, &timeout) != ETIMEDOUT;
+}
+
+void Condition::Signal()
+{
+    pthread_cond_signal(&_cond);
+}
+
+void Condition::Broadcast()
+{
+    pthread_cond_broadcast(&_cond);
+}
+
+}}
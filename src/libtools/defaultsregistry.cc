@@ -0,0 +1,96 @@
+/*
+ * Copyright 2009-2014 The VOTCA Development Team (http://www.votca.org)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <stdexcept>
+#include <votca/tools/defaultsregistry.h>
+
+namespace votca { namespace tools {
+
+DefaultsRegistry &DefaultsRegistry::Instance()
+{
+    // constructed during static initialization, before any thread is started
+    static DefaultsRegistry registry;
+    return registry;
+}
+
+namespace {
+    DefaultsRegistry &registry_instance = DefaultsRegistry::Instance();
+}
+
+DefaultsRegistry::~DefaultsRegistry()
+{
+    for(std::map<std::string, Property *>::iterator iter = _files.begin();
+            iter != _files.end(); ++iter)
+        delete iter->second;
+}
+
+Property &DefaultsRegistry::Get(const std::string &filename)
+{
+    ScopedLock lock(_files_mutex);
+    std::map<std::string, Property *>::iterator iter = _files.find(filename);
+    if(iter != _files.end())
+        return *iter->second;
+
+    Property *p = new Property();
+    try {
+        load_property_from_xml(*p, filename);
+    }
+    catch(...) {
+        delete p;
+        throw;
+    }
+    _files[filename] = p;
+    return *p;
+}
+
+void DefaultsRegistry::Update(Property &options, const std::string &filename,
+        const std::string &key)
+{
+    Merge(options.get(key), Get(filename).get(key));
+}
+
+bool DefaultsRegistry::HasDefaults(Property &p)
+{
+    for(Property::iterator iter = p.begin(); iter != p.end(); ++iter)
+        if(iter->hasAttribute("default") || HasDefaults(*iter))
+            return true;
+    return false;
+}
+
+void DefaultsRegistry::Merge(Property &p, Property &defaults)
+{
+    for(Property::iterator iter = defaults.begin(); iter != defaults.end(); ++iter) {
+        Property &d = *iter;
+        bool is_default = d.hasAttribute("default");
+
+        if(p.exists(d.name())) {
+            Property &o = p.get(d.name());
+            if(is_default && !o.HasChilds()
+                    && o.value().find_first_not_of(" \t\n\r") == std::string::npos)
+                o.value() = d.value();
+            Merge(o, d);
+        }
+        else if(is_default) {
+            Merge(p.add(d.name(), d.value()), d);
+        }
+        else if(HasDefaults(d)) {
+            Merge(p.add(d.name(), ""), d);
+        }
+    }
+}
+
+}}
@@ -0,0 +1,274 @@
+/*
+ * Copyright 2009-2014 The VOTCA Development Team (http://www.votca.org)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <votca/tools/lanczos.h>
+#include <votca/tools/randomstream.h>
+#include <stdexcept>
+#include <algorithm>
+#include <vector>
+#include <math.h>
+
+namespace votca { namespace tools {
+
+using namespace std;
+
+namespace {
+
+/// dot product with four partial sums, which breaks the dependency chain
+/// of the additions
+double dot(const double *a, const double *b, size_t n)
+{
+    double s0 = 0, s1 = 0, s2 = 0, s3 = 0;
+    size_t i = 0;
+    for(; i+4<=n; i+=4) {
+        s0 += a[i]*b[i];
+        s1 += a[i+1]*b[i+1];
+        s2 += a[i+2]*b[i+2];
+        s3 += a[i+3]*b[i+3];
+    }
+    for(; i<n; ++i)
+        s0 += a[i]*b[i];
+    return (s0 + s1) + (s2 + s3);
+}
+
+/// orthogonalize w against the first k rows of basis by classical
+/// Gram-Schmidt with reorthogonalization, the coefficients are added to h
+void orthogonalize(const ub::matrix<double> &basis, size_t k, double *w, size_t n, double *h)
+{
+    vector<double> c(k);
+    for(int pass=0; pass<2; ++pass) {
+        for(size_t i=0; i<k; ++i)
+            c[i] = dot(&basis(i,0), w, n);
+        for(size_t i=0; i<k; ++i) {
+            const double *v = &basis(i,0);
+            for(size_t j=0; j<n; ++j)
+                w[j] -= c[i]*v[j];
+            h[i] += c[i];
+        }
+    }
+}
+
+/// cyclic Jacobi for the small projected matrix, a is destroyed,
+/// eigenvalues are sorted in ascending order
+void jacobi_eigensystem(ub::matrix<double> &a, ub::vector<double> &d, ub::matrix<double> &v)
+{
+    const size_t n = a.size1();
+    v = ub::identity_matrix<double>(n);
+
+    for(int sweep=0; sweep<100; ++sweep) {
+        double off = 0, diag = 0;
+        for(size_t p=0; p<n; ++p) {
+            diag += a(p,p)*a(p,p);
+            for(size_t q=p+1; q<n; ++q)
+                off += a(p,q)*a(p,q);
+        }
+        if(off <= 1e-32*diag) break;
+
+        for(size_t p=0; p<n; ++p)
+            for(size_t q=p+1; q<n; ++q) {
+                if(a(p,q) == 0) continue;
+                double theta = (a(q,q) - a(p,p))/(2*a(p,q));
+                double t = 1.0/(fabs(theta) + sqrt(theta*theta + 1));
+                if(theta < 0) t = -t;
+                double c = 1.0/sqrt(t*t + 1);
+                double s = t*c;
+                for(size_t k=0; k<n; ++k) {
+                    double akp = a(k,p), akq = a(k,q);
+                    a(k,p) = c*akp - s*akq;
+                    a(k,q) = s*akp + c*akq;
+                }
+                for(size_t k=0; k<n; ++k) {
+                    double apk = a(p,k), aqk = a(q,k);
+                    a(p,k) = c*apk - s*aqk;
+                    a(q,k) = s*apk + c*aqk;
+                }
+                for(size_t k=0; k<n; ++k) {
+                    double vkp = v(k,p), vkq = v(k,q);
+                    v(k,p) = c*vkp - s*vkq;
+                    v(k,q) = s*vkp + c*vkq;
+                }
+            }
+    }
+
+    // selection sort, n is small
+    d.resize(n);
+    for(size_t i=0; i<n; ++i)
+        d(i) = a(i,i);
+    for(size_t i=0; i<n; ++i) {
+        size_t k = i;
+        for(size_t j=i+1; j<n; ++j)
+            if(d(j) < d(k)) k = j;
+        if(k == i) continue;
+        swap(d(i), d(k));
+        for(size_t j=0; j<n; ++j)
+            swap(v(j,i), v(j,k));
+    }
+}
+
+/// random vector orthogonal to the first k rows of basis, stored in row k
+void random_basis_vector(ub::matrix<double> &basis, size_t k, RandomStream &rng)
+{
+    const size_t n = basis.size2();
+    double *w = &basis(k,0);
+    vector<double> h(k + 1);
+    rng.fill_uniform(w, n);
+    for(size_t j=0; j<n; ++j)
+        w[j] -= 0.5;
+    orthogonalize(basis, k, w, n, &h[0]);
+    double norm = sqrt(dot(w, w, n));
+    for(size_t j=0; j<n; ++j)
+        w[j] /= norm;
+}
+
+/// index of the i-th wanted of m Ritz pairs in ascending order
+inline size_t ritz_index(size_t i, size_t m, LanczosSolver::spectrum_t which)
+{
+    return which == LanczosSolver::lowest ? i : m - 1 - i;
+}
+
+}
+
+void MatrixOperator::Apply(const double *x, double *y) const
+{
+    const size_t n = _A.size1();
+    for(size_t i=0; i<n; ++i)
+        y[i] = dot(&_A(i,0), x, n);
+}
+
+LanczosSolver::LanczosSolver()
+    : _tol(1e-10), _max_restarts(1000), _basis_size(0), _seed(0),
+      _restarts(0), _matvecs(0)
+{
+}
+
+bool LanczosSolver::Solve(const LinearOperator &A, int nev, ub::vector<double> &E,
+        ub::matrix<double> &V, spectrum_t which)
+{
+    const size_t n = A.size();
+    if(nev <= 0 || (size_t)nev > n)
+        throw std::invalid_argument("LanczosSolver: number of eigenpairs out of range");
+
+    // basis size, a restart needs at least one vector more than nev
+    size_t m = _basis_size > 0 ? _basis_size : max(2*nev, nev + 20);
+    m = max(m, (size_t)nev + 1);
+    m = min(m, n);
+
+    // the rows are the basis vectors, row m is the residual direction
+    ub::matrix<double> basis(m + 1, n);
+    ub::matrix<double> H = ub::zero_matrix<double>(m, m);
+    ub::matrix<double> Hc, Y;
+    ub::vector<double> theta;
+    vector<double> h(m + 1);
+
+    RandomStream rng(_seed);
+    random_basis_vector(basis, 0, rng);
+
+    _restarts = 0;
+    _matvecs = 0;
+    size_t l = 0;
+    double beta = 0;
+    // lower bound of the norm of A
+    double anorm = 0;
+    bool converged = false;
+
+    while(true) {
+        // extend the basis from l to m vectors
+        for(size_t j=l; j<m; ++j) {
+            double *w = &basis(j+1,0);
+            A.Apply(&basis(j,0), w);
+            _matvecs++;
+
+            fill(h.begin(), h.end(), 0.0);
+            double wnorm = sqrt(dot(w, w, n));
+            orthogonalize(basis, j+1, w, n, &h[0]);
+            for(size_t i=0; i<=j; ++i)
+                H(i,j) = H(j,i) = h[i];
+
+            beta = sqrt(dot(w, w, n));
+            anorm = max(anorm, wnorm);
+            if(beta <= 1e-12*wnorm) {
+                // invariant subspace, continue with a new direction
+                beta = 0;
+                if(j+1 < m)
+                    random_basis_vector(basis, j+1, rng);
+            }
+            else {
+                for(size_t k=0; k<n; ++k)
+                    w[k] /= beta;
+            }
+        }
+
+        Hc = H;
+        jacobi_eigensystem(Hc, theta, Y);
+        anorm = max(anorm, max(fabs(theta(0)), fabs(theta(m-1))));
+
+        converged = true;
+        for(int i=0; i<nev; ++i)
+            if(fabs(beta*Y(m-1, ritz_index(i, m, which))) > _tol*anorm)
+                converged = false;
+        // with m == n the basis spans the whole space
+        if(m == n)
+            converged = true;
+        if(converged || _restarts >= _max_restarts)
+            break;
+
+        // thick restart: keep the l best Ritz vectors and the residual direction
+        l = nev + (m - nev)/2;
+        if(l >= m) l = m - 1;
+        ub::matrix<double> ritz = ub::zero_matrix<double>(l, n);
+        for(size_t i=0; i<l; ++i) {
+            double *r = &ritz(i,0);
+            for(size_t k=0; k<m; ++k) {
+                const double y = Y(k, ritz_index(i, m, which));
+                const double *v = &basis(k,0);
+                for(size_t j=0; j<n; ++j)
+                    r[j] += y*v[j];
+            }
+        }
+        copy(&basis(m,0), &basis(m,0) + n, &basis(l,0));
+        copy(&ritz(0,0), &ritz(0,0) + l*n, &basis(0,0));
+
+        H = ub::zero_matrix<double>(m, m);
+        for(size_t i=0; i<l; ++i) {
+            H(i,i) = theta(ritz_index(i, m, which));
+            H(i,l) = H(l,i) = beta*Y(m-1, ritz_index(i, m, which));
+        }
+
+        _restarts++;
+    }
+
+    // ascending order for both ends of the spectrum
+    const size_t first = (which == lowest) ? 0 : m - nev;
+    E.resize(nev, false);
+    V.resize(n, nev, false);
+    vector<double> x(n);
+    for(int i=0; i<nev; ++i) {
+        E(i) = theta(first + i);
+        fill(x.begin(), x.end(), 0.0);
+        for(size_t k=0; k<m; ++k) {
+            const double y = Y(k, first + i);
+            const double *v = &basis(k,0);
+            for(size_t j=0; j<n; ++j)
+                x[j] += y*v[j];
+        }
+        for(size_t j=0; j<n; ++j)
+            V(j,i) = x[j];
+    }
+    return converged;
+}
+
+}}
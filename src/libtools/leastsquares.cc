@@ -0,0 +1,234 @@
+/*
+ * Copyright 2009-2014 The VOTCA Development Team (http://www.votca.org)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <votca/tools/leastsquares.h>
+#include <vector>
+#include <algorithm>
+#include <math.h>
+
+namespace votca { namespace tools {
+
+using namespace std;
+
+namespace {
+
+double norm2(const vector<double> &v)
+{
+    double s = 0;
+    for(size_t i=0; i<v.size(); ++i)
+        s += v[i]*v[i];
+    return sqrt(s);
+}
+
+void scale(vector<double> &v, double alpha)
+{
+    for(size_t i=0; i<v.size(); ++i)
+        v[i] *= alpha;
+}
+
+/**
+ * the operator [A; lambda*I]*D of the damped and column scaled problem,
+ * the least-squares problem for y = inv(D)*x has the right hand side [b; 0]
+ */
+class scaled_operator
+{
+public:
+    scaled_operator(const SparseMatrix &A, double lambda, const vector<double> &d)
+        : _A(A), _lambda(lambda), _d(d), _tmp(A.size2()) {}
+
+    size_t rows() const { return _A.size1() + (_lambda != 0 ? _A.size2() : 0); }
+    size_t cols() const { return _A.size2(); }
+
+    /// u = [A; lambda*I]*D*y
+    void forward(const vector<double> &y, vector<double> &u) {
+        const size_t m = _A.size1(), n = _A.size2();
+        for(size_t j=0; j<n; ++j)
+            _tmp[j] = _d[j]*y[j];
+        _A.prod(&_tmp[0], &u[0]);
+        if(_lambda != 0)
+            for(size_t j=0; j<n; ++j)
+                u[m+j] = _lambda*_tmp[j];
+    }
+
+    /// y = D*[trans(A), lambda*I]*u
+    void adjoint(const vector<double> &u, vector<double> &y) {
+        const size_t m = _A.size1(), n = _A.size2();
+        _A.trans_prod(&u[0], &y[0]);
+        if(_lambda != 0)
+            for(size_t j=0; j<n; ++j)
+                y[j] += _lambda*u[m+j];
+        for(size_t j=0; j<n; ++j)
+            y[j] *= _d[j];
+    }
+
+private:
+    const SparseMatrix &_A;
+    double _lambda;
+    const vector<double> &_d;
+    vector<double> _tmp;
+};
+
+}
+
+LeastSquaresSolver::LeastSquaresSolver()
+    : _method(lsqr), _damping(0), _jacobi(true), _tol(1e-10), _max_iterations(0),
+      _iterations(0), _residual(0)
+{
+}
+
+bool LeastSquaresSolver::Solve(const SparseMatrix &A, const ub::vector<double> &b, ub::vector<double> &x)
+{
+    const size_t m = A.size1();
+    const size_t n = A.size2();
+    if(b.size() != m)
+        throw std::invalid_argument("LeastSquaresSolver: size of b does not match the matrix");
+
+    _iterations = 0;
+    _residual = 0;
+    if(n == 0) {
+        x.resize(0, false);
+        for(size_t i=0; i<m; ++i)
+            _residual += b(i)*b(i);
+        _residual = sqrt(_residual);
+        return true;
+    }
+
+    // column scaling and Frobenius norm of the scaled operator
+    const double lambda2 = _damping*_damping;
+    ub::vector<double> colnorm2;
+    A.ColumnNorms2(colnorm2);
+    vector<double> d(n, 1.0);
+    double anorm = 0;
+    for(size_t j=0; j<n; ++j) {
+        const double c = colnorm2(j) + lambda2;
+        if(_jacobi && c > 0)
+            d[j] = 1.0/sqrt(c);
+        anorm += d[j]*d[j]*c;
+    }
+    anorm = sqrt(anorm);
+
+    scaled_operator op(A, _damping, d);
+    const int max_iterations = _max_iterations > 0 ? _max_iterations : max(100, 4*(int)n);
+
+    vector<double> y(n, 0.0);
+    vector<double> u(op.rows(), 0.0);
+    copy(b.begin(), b.end(), u.begin());
+    const double bnorm = norm2(u);
+    bool converged = (bnorm == 0);
+
+    if(!converged && _method == cgls) {
+        // r = [b; 0] - op*y, s = trans(op)*r
+        vector<double> &r = u;
+        vector<double> s(n), p(n), q(op.rows());
+        op.adjoint(r, s);
+        p = s;
+        double gamma = norm2(s);
+        gamma *= gamma;
+
+        while(_iterations < max_iterations) {
+            op.forward(p, q);
+            double qnorm = norm2(q);
+            if(qnorm == 0) break;
+            const double alpha = gamma/(qnorm*qnorm);
+            for(size_t j=0; j<n; ++j)
+                y[j] += alpha*p[j];
+            for(size_t i=0; i<r.size(); ++i)
+                r[i] -= alpha*q[i];
+            op.adjoint(r, s);
+            double gamma_new = norm2(s);
+            _iterations++;
+
+            const double rnorm = norm2(r);
+            if(rnorm <= _tol*bnorm || gamma_new <= _tol*anorm*rnorm) {
+                converged = true;
+                break;
+            }
+
+            gamma_new *= gamma_new;
+            const double beta = gamma_new/gamma;
+            gamma = gamma_new;
+            for(size_t j=0; j<n; ++j)
+                p[j] = s[j] + beta*p[j];
+        }
+    }
+    else if(!converged) {
+        // Golub-Kahan bidiagonalization, see Paige and Saunders
+        vector<double> v(n), w(n), tmp_u(op.rows()), tmp_v(n);
+        double beta = bnorm;
+        scale(u, 1.0/beta);
+        op.adjoint(u, v);
+        double alpha = norm2(v);
+        if(alpha > 0) scale(v, 1.0/alpha);
+        w = v;
+        double phibar = beta;
+        double rhobar = alpha;
+        // alpha = 0 means trans(A)*b = 0, so x = 0 is the solution
+        converged = (alpha == 0);
+
+        while(!converged && _iterations < max_iterations) {
+            // u = op*v - alpha*u
+            op.forward(v, tmp_u);
+            for(size_t i=0; i<u.size(); ++i)
+                u[i] = tmp_u[i] - alpha*u[i];
+            beta = norm2(u);
+            if(beta > 0) scale(u, 1.0/beta);
+
+            // v = trans(op)*u - beta*v
+            op.adjoint(u, tmp_v);
+            for(size_t j=0; j<n; ++j)
+                v[j] = tmp_v[j] - beta*v[j];
+            alpha = norm2(v);
+            if(alpha > 0) scale(v, 1.0/alpha);
+
+            // plane rotation to eliminate beta
+            const double rho = sqrt(rhobar*rhobar + beta*beta);
+            const double c = rhobar/rho;
+            const double s = beta/rho;
+            const double theta = s*alpha;
+            rhobar = -c*alpha;
+            const double phi = c*phibar;
+            phibar = s*phibar;
+
+            for(size_t j=0; j<n; ++j) {
+                y[j] += (phi/rho)*w[j];
+                w[j] = v[j] - (theta/rho)*w[j];
+            }
+            _iterations++;
+
+            // estimates of |r| and |trans(op)*r|
+            const double rnorm = phibar;
+            const double arnorm = phibar*alpha*fabs(c);
+            if(rnorm <= _tol*bnorm || arnorm <= _tol*anorm*rnorm)
+                converged = true;
+        }
+    }
+
+    // x = D*y
+    x.resize(n, false);
+    for(size_t j=0; j<n; ++j)
+        x(j) = d[j]*y[j];
+
+    vector<double> r(m);
+    A.prod(&x(0), m ? &r[0] : NULL);
+    for(size_t i=0; i<m; ++i)
+        r[i] -= b(i);
+    _residual = norm2(r);
+
+    return converged;
+}
+
+}}
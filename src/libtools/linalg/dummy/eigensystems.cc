@@ -15,7 +15,9 @@
  *
  */
 
+#include <stdexcept>
 #include <votca/tools/linalg.h>
+#include <votca/tools/lanczos.h>
 #include <boost/numeric/ublas/matrix_proxy.hpp>
 #include <boost/numeric/ublas/matrix.hpp>
 
@@ -79,19 +81,30 @@ bool linalg_eigenvalues( ub::vector<double> &E, ub::matrix<double> &V)
 
 
 /*
- * use expert routine to calculate only a subrange of eigenvalues
+ * calculate only the nmax lowest eigenvalues, the Lanczos solver does not
+ * need a linalg backend
  */
 bool linalg_eigenvalues( ub::matrix<double> &A, ub::vector<double> &E, ub::matrix<double> &V , int nmax)
 {
-    throw std::runtime_error("linalg_eigenvalues is not compiled-in due to disabling of MKL - recompile Votca Tools with MKL support");
+    if(nmax <= 0 || nmax > (int)A.size1())
+        throw std::invalid_argument("linalg_eigenvalues: nmax out of range");
+    LanczosSolver lanczos;
+    MatrixOperator op(A);
+    return lanczos.Solve(op, nmax, E, V);
 }
 
 /*
- * use expert routine to calculate only a subrange of eigenvalues single precision
+ * calculate only the nmax lowest eigenvalues single precision
  */
 bool linalg_eigenvalues( ub::matrix<float> &A, ub::vector<float> &E, ub::matrix<float> &V , int nmax)
 {
-    throw std::runtime_error("linalg_eigenvalues is not compiled-in due to disabling of MKL - recompile Votca Tools with MKL support");
+    ub::matrix<double> _A = A;
+    ub::vector<double> _E;
+    ub::matrix<double> _V;
+    bool status = linalg_eigenvalues( _A , _E, _V, nmax );
+    E = _E;
+    V = _V;
+    return status;
 }
 
 bool linalg_eigenvalues_general( ub::matrix<double> &A,ub::matrix<double> &B, ub::vector<double> &E, ub::matrix<double> &V)
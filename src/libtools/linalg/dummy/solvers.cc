@@ -0,0 +1,82 @@
+/*
+ * Copyright 2009-2014 The VOTCA Development Team (http://www.votca.org)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <votca/tools/linalgsolvers.h>
+#include <stdexcept>
+
+namespace votca { namespace tools {
+
+using namespace std;
+
+struct QRSolver::workspace_t {};
+struct CholeskySolver::workspace_t {};
+struct LUSolver::workspace_t {};
+struct EigenSolver::workspace_t {};
+
+QRSolver::QRSolver() : _ws(NULL), _check_zero_columns(true) {}
+QRSolver::~QRSolver() {}
+
+void QRSolver::Decompose(const ub::matrix<double> &A)
+{
+    throw std::runtime_error("QRSolver is not compiled-in due to disabling of LAPACK, GSL and MKL - recompile Votca Tools with LAPACK, GSL or MKL support");
+}
+
+void QRSolver::Solve(ub::vector<double> &x, const ub::vector<double> &b, ub::vector<double> *residual)
+{
+    throw std::runtime_error("QRSolver is not compiled-in due to disabling of LAPACK, GSL and MKL - recompile Votca Tools with LAPACK, GSL or MKL support");
+}
+
+CholeskySolver::CholeskySolver() : _ws(NULL) {}
+CholeskySolver::~CholeskySolver() {}
+
+void CholeskySolver::Decompose(const ub::matrix<double> &A)
+{
+    throw std::runtime_error("CholeskySolver is not compiled-in due to disabling of LAPACK, GSL and MKL - recompile Votca Tools with LAPACK, GSL or MKL support");
+}
+
+void CholeskySolver::Solve(ub::vector<double> &x, const ub::vector<double> &b)
+{
+    throw std::runtime_error("CholeskySolver is not compiled-in due to disabling of LAPACK, GSL and MKL - recompile Votca Tools with LAPACK, GSL or MKL support");
+}
+
+LUSolver::LUSolver() : _ws(NULL) {}
+LUSolver::~LUSolver() {}
+
+void LUSolver::Decompose(const ub::matrix<double> &A)
+{
+    throw std::runtime_error("LUSolver is not compiled-in due to disabling of LAPACK, GSL and MKL - recompile Votca Tools with LAPACK, GSL or MKL support");
+}
+
+void LUSolver::Solve(ub::vector<double> &x, const ub::vector<double> &b)
+{
+    throw std::runtime_error("LUSolver is not compiled-in due to disabling of LAPACK, GSL and MKL - recompile Votca Tools with LAPACK, GSL or MKL support");
+}
+
+void LUSolver::Invert(ub::matrix<double> &V)
+{
+    throw std::runtime_error("LUSolver is not compiled-in due to disabling of LAPACK, GSL and MKL - recompile Votca Tools with LAPACK, GSL or MKL support");
+}
+
+EigenSolver::EigenSolver() : _ws(NULL) {}
+EigenSolver::~EigenSolver() {}
+
+bool EigenSolver::Solve(const ub::matrix<double> &A, ub::vector<double> &E, ub::matrix<double> &V)
+{
+    throw std::runtime_error("EigenSolver is not compiled-in due to disabling of LAPACK, GSL and MKL - recompile Votca Tools with LAPACK, GSL or MKL support");
+}
+
+}}
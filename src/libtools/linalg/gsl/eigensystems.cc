@@ -15,8 +15,11 @@
  *
  */
 
+#include <stdexcept>
 #include <votca/tools/linalg.h>
+#include <votca/tools/lanczos.h>
 #include <boost/numeric/ublas/matrix_proxy.hpp>
+#include <boost/numeric/ublas/vector_proxy.hpp>
 #include <boost/numeric/ublas/matrix.hpp>
 #include <math.h>       /* sqrt */
 #include <gsl/gsl_linalg.h>
@@ -166,21 +169,44 @@ bool linalg_eigenvalues( ub::vector<double> &E, ub::matrix<double> &V)
 
 
 /*
- * use expert routine to calculate only a subrange of eigenvalues
+ * calculate only the nmax lowest eigenvalues, returns the full solution
+ * truncated to nmax, or the Lanczos solution for a small part of a large
+ * spectrum
  */
 bool linalg_eigenvalues( ub::matrix<double> &A, ub::vector<double> &E, ub::matrix<double> &V , int nmax)
 {
-    throw std::runtime_error("linalg_eigenvalues is not compiled-in due to disabling of MKL - recompile Votca Tools with MKL support");
+    const int N = A.size1();
+    if(nmax <= 0 || nmax > N)
+        throw std::invalid_argument("linalg_eigenvalues: nmax out of range");
+
+    // Lanczos costs O(N^2*nmax) instead of O(N^3)
+    if(N > 100 && 10*nmax <= N) {
+        LanczosSolver lanczos;
+        MatrixOperator op(A);
+        if(lanczos.Solve(op, nmax, E, V))
+            return false;
+    }
+
+    ub::vector<double> _E;
+    ub::matrix<double> _V;
+    bool status = linalg_eigenvalues( A , _E, _V );
+    E = ub::subrange(_E, 0, nmax);
+    V = ub::subrange(_V, 0, N, 0, nmax);
+    return status;
 }
 
 /*
- * use expert routine to calculate only a subrange of eigenvalues single precision
+ * calculate only the nmax lowest eigenvalues single precision
  */
 bool linalg_eigenvalues( ub::matrix<float> &A, ub::vector<float> &E, ub::matrix<float> &V , int nmax)
 {
-    // now call wrapper for gsl_eigen_symmv
-    bool status = linalg_eigenvalues( A , E, V );
-
+    // gsl does not handle floats
+    ub::matrix<double> _A = A;
+    ub::vector<double> _E;
+    ub::matrix<double> _V;
+    bool status = linalg_eigenvalues( _A , _E, _V, nmax );
+    E = _E;
+    V = _V;
     return status;
 }
 
@@ -0,0 +1,366 @@
+/*
+ * Copyright 2009-2014 The VOTCA Development Team (http://www.votca.org)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <votca/tools/linalgsolvers.h>
+#include <stdexcept>
+#include <algorithm>
+
+#include <gsl/gsl_linalg.h>
+#include <gsl/gsl_errno.h>
+#include <gsl/gsl_eigen.h>
+
+namespace votca { namespace tools {
+
+using namespace std;
+
+namespace {
+
+// the gsl objects are only reallocated if the size changes
+void resize_matrix(gsl_matrix *&m, size_t size1, size_t size2)
+{
+    if(m && m->size1 == size1 && m->size2 == size2) return;
+    if(m) gsl_matrix_free(m);
+    m = gsl_matrix_alloc(size1, size2);
+}
+
+void resize_vector(gsl_vector *&v, size_t size)
+{
+    if(v && v->size == size) return;
+    if(v) gsl_vector_free(v);
+    v = gsl_vector_alloc(size);
+}
+
+// copy a ublas matrix into a gsl matrix of the same size
+void copy_matrix(const ub::matrix<double> &A, gsl_matrix *m)
+{
+    copy(A.data().begin(), A.data().end(), m->data);
+}
+
+void copy_vector(const gsl_vector *v, ub::vector<double> &x)
+{
+    x.resize(v->size, false);
+    for(size_t i=0; i<v->size; i++)
+        x(i) = gsl_vector_get(v, i);
+}
+
+}
+
+struct QRSolver::workspace_t {
+    workspace_t() : qr(NULL), tau(NULL), x(NULL), residual(NULL), m(0), n(0), empty(false), decomposed(false) {}
+    ~workspace_t() {
+        if(qr) gsl_matrix_free(qr);
+        if(tau) gsl_vector_free(tau);
+        if(x) gsl_vector_free(x);
+        if(residual) gsl_vector_free(residual);
+    }
+
+    gsl_matrix *qr;
+    gsl_vector *tau;
+    gsl_vector *x;
+    gsl_vector *residual;
+    size_t m, n;
+    bool empty;
+    bool decomposed;
+};
+
+QRSolver::QRSolver()
+    : _ws(new workspace_t), _check_zero_columns(true)
+{
+}
+
+QRSolver::~QRSolver()
+{
+    delete _ws;
+}
+
+void QRSolver::Decompose(const ub::matrix<double> &A)
+{
+    workspace_t &ws = *_ws;
+    const size_t m = A.size1();
+    const size_t n = A.size2();
+    if(m < n)
+        throw std::invalid_argument("QRSolver: matrix has more columns than rows");
+
+    if(_check_zero_columns) {
+        for(size_t j=0; j<n; j++) {
+            size_t i;
+            for(i=0; i<m; i++)
+                if(A(i,j) != 0) break;
+            if(i==m)
+                throw std::runtime_error("QRSolver: zero column in matrix");
+        }
+    }
+
+    ws.m = m;
+    ws.n = n;
+    ws.empty = (n == 0);
+    ws.decomposed = true;
+    if(ws.empty) return;
+
+    resize_matrix(ws.qr, m, n);
+    resize_vector(ws.tau, n);
+    resize_vector(ws.x, n);
+    resize_vector(ws.residual, m);
+    copy_matrix(A, ws.qr);
+
+    gsl_error_handler_t *handler = gsl_set_error_handler_off();
+    gsl_linalg_QR_decomp(ws.qr, ws.tau);
+    gsl_set_error_handler(handler);
+}
+
+void QRSolver::Solve(ub::vector<double> &x, const ub::vector<double> &b, ub::vector<double> *residual)
+{
+    workspace_t &ws = *_ws;
+    if(!ws.decomposed)
+        throw std::runtime_error("QRSolver: no matrix decomposed");
+    if(b.size() != ws.m)
+        throw std::invalid_argument("QRSolver: size of b does not match the matrix");
+
+    if(ws.empty) {
+        if(residual) *residual = b;
+        x.resize(0, false);
+        return;
+    }
+
+    gsl_vector_const_view gb = gsl_vector_const_view_array(&b(0), b.size());
+
+    gsl_error_handler_t *handler = gsl_set_error_handler_off();
+    gsl_linalg_QR_lssolve(ws.qr, ws.tau, &gb.vector, ws.x, ws.residual);
+    gsl_set_error_handler(handler);
+
+    // b is not used any more, so x and b may be the same vector
+    copy_vector(ws.x, x);
+    if(residual)
+        copy_vector(ws.residual, *residual);
+}
+
+
+struct CholeskySolver::workspace_t {
+    workspace_t() : l(NULL), x(NULL), n(0), decomposed(false) {}
+    ~workspace_t() {
+        if(l) gsl_matrix_free(l);
+        if(x) gsl_vector_free(x);
+    }
+
+    gsl_matrix *l;
+    gsl_vector *x;
+    size_t n;
+    bool decomposed;
+};
+
+CholeskySolver::CholeskySolver()
+    : _ws(new workspace_t)
+{
+}
+
+CholeskySolver::~CholeskySolver()
+{
+    delete _ws;
+}
+
+void CholeskySolver::Decompose(const ub::matrix<double> &A)
+{
+    workspace_t &ws = *_ws;
+    const size_t n = A.size1();
+    if(A.size2() != n)
+        throw std::invalid_argument("CholeskySolver: matrix is not square");
+
+    ws.decomposed = false;
+    ws.n = n;
+    if(n == 0) {
+        ws.decomposed = true;
+        return;
+    }
+
+    resize_matrix(ws.l, n, n);
+    resize_vector(ws.x, n);
+    copy_matrix(A, ws.l);
+
+    gsl_error_handler_t *handler = gsl_set_error_handler_off();
+    int status = gsl_linalg_cholesky_decomp(ws.l);
+    gsl_set_error_handler(handler);
+
+    if(status == GSL_EDOM)
+        throw std::runtime_error("Matrix not symmetric positive definite");
+    ws.decomposed = true;
+}
+
+void CholeskySolver::Solve(ub::vector<double> &x, const ub::vector<double> &b)
+{
+    workspace_t &ws = *_ws;
+    if(!ws.decomposed)
+        throw std::runtime_error("CholeskySolver: no matrix decomposed");
+    if(b.size() != ws.n)
+        throw std::invalid_argument("CholeskySolver: size of b does not match the matrix");
+
+    if(ws.n == 0) {
+        x.resize(0, false);
+        return;
+    }
+
+    gsl_vector_const_view gb = gsl_vector_const_view_array(&b(0), b.size());
+    gsl_linalg_cholesky_solve(ws.l, &gb.vector, ws.x);
+    copy_vector(ws.x, x);
+}
+
+
+struct LUSolver::workspace_t {
+    workspace_t() : lu(NULL), perm(NULL), x(NULL), n(0), decomposed(false) {}
+    ~workspace_t() {
+        if(lu) gsl_matrix_free(lu);
+        if(perm) gsl_permutation_free(perm);
+        if(x) gsl_vector_free(x);
+    }
+
+    gsl_matrix *lu;
+    gsl_permutation *perm;
+    gsl_vector *x;
+    size_t n;
+    bool decomposed;
+};
+
+LUSolver::LUSolver()
+    : _ws(new workspace_t)
+{
+}
+
+LUSolver::~LUSolver()
+{
+    delete _ws;
+}
+
+void LUSolver::Decompose(const ub::matrix<double> &A)
+{
+    workspace_t &ws = *_ws;
+    const size_t n = A.size1();
+    if(A.size2() != n)
+        throw std::invalid_argument("LUSolver: matrix is not square");
+
+    ws.decomposed = false;
+    if(n == 0) {
+        ws.n = 0;
+        ws.decomposed = true;
+        return;
+    }
+
+    resize_matrix(ws.lu, n, n);
+    resize_vector(ws.x, n);
+    if(ws.perm && ws.n != n) {
+        gsl_permutation_free(ws.perm);
+        ws.perm = NULL;
+    }
+    if(!ws.perm)
+        ws.perm = gsl_permutation_alloc(n);
+    ws.n = n;
+    copy_matrix(A, ws.lu);
+
+    int s;
+    gsl_linalg_LU_decomp(ws.lu, ws.perm, &s);
+    for(size_t i=0; i<n; i++)
+        if(gsl_matrix_get(ws.lu, i, i) == 0)
+            throw std::runtime_error("LUSolver: matrix is singular");
+    ws.decomposed = true;
+}
+
+void LUSolver::Solve(ub::vector<double> &x, const ub::vector<double> &b)
+{
+    workspace_t &ws = *_ws;
+    if(!ws.decomposed)
+        throw std::runtime_error("LUSolver: no matrix decomposed");
+    if(b.size() != ws.n)
+        throw std::invalid_argument("LUSolver: size of b does not match the matrix");
+
+    if(ws.n == 0) {
+        x.resize(0, false);
+        return;
+    }
+
+    gsl_vector_const_view gb = gsl_vector_const_view_array(&b(0), b.size());
+    gsl_linalg_LU_solve(ws.lu, ws.perm, &gb.vector, ws.x);
+    copy_vector(ws.x, x);
+}
+
+void LUSolver::Invert(ub::matrix<double> &V)
+{
+    workspace_t &ws = *_ws;
+    if(!ws.decomposed)
+        throw std::runtime_error("LUSolver: no matrix decomposed");
+
+    V.resize(ws.n, ws.n, false);
+    if(ws.n == 0) return;
+
+    gsl_matrix_view V_view = gsl_matrix_view_array(&V(0,0), ws.n, ws.n);
+    gsl_linalg_LU_invert(ws.lu, ws.perm, &V_view.matrix);
+}
+
+
+struct EigenSolver::workspace_t {
+    workspace_t() : a(NULL), w(NULL), n(0) {}
+    ~workspace_t() {
+        if(a) gsl_matrix_free(a);
+        if(w) gsl_eigen_symmv_free(w);
+    }
+
+    gsl_matrix *a;
+    gsl_eigen_symmv_workspace *w;
+    size_t n;
+};
+
+EigenSolver::EigenSolver()
+    : _ws(new workspace_t)
+{
+}
+
+EigenSolver::~EigenSolver()
+{
+    delete _ws;
+}
+
+bool EigenSolver::Solve(const ub::matrix<double> &A, ub::vector<double> &E, ub::matrix<double> &V)
+{
+    workspace_t &ws = *_ws;
+    const size_t n = A.size1();
+    if(A.size2() != n)
+        throw std::invalid_argument("EigenSolver: matrix is not square");
+
+    E.resize(n, false);
+    V.resize(n, n, false);
+    if(n == 0) return true;
+
+    resize_matrix(ws.a, n, n);
+    if(ws.w && ws.n != n) {
+        gsl_eigen_symmv_free(ws.w);
+        ws.w = NULL;
+    }
+    if(!ws.w)
+        ws.w = gsl_eigen_symmv_alloc(n);
+    ws.n = n;
+    // gsl_eigen_symmv destroys its input
+    copy_matrix(A, ws.a);
+
+    gsl_vector_view E_view = gsl_vector_view_array(&E(0), n);
+    gsl_matrix_view V_view = gsl_matrix_view_array(&V(0,0), n, n);
+
+    gsl_error_handler_t *handler = gsl_set_error_handler_off();
+    int status = gsl_eigen_symmv(ws.a, &E_view.vector, &V_view.matrix, ws.w);
+    gsl_eigen_symmv_sort(&E_view.vector, &V_view.matrix, GSL_EIGEN_SORT_VAL_ASC);
+    gsl_set_error_handler(handler);
+
+    return status == 0;
+}
+
+}}
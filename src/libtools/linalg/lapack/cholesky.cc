@@ -0,0 +1,64 @@
+/*
+ * Copyright 2009-2014 The VOTCA Development Team (http://www.votca.org)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <votca/tools/linalg.h>
+#include <stdexcept>
+#include "lapack_interface.h"
+
+namespace votca { namespace tools {
+
+using namespace std;
+
+
+void linalg_cholesky_decompose( ub::matrix<double> &A){
+    // Cholesky decomposition using dpotrf
+    // the lower triangle of the row-major A is the upper one for LAPACK
+    int n = A.size1();
+    int info;
+    char uplo = 'U';
+
+    dpotrf_(&uplo, &n, &A(0,0), &n, &info);
+    if ( info != 0 )
+        throw std::runtime_error("Matrix not symmetric positive definite");
+
+    // like the gsl backend, return L in the lower and L^T in the upper triangle
+    for(int i=0; i<n; i++)
+        for(int j=i+1; j<n; j++)
+            A(i,j) = A(j,i);
+}
+
+
+void linalg_cholesky_solve(ub::vector<double> &x, ub::matrix<double> &A, ub::vector<double> &b){
+    /* calling program should catch the error thrown
+     * if A is not positive definite and take
+     * necessary steps
+     */
+    int n = A.size1();
+    int nrhs = 1;
+    int info;
+    char uplo = 'U';
+
+    dpotrf_(&uplo, &n, &A(0,0), &n, &info);
+    if ( info != 0 )
+        throw std::runtime_error("Matrix not symmetric positive definite");
+
+    // the solution overwrites the right hand side
+    x = b;
+    dpotrs_(&uplo, &n, &nrhs, &A(0,0), &n, &x(0), &n, &info);
+}
+
+}}
@@ -0,0 +1,221 @@
+/*
+ * Copyright 2009-2014 The VOTCA Development Team (http://www.votca.org)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <votca/tools/linalg.h>
+#include <stdexcept>
+#include <vector>
+#include "lapack_interface.h"
+
+namespace votca { namespace tools {
+
+using namespace std;
+
+namespace {
+
+inline void syevd(const char *jobz, const char *uplo, const int *n, double *a,
+        const int *lda, double *w, double *work, const int *lwork,
+        int *iwork, const int *liwork, int *info)
+{
+    dsyevd_(jobz, uplo, n, a, lda, w, work, lwork, iwork, liwork, info);
+}
+
+inline void syevd(const char *jobz, const char *uplo, const int *n, float *a,
+        const int *lda, float *w, float *work, const int *lwork,
+        int *iwork, const int *liwork, int *info)
+{
+    ssyevd_(jobz, uplo, n, a, lda, w, work, lwork, iwork, liwork, info);
+}
+
+inline void syevr(const char *jobz, const char *range, const char *uplo, const int *n,
+        double *a, const int *lda, const double *vl, const double *vu,
+        const int *il, const int *iu, const double *abstol, int *m, double *w,
+        double *z, const int *ldz, int *isuppz, double *work, const int *lwork,
+        int *iwork, const int *liwork, int *info)
+{
+    dsyevr_(jobz, range, uplo, n, a, lda, vl, vu, il, iu, abstol, m, w,
+            z, ldz, isuppz, work, lwork, iwork, liwork, info);
+}
+
+inline void syevr(const char *jobz, const char *range, const char *uplo, const int *n,
+        float *a, const int *lda, const float *vl, const float *vu,
+        const int *il, const int *iu, const float *abstol, int *m, float *w,
+        float *z, const int *ldz, int *isuppz, float *work, const int *lwork,
+        int *iwork, const int *liwork, int *info)
+{
+    ssyevr_(jobz, range, uplo, n, a, lda, vl, vu, il, iu, abstol, m, w,
+            z, ldz, isuppz, work, lwork, iwork, liwork, info);
+}
+
+/*
+ * divide and conquer eigensolver, on input V is the symmetric matrix,
+ * on output it contains the eigenvectors as columns, eigenvalues are
+ * in ascending order
+ */
+template<typename T>
+bool lapack_eigenvalues(ub::vector<T> &E, ub::matrix<T> &V)
+{
+    int n = V.size1();
+    E.resize(n, false);
+    if(n == 0) return true;
+
+    char jobz = 'V';
+    char uplo = 'U';
+    int info;
+
+    // workspace query
+    T wkopt;
+    int iwkopt;
+    int lwork = -1;
+    int liwork = -1;
+    syevd(&jobz, &uplo, &n, &V(0,0), &n, &E(0), &wkopt, &lwork, &iwkopt, &liwork, &info);
+    lwork = lapack_worksize(wkopt);
+    liwork = lapack_worksize(iwkopt);
+    vector<T> work(lwork);
+    vector<int> iwork(liwork);
+
+    syevd(&jobz, &uplo, &n, &V(0,0), &n, &E(0), &work[0], &lwork, &iwork[0], &liwork, &info);
+
+    // LAPACK returns the eigenvectors as columns in column-major order
+    lapack_transpose(&V(0,0), n);
+    return info == 0;
+}
+
+/*
+ * use the MRRR routine to calculate only the nmax lowest eigenvalues
+ */
+template<typename T>
+bool lapack_eigenvalues(ub::matrix<T> &A, ub::vector<T> &E, ub::matrix<T> &V, int nmax)
+{
+    int n = A.size1();
+    if(nmax <= 0 || nmax > n)
+        throw std::invalid_argument("linalg_eigenvalues: nmax out of range");
+    E.resize(nmax, false);
+    V.resize(n, nmax, false);
+
+    // dsyevr destroys its input
+    ub::matrix<T> work_A = A;
+    // eigenvectors are returned as columns in column-major order
+    ub::matrix<T, ub::column_major> Z(n, nmax);
+
+    char jobz = 'V';
+    char range = 'I';
+    char uplo = 'U';
+    T vl = 0.0, vu = 0.0;
+    T abstol = 0.0; // use default
+    int il = 1;
+    int iu = nmax;
+    int m;
+    int info;
+    vector<int> isuppz(2*nmax);
+
+    // workspace query
+    T wkopt;
+    int iwkopt;
+    int lwork = -1;
+    int liwork = -1;
+    syevr(&jobz, &range, &uplo, &n, &work_A(0,0), &n, &vl, &vu, &il, &iu, &abstol,
+            &m, &E(0), &Z(0,0), &n, &isuppz[0], &wkopt, &lwork, &iwkopt, &liwork, &info);
+    lwork = lapack_worksize(wkopt);
+    liwork = lapack_worksize(iwkopt);
+    vector<T> work(lwork);
+    vector<int> iwork(liwork);
+
+    syevr(&jobz, &range, &uplo, &n, &work_A(0,0), &n, &vl, &vu, &il, &iu, &abstol,
+            &m, &E(0), &Z(0,0), &n, &isuppz[0], &work[0], &lwork, &iwork[0], &liwork, &info);
+
+    V = Z;
+    return info == 0;
+}
+
+}
+
+/*
+ * all routines return true on success
+ */
+
+bool linalg_eigenvalues_symmetric( ub::symmetric_matrix<double> &A, ub::vector<double> &E, ub::matrix<double> &V)
+{
+    V = A;
+    return lapack_eigenvalues(E, V);
+}
+
+bool linalg_eigenvalues( ub::matrix<double> &A, ub::vector<double> &E, ub::matrix<double> &V)
+{
+    V = A;
+    return lapack_eigenvalues(E, V);
+}
+
+bool linalg_eigenvalues( ub::vector<double> &E, ub::matrix<double> &V)
+{
+    return lapack_eigenvalues(E, V);
+}
+
+bool linalg_eigenvalues( ub::vector<float> &E, ub::matrix<float> &V)
+{
+    return lapack_eigenvalues(E, V);
+}
+
+bool linalg_eigenvalues( ub::matrix<double> &A, ub::vector<double> &E, ub::matrix<double> &V , int nmax)
+{
+    return lapack_eigenvalues(A, E, V, nmax);
+}
+
+bool linalg_eigenvalues( ub::matrix<float> &A, ub::vector<float> &E, ub::matrix<float> &V , int nmax)
+{
+    return lapack_eigenvalues(A, E, V, nmax);
+}
+
+/* calculate the eigenvalues and vectors of the generalized eigenvalue problem,
+ * the eigenvectors are normalized to trans(V)*B*V = 1 */
+bool linalg_eigenvalues_general( ub::matrix<double> &A,ub::matrix<double> &B, ub::vector<double> &E, ub::matrix<double> &V)
+{
+    int n = A.size1();
+    if(B.size1() != A.size1() || B.size2() != A.size2())
+        throw std::invalid_argument("linalg_eigenvalues_general: matrices A and B have not the same size");
+
+    E.resize(n, false);
+    V = A;
+    if(n == 0) return true;
+
+    // dsygvd destroys B
+    ub::matrix<double> work_B = B;
+
+    int itype = 1;
+    char jobz = 'V';
+    char uplo = 'U';
+    int info;
+
+    // workspace query
+    double wkopt;
+    int iwkopt;
+    int lwork = -1;
+    int liwork = -1;
+    dsygvd_(&itype, &jobz, &uplo, &n, &V(0,0), &n, &work_B(0,0), &n, &E(0),
+            &wkopt, &lwork, &iwkopt, &liwork, &info);
+    lwork = lapack_worksize(wkopt);
+    liwork = lapack_worksize(iwkopt);
+    vector<double> work(lwork);
+    vector<int> iwork(liwork);
+
+    dsygvd_(&itype, &jobz, &uplo, &n, &V(0,0), &n, &work_B(0,0), &n, &E(0),
+            &work[0], &lwork, &iwork[0], &liwork, &info);
+
+    lapack_transpose(&V(0,0), n);
+    return info == 0;
+}
+
+}}
@@ -0,0 +1,49 @@
+/*
+ * Copyright 2009-2014 The VOTCA Development Team (http://www.votca.org)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <votca/tools/linalg.h>
+#include <stdexcept>
+#include <vector>
+#include "lapack_interface.h"
+
+namespace votca { namespace tools {
+
+using namespace std;
+
+
+void linalg_invert( ub::matrix<double> &A, ub::matrix<double> &V){
+    // matrix inversion using LU decomposition (dgetrf/dgetri)
+    // inv(A^T) = inv(A)^T, so the row-major storage can be used as it is
+    int n = A.size1();
+    int info;
+    V = A;
+    if(n == 0) return;
+
+    vector<int> ipiv(n);
+    dgetrf_(&n, &n, &V(0,0), &n, &ipiv[0], &info);
+    if ( info != 0 )
+        throw std::runtime_error("linalg_invert: matrix is singular");
+
+    double wkopt;
+    int lwork = -1;
+    dgetri_(&n, &V(0,0), &n, &ipiv[0], &wkopt, &lwork, &info);
+    lwork = lapack_worksize(wkopt);
+    vector<double> work(lwork);
+    dgetri_(&n, &V(0,0), &n, &ipiv[0], &work[0], &lwork, &info);
+}
+
+}}
@@ -0,0 +1,102 @@
+/*
+ * Copyright 2009-2014 The VOTCA Development Team (http://www.votca.org)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#ifndef __VOTCA_TOOLS_LAPACK_INTERFACE_H
+#define	__VOTCA_TOOLS_LAPACK_INTERFACE_H
+
+#include <algorithm>
+
+/*
+ * Prototypes of the Fortran LAPACK routines used by the lapack backend.
+ * They are provided by every LAPACK implementation (reference LAPACK,
+ * OpenBLAS, ATLAS, ...), so no LAPACKE or vendor header is needed.
+ *
+ * LAPACK works on column-major storage, while ublas::matrix is row-major.
+ * The storage of a row-major matrix is the column-major storage of its
+ * transpose, so symmetric matrices can be passed as they are and the
+ * other routines are called on the transposed problem where possible.
+ */
+extern "C" {
+    void dpotrf_(const char *uplo, const int *n, double *a, const int *lda, int *info);
+    void dpotrs_(const char *uplo, const int *n, const int *nrhs, const double *a,
+            const int *lda, double *b, const int *ldb, int *info);
+
+    void dgetrf_(const int *m, const int *n, double *a, const int *lda, int *ipiv, int *info);
+    void dgetri_(const int *n, double *a, const int *lda, const int *ipiv,
+            double *work, const int *lwork, int *info);
+
+    void dgetrs_(const char *trans, const int *n, const int *nrhs, const double *a,
+            const int *lda, const int *ipiv, double *b, const int *ldb, int *info);
+
+    void dgels_(const char *trans, const int *m, const int *n, const int *nrhs,
+            double *a, const int *lda, double *b, const int *ldb,
+            double *work, const int *lwork, int *info);
+    void dgeqrf_(const int *m, const int *n, double *a, const int *lda, double *tau,
+            double *work, const int *lwork, int *info);
+    void dormqr_(const char *side, const char *trans, const int *m, const int *n,
+            const int *k, const double *a, const int *lda, const double *tau,
+            double *c, const int *ldc, double *work, const int *lwork, int *info);
+    void dtrtrs_(const char *uplo, const char *trans, const char *diag, const int *n,
+            const int *nrhs, const double *a, const int *lda, double *b,
+            const int *ldb, int *info);
+
+    void dsyevd_(const char *jobz, const char *uplo, const int *n, double *a,
+            const int *lda, double *w, double *work, const int *lwork,
+            int *iwork, const int *liwork, int *info);
+    void ssyevd_(const char *jobz, const char *uplo, const int *n, float *a,
+            const int *lda, float *w, float *work, const int *lwork,
+            int *iwork, const int *liwork, int *info);
+    void dsyevr_(const char *jobz, const char *range, const char *uplo, const int *n,
+            double *a, const int *lda, const double *vl, const double *vu,
+            const int *il, const int *iu, const double *abstol, int *m, double *w,
+            double *z, const int *ldz, int *isuppz, double *work, const int *lwork,
+            int *iwork, const int *liwork, int *info);
+    void ssyevr_(const char *jobz, const char *range, const char *uplo, const int *n,
+            float *a, const int *lda, const float *vl, const float *vu,
+            const int *il, const int *iu, const float *abstol, int *m, float *w,
+            float *z, const int *ldz, int *isuppz, float *work, const int *lwork,
+            int *iwork, const int *liwork, int *info);
+    void dsygvd_(const int *itype, const char *jobz, const char *uplo, const int *n,
+            double *a, const int *lda, double *b, const int *ldb, double *w,
+            double *work, const int *lwork, int *iwork, const int *liwork, int *info);
+
+    void dgesvd_(const char *jobu, const char *jobvt, const int *m, const int *n,
+            double *a, const int *lda, double *s, double *u, const int *ldu,
+            double *vt, const int *ldvt, double *work, const int *lwork, int *info);
+}
+
+namespace votca { namespace tools {
+
+/// \brief transpose the row-major storage of a square matrix in place
+template<typename T>
+inline void lapack_transpose(T *a, int n)
+{
+    for(int i=0; i<n; ++i)
+        for(int j=i+1; j<n; ++j)
+            std::swap(a[i*n+j], a[j*n+i]);
+}
+
+/// \brief size of a workspace as returned by a LAPACK workspace query
+template<typename T>
+inline int lapack_worksize(T query)
+{
+    return std::max(1, (int)query);
+}
+
+}}
+
+#endif	/* __VOTCA_TOOLS_LAPACK_INTERFACE_H */
@@ -0,0 +1,161 @@
+/*
+ * Copyright 2009-2014 The VOTCA Development Team (http://www.votca.org)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <votca/tools/linalg.h>
+#include <stdexcept>
+#include <vector>
+#include <math.h>
+#include "lapack_interface.h"
+
+namespace votca { namespace tools {
+
+using namespace std;
+
+namespace {
+
+// least-squares solution of the M x N system whose row-major storage
+// is passed in a, LAPACK sees it as the transposed N x M matrix
+void lapack_lssolve(double *a, int lda, int m, int n, const ub::vector<double> &b,
+        ub::vector<double> &x)
+{
+    char trans = 'T';
+    int nrhs = 1;
+    int ldb = max(1, max(m, n));
+    int info;
+
+    vector<double> rhs(ldb, 0.0);
+    copy(b.begin(), b.end(), rhs.begin());
+
+    double wkopt;
+    int lwork = -1;
+    dgels_(&trans, &n, &m, &nrhs, a, &lda, &rhs[0], &ldb, &wkopt, &lwork, &info);
+    lwork = lapack_worksize(wkopt);
+    vector<double> work(lwork);
+    dgels_(&trans, &n, &m, &nrhs, a, &lda, &rhs[0], &ldb, &work[0], &lwork, &info);
+
+    if ( info != 0 )
+        throw std::runtime_error("QR least-squares solver failed");
+
+    x.resize(n);
+    copy(rhs.begin(), rhs.begin() + n, x.begin());
+}
+
+// apply Q or Q^T of a QR decomposition (dgeqrf) from the left to the
+// column-major m x n matrix c
+void lapack_apply_q(char trans, int m, int n, int k, const double *a, const double *tau, double *c)
+{
+    char side = 'L';
+    int info;
+    double wkopt;
+    int lwork = -1;
+    dormqr_(&side, &trans, &m, &n, &k, a, &m, tau, c, &m, &wkopt, &lwork, &info);
+    lwork = lapack_worksize(wkopt);
+    vector<double> work(lwork);
+    dormqr_(&side, &trans, &m, &n, &k, a, &m, tau, c, &m, &work[0], &lwork, &info);
+}
+
+}
+
+void linalg_qrsolve(ub::vector<double> &x, ub::matrix<double> &A, ub::vector<double> &b, ub::vector<double> *residual)
+{
+    // check matrix for zero column
+    int nonzero_found = 0;
+    for(size_t j=0; j<A.size2(); j++) {
+        nonzero_found = 0;
+        for(size_t i=0; i<A.size1(); i++) {
+            if(fabs(A(i,j))>0) {
+                nonzero_found = 1;
+            }
+        }
+        if(nonzero_found==0) {
+            throw "qrsolve_zero_column_in_matrix";
+        }
+    }
+
+    const int M = A.size1();
+    const int N = A.size2();
+
+    // dgels overwrites A, keep a copy if the residual is needed
+    ub::matrix<double> A_copy;
+    if(residual)
+        A_copy = A;
+
+    // x and b might be the same vector
+    ub::vector<double> sol;
+    lapack_lssolve(&A(0,0), N, M, N, b, sol);
+
+    if(residual)
+        *residual = b - ub::prod(A_copy, sol);
+    x = sol;
+}
+
+void linalg_constrained_qrsolve(ub::vector<double> &x, ub::matrix<double> &A, ub::vector<double> &b, ub::matrix<double> &constr)
+{
+    // check matrix for zero column
+    int nonzero_found = 0;
+    for(size_t j=0; j<A.size2(); j++) {
+        nonzero_found = 0;
+        for(size_t i=0; i<A.size1(); i++) {
+            if(fabs(A(i,j))>0) {
+                nonzero_found = 1;
+            }
+        }
+        if(nonzero_found==0) {
+            throw std::runtime_error("constrained_qrsolve_zero_column_in_matrix");
+        }
+    }
+
+    const int N = A.size1();
+    const int nvar = A.size2();
+    const int nconstr = constr.size1();
+    if((int)constr.size2() != nvar || nconstr > nvar)
+        throw std::invalid_argument("linalg_constrained_qrsolve: sizes of A and constr do not match");
+
+    // QR decomposition of trans(constr) = Q R, the row-major storage of
+    // constr is trans(constr) in column-major order
+    vector<double> tau(max(1, nconstr));
+    {
+        int info;
+        double wkopt;
+        int lwork = -1;
+        dgeqrf_(&nvar, &nconstr, &constr(0,0), &nvar, &tau[0], &wkopt, &lwork, &info);
+        lwork = lapack_worksize(wkopt);
+        vector<double> work(lwork);
+        dgeqrf_(&nvar, &nconstr, &constr(0,0), &nvar, &tau[0], &work[0], &lwork, &info);
+    }
+
+    // with x = Q y the constraint only fixes the first nconstr entries of
+    // y to zero, calculate A * Q (as trans(Q) * trans(A)) and store the result in A
+    lapack_apply_q('T', nvar, N, nconstr, &constr(0,0), &tau[0], &A(0,0));
+
+    // A = [A1 A2], solve A2 * z = b for the free part of y
+    ub::vector<double> z;
+    lapack_lssolve(&A(0,0) + nconstr, nvar, N, nvar - nconstr, b, z);
+
+    x.resize(nvar);
+    for (int i = 0; i < nconstr; i++ )
+        x[i] = 0.0;
+    for (int i = nconstr; i < nvar; i++ )
+        x[i] = z(i - nconstr);
+
+    // To get the final answer this vector should be multiplied by matrix Q,
+    // the sign is the same as in the gsl backend
+    lapack_apply_q('N', nvar, 1, nconstr, &constr(0,0), &tau[0], &x(0));
+    x = -x;
+}
+
+}}
@@ -0,0 +1,383 @@
+/*
+ * Copyright 2009-2014 The VOTCA Development Team (http://www.votca.org)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <votca/tools/linalgsolvers.h>
+#include <stdexcept>
+#include <vector>
+#include <math.h>
+#include "lapack_interface.h"
+
+namespace votca { namespace tools {
+
+using namespace std;
+
+/*
+ * The workspaces only grow, LAPACK workspace queries are repeated only
+ * if the problem size changes.
+ */
+
+struct QRSolver::workspace_t {
+    workspace_t() : m(0), n(0), lwork_m(-1), lwork_n(-1), decomposed(false) {}
+
+    int m, n;
+    // size the workspace query was done for
+    int lwork_m, lwork_n;
+    bool decomposed;
+    // QR factors of A in column-major order, as returned by dgeqrf
+    vector<double> qr;
+    vector<double> tau;
+    vector<double> rhs;
+    vector<double> work;
+};
+
+QRSolver::QRSolver()
+    : _ws(new workspace_t), _check_zero_columns(true)
+{
+}
+
+QRSolver::~QRSolver()
+{
+    delete _ws;
+}
+
+void QRSolver::Decompose(const ub::matrix<double> &A)
+{
+    workspace_t &ws = *_ws;
+    const int m = A.size1();
+    const int n = A.size2();
+    if(m < n)
+        throw std::invalid_argument("QRSolver: matrix has more columns than rows");
+
+    if(_check_zero_columns) {
+        for(int j=0; j<n; j++) {
+            int i;
+            for(i=0; i<m; i++)
+                if(A(i,j) != 0) break;
+            if(i==m)
+                throw std::runtime_error("QRSolver: zero column in matrix");
+        }
+    }
+
+    ws.decomposed = false;
+    ws.m = m;
+    ws.n = n;
+    ws.qr.resize(m*n);
+    ws.tau.resize(max(1, n));
+    ws.rhs.resize(max(1, m));
+    for(int i=0; i<m; i++)
+        for(int j=0; j<n; j++)
+            ws.qr[i + j*m] = A(i,j);
+    if(m == 0 || n == 0) {
+        ws.decomposed = true;
+        return;
+    }
+
+    int info;
+    int lwork = -1;
+    if(ws.lwork_m != m || ws.lwork_n != n) {
+        // one workspace for dgeqrf and dormqr
+        double wkopt;
+        char side = 'L';
+        char trans = 'T';
+        int nrhs = 1;
+        dgeqrf_(&m, &n, &ws.qr[0], &m, &ws.tau[0], &wkopt, &lwork, &info);
+        int size = lapack_worksize(wkopt);
+        dormqr_(&side, &trans, &m, &nrhs, &n, &ws.qr[0], &m, &ws.tau[0],
+                &ws.rhs[0], &m, &wkopt, &lwork, &info);
+        size = max(size, lapack_worksize(wkopt));
+        if((int)ws.work.size() < size)
+            ws.work.resize(size);
+        ws.lwork_m = m;
+        ws.lwork_n = n;
+    }
+    lwork = ws.work.size();
+
+    dgeqrf_(&m, &n, &ws.qr[0], &m, &ws.tau[0], &ws.work[0], &lwork, &info);
+    ws.decomposed = true;
+}
+
+void QRSolver::Solve(ub::vector<double> &x, const ub::vector<double> &b, ub::vector<double> *residual)
+{
+    workspace_t &ws = *_ws;
+    if(!ws.decomposed)
+        throw std::runtime_error("QRSolver: no matrix decomposed");
+    if((int)b.size() != ws.m)
+        throw std::invalid_argument("QRSolver: size of b does not match the matrix");
+
+    const int m = ws.m;
+    const int n = ws.n;
+    int info;
+    int nrhs = 1;
+    int lwork = ws.work.size();
+    char side = 'L';
+
+    // rhs = trans(Q)*b, solve R*x = rhs[0:n]
+    copy(b.begin(), b.end(), ws.rhs.begin());
+    if(n > 0) {
+        char trans = 'T';
+        dormqr_(&side, &trans, &m, &nrhs, &n, &ws.qr[0], &m, &ws.tau[0],
+                &ws.rhs[0], &m, &ws.work[0], &lwork, &info);
+        char uplo = 'U', notrans = 'N', diag = 'N';
+        dtrtrs_(&uplo, &notrans, &diag, &n, &nrhs, &ws.qr[0], &m, &ws.rhs[0], &m, &info);
+        if(info != 0)
+            throw std::runtime_error("QRSolver: matrix is rank deficient");
+    }
+
+    // b is not used any more, so x and b may be the same vector
+    x.resize(n, false);
+    copy(ws.rhs.begin(), ws.rhs.begin() + n, x.begin());
+
+    if(residual) {
+        // residual = Q*[0, rhs[n:m]]
+        fill(ws.rhs.begin(), ws.rhs.begin() + n, 0.0);
+        if(n > 0) {
+            char trans = 'N';
+            dormqr_(&side, &trans, &m, &nrhs, &n, &ws.qr[0], &m, &ws.tau[0],
+                    &ws.rhs[0], &m, &ws.work[0], &lwork, &info);
+        }
+        residual->resize(m, false);
+        copy(ws.rhs.begin(), ws.rhs.begin() + m, residual->begin());
+    }
+}
+
+
+struct CholeskySolver::workspace_t {
+    workspace_t() : n(0), decomposed(false) {}
+
+    int n;
+    bool decomposed;
+    // Cholesky factor, upper triangle in column-major order
+    vector<double> l;
+    vector<double> rhs;
+};
+
+CholeskySolver::CholeskySolver()
+    : _ws(new workspace_t)
+{
+}
+
+CholeskySolver::~CholeskySolver()
+{
+    delete _ws;
+}
+
+void CholeskySolver::Decompose(const ub::matrix<double> &A)
+{
+    workspace_t &ws = *_ws;
+    const int n = A.size1();
+    if((int)A.size2() != n)
+        throw std::invalid_argument("CholeskySolver: matrix is not square");
+
+    ws.decomposed = false;
+    ws.n = n;
+    ws.l.resize(n*n);
+    ws.rhs.resize(max(1, n));
+    // A is symmetric, so the row-major storage can be used as it is
+    copy(A.data().begin(), A.data().end(), ws.l.begin());
+    if(n == 0) {
+        ws.decomposed = true;
+        return;
+    }
+
+    int info;
+    char uplo = 'U';
+    dpotrf_(&uplo, &n, &ws.l[0], &n, &info);
+    if(info != 0)
+        throw std::runtime_error("Matrix not symmetric positive definite");
+    ws.decomposed = true;
+}
+
+void CholeskySolver::Solve(ub::vector<double> &x, const ub::vector<double> &b)
+{
+    workspace_t &ws = *_ws;
+    if(!ws.decomposed)
+        throw std::runtime_error("CholeskySolver: no matrix decomposed");
+    if((int)b.size() != ws.n)
+        throw std::invalid_argument("CholeskySolver: size of b does not match the matrix");
+
+    const int n = ws.n;
+    copy(b.begin(), b.end(), ws.rhs.begin());
+    if(n > 0) {
+        int info;
+        int nrhs = 1;
+        char uplo = 'U';
+        dpotrs_(&uplo, &n, &nrhs, &ws.l[0], &n, &ws.rhs[0], &n, &info);
+    }
+    x.resize(n, false);
+    copy(ws.rhs.begin(), ws.rhs.begin() + n, x.begin());
+}
+
+
+struct LUSolver::workspace_t {
+    workspace_t() : n(0), lwork_n(-1), decomposed(false) {}
+
+    int n;
+    // size the workspace query of dgetri was done for
+    int lwork_n;
+    bool decomposed;
+    // LU factors of trans(A) in column-major order (= row-major storage of A)
+    vector<double> lu;
+    vector<int> ipiv;
+    vector<double> rhs;
+    vector<double> work;
+};
+
+LUSolver::LUSolver()
+    : _ws(new workspace_t)
+{
+}
+
+LUSolver::~LUSolver()
+{
+    delete _ws;
+}
+
+void LUSolver::Decompose(const ub::matrix<double> &A)
+{
+    workspace_t &ws = *_ws;
+    const int n = A.size1();
+    if((int)A.size2() != n)
+        throw std::invalid_argument("LUSolver: matrix is not square");
+
+    ws.decomposed = false;
+    ws.n = n;
+    ws.lu.resize(n*n);
+    ws.ipiv.resize(max(1, n));
+    ws.rhs.resize(max(1, n));
+    copy(A.data().begin(), A.data().end(), ws.lu.begin());
+    if(n == 0) {
+        ws.decomposed = true;
+        return;
+    }
+
+    int info;
+    dgetrf_(&n, &n, &ws.lu[0], &n, &ws.ipiv[0], &info);
+    if(info != 0)
+        throw std::runtime_error("LUSolver: matrix is singular");
+    ws.decomposed = true;
+}
+
+void LUSolver::Solve(ub::vector<double> &x, const ub::vector<double> &b)
+{
+    workspace_t &ws = *_ws;
+    if(!ws.decomposed)
+        throw std::runtime_error("LUSolver: no matrix decomposed");
+    if((int)b.size() != ws.n)
+        throw std::invalid_argument("LUSolver: size of b does not match the matrix");
+
+    const int n = ws.n;
+    copy(b.begin(), b.end(), ws.rhs.begin());
+    if(n > 0) {
+        // the factors are the ones of trans(A)
+        int info;
+        int nrhs = 1;
+        char trans = 'T';
+        dgetrs_(&trans, &n, &nrhs, &ws.lu[0], &n, &ws.ipiv[0], &ws.rhs[0], &n, &info);
+    }
+    x.resize(n, false);
+    copy(ws.rhs.begin(), ws.rhs.begin() + n, x.begin());
+}
+
+void LUSolver::Invert(ub::matrix<double> &V)
+{
+    workspace_t &ws = *_ws;
+    if(!ws.decomposed)
+        throw std::runtime_error("LUSolver: no matrix decomposed");
+
+    const int n = ws.n;
+    V.resize(n, n, false);
+    if(n == 0) return;
+
+    int info;
+    int lwork = -1;
+    if(ws.lwork_n != n) {
+        double wkopt;
+        dgetri_(&n, &ws.lu[0], &n, &ws.ipiv[0], &wkopt, &lwork, &info);
+        int size = lapack_worksize(wkopt);
+        if((int)ws.work.size() < size)
+            ws.work.resize(size);
+        ws.lwork_n = n;
+    }
+    lwork = ws.work.size();
+
+    // inv(trans(A)) in column-major order is inv(A) in row-major order,
+    // keep the factors for further solves
+    copy(ws.lu.begin(), ws.lu.end(), V.data().begin());
+    dgetri_(&n, &V(0,0), &n, &ws.ipiv[0], &ws.work[0], &lwork, &info);
+    if(info != 0)
+        throw std::runtime_error("LUSolver: matrix is singular");
+}
+
+
+struct EigenSolver::workspace_t {
+    workspace_t() : lwork_n(-1) {}
+
+    // size the workspace query of dsyevd was done for
+    int lwork_n;
+    vector<double> work;
+    vector<int> iwork;
+};
+
+EigenSolver::EigenSolver()
+    : _ws(new workspace_t)
+{
+}
+
+EigenSolver::~EigenSolver()
+{
+    delete _ws;
+}
+
+bool EigenSolver::Solve(const ub::matrix<double> &A, ub::vector<double> &E, ub::matrix<double> &V)
+{
+    workspace_t &ws = *_ws;
+    int n = A.size1();
+    if((int)A.size2() != n)
+        throw std::invalid_argument("EigenSolver: matrix is not square");
+
+    E.resize(n, false);
+    V.resize(n, n, false);
+    if(n == 0) return true;
+    copy(A.data().begin(), A.data().end(), V.data().begin());
+
+    char jobz = 'V';
+    char uplo = 'U';
+    int info;
+    int lwork = -1;
+    int liwork = -1;
+    if(ws.lwork_n != n) {
+        double wkopt;
+        int iwkopt;
+        dsyevd_(&jobz, &uplo, &n, &V(0,0), &n, &E(0), &wkopt, &lwork, &iwkopt, &liwork, &info);
+        if((int)ws.work.size() < lapack_worksize(wkopt))
+            ws.work.resize(lapack_worksize(wkopt));
+        if((int)ws.iwork.size() < lapack_worksize(iwkopt))
+            ws.iwork.resize(lapack_worksize(iwkopt));
+        ws.lwork_n = n;
+    }
+    lwork = ws.work.size();
+    liwork = ws.iwork.size();
+
+    dsyevd_(&jobz, &uplo, &n, &V(0,0), &n, &E(0), &ws.work[0], &lwork,
+            &ws.iwork[0], &liwork, &info);
+
+    // LAPACK returns the eigenvectors as columns in column-major order
+    lapack_transpose(&V(0,0), n);
+    return info == 0;
+}
+
+}}
@@ -0,0 +1,71 @@
+/*
+ * Copyright 2009-2014 The VOTCA Development Team (http://www.votca.org)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <votca/tools/linalg.h>
+#include <stdexcept>
+#include <vector>
+#include "lapack_interface.h"
+
+namespace votca { namespace tools {
+
+using namespace std;
+
+/**
+ * ublas binding to LAPACK Singular Value Decomposition (dgesvd)
+ * 
+ * A = U S V^T
+ * 
+ * @param A MxN matrix do decompose (M >= N). Becomes an MxN orthogonal matrix U
+ * @param V NxN orthogonal square matrix
+ * @param S N singular values in descending order
+ * @return succeeded or not 
+ */
+bool linalg_singular_value_decomposition( ub::matrix<double> &A, ub::matrix<double> &V, ub::vector<double> &S )
+{
+    int m = A.size1();
+    int n = A.size2();
+    if(m < n)
+        throw std::invalid_argument("linalg_singular_value_decomposition: matrix has more columns than rows");
+
+    S.resize(n, false);
+    V.resize(n, n, false);
+    if(n == 0) return true;
+
+    // LAPACK sees the row-major A as trans(A) = V S U^T, so its left
+    // singular vectors are V and its right ones, which are written over
+    // the input, are U in row-major order
+    ub::matrix<double, ub::column_major> U_t(n, n);
+    char jobu = 'S';
+    char jobvt = 'O';
+    int ldvt = 1;
+    double vt;
+    int info;
+
+    double wkopt;
+    int lwork = -1;
+    dgesvd_(&jobu, &jobvt, &n, &m, &A(0,0), &n, &S(0), &U_t(0,0), &n, &vt, &ldvt,
+            &wkopt, &lwork, &info);
+    lwork = lapack_worksize(wkopt);
+    vector<double> work(lwork);
+    dgesvd_(&jobu, &jobvt, &n, &m, &A(0,0), &n, &S(0), &U_t(0,0), &n, &vt, &ldvt,
+            &work[0], &lwork, &info);
+
+    V = U_t;
+    return info == 0;
+}
+
+}}
@@ -15,6 +15,7 @@
  *
  */
 
+#include <stdexcept>
 #include <votca/tools/linalg.h>
 #include <boost/numeric/ublas/matrix_proxy.hpp>
 
@@ -193,6 +194,8 @@ bool linalg_eigenvalues( ub::matrix<double> &A, ub::vector<double> &E, ub::matri
     MKL_INT il, iu, m, ldz ;
     
     int n = A.size1();
+    if(nmax <= 0 || nmax > n)
+        throw std::invalid_argument("linalg_eigenvalues: nmax out of range");
     MKL_INT ifail[n];
     lda = n;
     ldz = nmax;
@@ -247,6 +250,8 @@ bool linalg_eigenvalues( ub::matrix<float> &A, ub::vector<float> &E, ub::matrix<
     MKL_INT il, iu, m, ldz ;
     
     int n = A.size1();
+    if(nmax <= 0 || nmax > n)
+        throw std::invalid_argument("linalg_eigenvalues: nmax out of range");
     MKL_INT ifail[n];
     lda = n;
     ldz = nmax;
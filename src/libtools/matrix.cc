@@ -17,18 +17,29 @@
 
 #include <math.h>
 #include <stdlib.h>
+#include <algorithm>
 #include <votca/tools/matrix.h>
 
 #define PITIMES2 2*3.141592654
 
 namespace votca { namespace tools {
 
-void matrix::RandomRotation()
+template<typename T>
+void matrix_t<T>::RandomRotation()
 {
-    matrix &M=(*this);
-    double theta = drand48() * PITIMES2; /* Rotation about the pole (Z).      */
-    double phi   = drand48() * PITIMES2; /* For direction of pole deflection. */
-    double z     = drand48() * 2.0;      /* For magnitude of pole deflection. */
+    double u1 = drand48();
+    double u2 = drand48();
+    double u3 = drand48();
+    RotationFromUniform(u1, u2, u3);
+}
+
+template<typename T>
+void matrix_t<T>::RotationFromUniform(double u1, double u2, double u3)
+{
+    matrix_t &M=(*this);
+    double theta = u1 * PITIMES2; /* Rotation about the pole (Z).      */
+    double phi   = u2 * PITIMES2; /* For direction of pole deflection. */
+    double z     = u3 * 2.0;      /* For magnitude of pole deflection. */
 
     /* Compute a vector V used for distributing points over the sphere  */
     /* via the reflection I - V Transpose(V).  This formulation of V    */
@@ -119,20 +130,183 @@ int cjcbi(matrix &a, matrix &v, double eps, int jt)
       }
     return(1);
 }
-using namespace std;
-void matrix::SolveEigensystem(eigensystem_t &out)
+namespace {
+
+/// matrices with a smaller relative eigenvalue spread are solved by cjcbi
+const double ANALYTIC_MIN_SPREAD = 1e-5;
+
+/**
+ * upper triangle of a symmetric matrix, scaled by the largest element
+ * (to avoid over- and underflow) and shifted by its mean eigenvalue
+ */
+struct sym3_t {
+    double a00, a01, a02, a11, a12, a22;
+    double scale, shift;
+    /// eigenvalues in ascending order, in scaled and shifted units
+    double l0, l1, l2;
+    /// p = sqrt(tr(B^2)/6) of the shifted matrix B, zero for isotropic ones
+    double spread;
+};
+
+template<typename T>
+inline void sym3_load(const matrix_t<T> &m, sym3_t &s)
+{
+    s.a00 = m.get(0,0);
+    s.a11 = m.get(1,1);
+    s.a22 = m.get(2,2);
+    s.a01 = 0.5*(m.get(0,1) + m.get(1,0));
+    s.a02 = 0.5*(m.get(0,2) + m.get(2,0));
+    s.a12 = 0.5*(m.get(1,2) + m.get(2,1));
+}
+
+/**
+ * trigonometric solution of the characteristic polynomial, written
+ * without branches so loops over many matrices can be vectorized
+ */
+inline void sym3_eigenvalues(sym3_t &s)
+{
+    double scale = fmax(fmax(fmax(fabs(s.a00), fabs(s.a11)), fmax(fabs(s.a22), fabs(s.a01))),
+            fmax(fabs(s.a02), fabs(s.a12)));
+    double inv = scale > 0 ? 1./scale : 0.;
+    double a00 = s.a00*inv, a11 = s.a11*inv, a22 = s.a22*inv;
+    double a01 = s.a01*inv, a02 = s.a02*inv, a12 = s.a12*inv;
+
+    double q = (a00 + a11 + a22)/3.;
+    double b00 = a00 - q, b11 = a11 - q, b22 = a22 - q;
+    double p = sqrt((b00*b00 + b11*b11 + b22*b22
+            + 2.*(a01*a01 + a02*a02 + a12*a12))/6.);
+    double pinv = p > 0 ? 1./p : 0.;
+
+    // r = det(B/p)/2 is in [-1,1] up to rounding
+    double det = b00*(b11*b22 - a12*a12) - a01*(a01*b22 - a12*a02)
+            + a02*(a01*a12 - b11*a02);
+    double r = fmin(fmax(0.5*det*pinv*pinv*pinv, -1.), 1.);
+    double phi = acos(r)/3.;
+
+    s.a00 = b00; s.a11 = b11; s.a22 = b22;
+    s.a01 = a01; s.a02 = a02; s.a12 = a12;
+    s.scale = scale;
+    s.shift = q;
+    s.spread = p;
+    s.l2 = 2.*p*cos(phi);
+    s.l0 = 2.*p*cos(phi + 2.*M_PI/3.);
+    // the trace is zero, clamp to keep the order in spite of rounding
+    s.l1 = fmin(fmax(-s.l0 - s.l2, s.l0), s.l2);
+}
+
+/// eigenvector of the (scaled and shifted) matrix for an isolated eigenvalue
+inline vec sym3_eigenvector(const sym3_t &s, double l)
+{
+    vec r0(s.a00 - l, s.a01, s.a02);
+    vec r1(s.a01, s.a11 - l, s.a12);
+    vec r2(s.a02, s.a12, s.a22 - l);
+    // the rows span the plane orthogonal to the eigenvector, take the
+    // largest cross product for accuracy
+    vec c01 = r0^r1, c02 = r0^r2, c12 = r1^r2;
+    double d01 = c01*c01, d02 = c02*c02, d12 = c12*c12;
+    if(d01 >= d02 && d01 >= d12) return c01/sqrt(d01);
+    if(d02 >= d12) return c02/sqrt(d02);
+    return c12/sqrt(d12);
+}
+
+inline vec sym3_times(const sym3_t &s, const vec &v)
+{
+    return vec(s.a00*v.getX() + s.a01*v.getY() + s.a02*v.getZ(),
+               s.a01*v.getX() + s.a11*v.getY() + s.a12*v.getZ(),
+               s.a02*v.getX() + s.a12*v.getY() + s.a22*v.getZ());
+}
+
+/**
+ * eigenpairs in the plane orthogonal to the eigenvector w. The 2x2 problem
+ * in this plane is diagonalized by a Jacobi rotation, so a (nearly)
+ * degenerate pair does not suffer from the limited accuracy of the
+ * trigonometric eigenvalues. Returns la <= lb.
+ */
+inline void sym3_eigenpairs_orthogonal(const sym3_t &s, const vec &w,
+        vec &a, double &la, vec &b, double &lb)
+{
+    vec u;
+    if(fabs(w.getX()) > fabs(w.getY()))
+        u = vec(-w.getZ(), 0., w.getX())/sqrt(w.getX()*w.getX() + w.getZ()*w.getZ());
+    else
+        u = vec(0., w.getZ(), -w.getY())/sqrt(w.getY()*w.getY() + w.getZ()*w.getZ());
+    vec v = w^u;
+
+    vec Au = sym3_times(s, u), Av = sym3_times(s, v);
+    double m00 = u*Au, m01 = u*Av, m11 = v*Av;
+    double c = 1., sn = 0., t = 0.;
+    if(m01 != 0) {
+        double theta = (m11 - m00)/(2.*m01);
+        t = 1./(fabs(theta) + sqrt(theta*theta + 1.));
+        if(theta < 0) t = -t;
+        c = 1./sqrt(t*t + 1.);
+        sn = t*c;
+    }
+    la = m00 - t*m01;
+    lb = m11 + t*m01;
+    a = c*u - sn*v;
+    b = sn*u + c*v;
+    if(la > lb) {
+        std::swap(la, lb);
+        std::swap(a, b);
+    }
+}
+
+/// returns false if the matrix has to be solved by cjcbi
+inline bool sym3_eigensystem(const sym3_t &s, matrix::eigensystem_t &out)
+{
+    if(s.scale == 0 || s.spread < ANALYTIC_MIN_SPREAD)
+        return false;
+
+    vec v0, v1, v2;
+    double l0, l1, l2;
+    // start with the eigenvalue furthest away from the others, its
+    // eigenvector is well conditioned
+    if(s.l2 - s.l1 >= s.l1 - s.l0) {
+        v2 = sym3_eigenvector(s, s.l2);
+        l2 = v2*sym3_times(s, v2);
+        sym3_eigenpairs_orthogonal(s, v2, v0, l0, v1, l1);
+    }
+    else {
+        v0 = sym3_eigenvector(s, s.l0);
+        l0 = v0*sym3_times(s, v0);
+        sym3_eigenpairs_orthogonal(s, v0, v1, l1, v2, l2);
+    }
+    // keep the system right handed
+    if((v0^v1)*v2 < 0)
+        v0 = -v0;
+
+    out.eigenvalues[0] = (l0 + s.shift)*s.scale;
+    out.eigenvalues[1] = (l1 + s.shift)*s.scale;
+    out.eigenvalues[2] = (l2 + s.shift)*s.scale;
+    out.eigenvecs[0] = v0;
+    out.eigenvecs[1] = v1;
+    out.eigenvecs[2] = v2;
+    return true;
+}
+
+/**
+ * the old Jacobi path, used for nearly isotropic matrices. cjcbi stops at
+ * an absolute threshold, so it gets the shifted matrix divided by its
+ * spread, otherwise small or nearly isotropic matrices are hardly rotated.
+ */
+inline void jacobi_eigensystem(const sym3_t &s, matrix::eigensystem_t &out)
 {
-    matrix m(*this);
+    double inv = s.spread > 0 ? 1./s.spread : 0.;
+    matrix m;
+    m[0][0] = s.a00*inv; m[1][1] = s.a11*inv; m[2][2] = s.a22*inv;
+    m[0][1] = m[1][0] = s.a01*inv;
+    m[0][2] = m[2][0] = s.a02*inv;
+    m[1][2] = m[2][1] = s.a12*inv;
     matrix v;
     cjcbi(m, v);
 
     for(int i=0; i<3; ++i) {
-        out.eigenvalues[i] = m[i][i];
+        out.eigenvalues[i] = (m[i][i]*s.spread + s.shift)*s.scale;
         out.eigenvecs[i] = vec(v[0][i], v[1][i], v[2][i]);
         out.eigenvecs[i].normalize();
     }
 
-    //cout << v << endl;
     // sort by eigenvalues
     if(out.eigenvalues[0] > out.eigenvalues[1]) {
         std::swap(out.eigenvalues[0], out.eigenvalues[1]);
@@ -148,10 +322,58 @@ void matrix::SolveEigensystem(eigensystem_t &out)
     }    
 }
 
-void matrix::Invert()
+/// eigensystems are always solved in double precision
+template<typename T>
+inline void convert_eigensystem(const matrix::eigensystem_t &in,
+        typename matrix_t<T>::eigensystem_t &out)
 {
-    matrix mi;
-    matrix &m=*this;
+    for(int i=0; i<3; ++i) {
+        out.eigenvalues[i] = in.eigenvalues[i];
+        out.eigenvecs[i] = vec_t<T>(in.eigenvecs[i]);
+    }
+}
+
+}
+
+template<typename T>
+void matrix_t<T>::SolveEigensystem(eigensystem_t &out)
+{
+    sym3_t s;
+    sym3_load(*this, s);
+    sym3_eigenvalues(s);
+    matrix::eigensystem_t e;
+    if(!sym3_eigensystem(s, e))
+        jacobi_eigensystem(s, e);
+    convert_eigensystem<T>(e, out);
+}
+
+template<typename T>
+void SolveEigensystems(const matrix_t<T> *m, typename matrix_t<T>::eigensystem_t *out, size_t n)
+{
+    const size_t block = 64;
+    sym3_t s[block];
+    matrix::eigensystem_t e;
+
+    for(size_t first = 0; first < n; first += block) {
+        size_t count = std::min(block, n - first);
+        for(size_t i = 0; i < count; ++i)
+            sym3_load(m[first + i], s[i]);
+        // no branches in here, this is the loop that vectorizes
+        for(size_t i = 0; i < count; ++i)
+            sym3_eigenvalues(s[i]);
+        for(size_t i = 0; i < count; ++i) {
+            if(!sym3_eigensystem(s[i], e))
+                jacobi_eigensystem(s[i], e);
+            convert_eigensystem<T>(e, out[first + i]);
+        }
+    }
+}
+
+template<typename T>
+void matrix_t<T>::Invert()
+{
+    matrix_t mi;
+    matrix_t &m=*this;
     mi[0][0] = m[1][1]*m[2][2] - m[1][2]*m[2][1];
     mi[1][0] = m[1][2]*m[2][0] - m[1][0]*m[2][2];
     mi[2][0] = m[1][0]*m[2][1] - m[1][1]*m[2][0];
@@ -163,7 +385,7 @@ void matrix::Invert()
     mi[2][2] = m[0][0]*m[1][1] - m[0][1]*m[1][0];
 
 ///calc the determinant, with the diagonal
-    double D;
+    T D;
 
     D = m[0][0]*mi[0][0] + m[0][1]*mi[1][0] + m[0][2]*mi[2][0];
     
@@ -171,4 +393,9 @@ void matrix::Invert()
     *this = mi;
 }
 
+template class matrix_t<double>;
+template class matrix_t<float>;
+template void SolveEigensystems(const matrix *m, matrix::eigensystem_t *out, size_t n);
+template void SolveEigensystems(const matrixf *m, matrixf::eigensystem_t *out, size_t n);
+
 }}
@@ -0,0 +1,272 @@
+/*
+ * Copyright 2009-2014 The VOTCA Development Team (http://www.votca.org)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <string.h>
+#include <stdexcept>
+#include <votca/tools/matrixarray.h>
+#include "alignedarray.h"
+
+namespace votca { namespace tools {
+
+MatrixArray::MatrixArray()
+    : _size(0), _capacity(0)
+{
+    for(int c = 0; c < 9; ++c) _c[c] = NULL;
+}
+
+MatrixArray::MatrixArray(size_t n)
+    : _size(0), _capacity(0)
+{
+    for(int c = 0; c < 9; ++c) _c[c] = NULL;
+    resize(n);
+}
+
+MatrixArray::MatrixArray(const std::vector<matrix> &m)
+    : _size(0), _capacity(0)
+{
+    for(int c = 0; c < 9; ++c) _c[c] = NULL;
+    FromVector(m);
+}
+
+MatrixArray::MatrixArray(const MatrixArray &a)
+    : _size(0), _capacity(0)
+{
+    for(int c = 0; c < 9; ++c) _c[c] = NULL;
+    *this = a;
+}
+
+MatrixArray::~MatrixArray()
+{
+    free(_c[0]);
+}
+
+MatrixArray &MatrixArray::operator=(const MatrixArray &a)
+{
+    if(this == &a) return *this;
+    resize(a.size());
+    for(int c = 0; c < 9; ++c)
+        memcpy(_c[c], a._c[c], _size*sizeof(double));
+    return *this;
+}
+
+void MatrixArray::reserve(size_t n)
+{
+    aligned_reserve(_c, 9, _size, _capacity, n);
+}
+
+void MatrixArray::resize(size_t n)
+{
+    reserve(n);
+    _size = n;
+}
+
+matrix MatrixArray::operator[](size_t k) const
+{
+    double m[9];
+    for(int c = 0; c < 9; ++c)
+        m[c] = _c[c][k];
+    return matrix(m);
+}
+
+void MatrixArray::set(size_t k, const matrix &m)
+{
+    for(int c = 0; c < 9; ++c)
+        _c[c][k] = m.get(c/3, c%3);
+}
+
+void MatrixArray::push_back(const matrix &m)
+{
+    if(_size == _capacity)
+        reserve(_capacity ? 2*_capacity : 16);
+    set(_size++, m);
+}
+
+void MatrixArray::FromVector(const std::vector<matrix> &m)
+{
+    resize(m.size());
+    for(size_t k = 0; k < m.size(); ++k)
+        set(k, m[k]);
+}
+
+void MatrixArray::ToVector(std::vector<matrix> &m) const
+{
+    m.resize(_size);
+    for(size_t k = 0; k < _size; ++k)
+        m[k] = (*this)[k];
+}
+
+namespace {
+
+/// aligned element arrays of a, row major
+inline void elements(const MatrixArray &a, const double *e[9])
+{
+    for(int c = 0; c < 9; ++c)
+        e[c] = assume_aligned(a.element(c/3, c%3));
+}
+
+inline void elements(MatrixArray &a, double *e[9])
+{
+    for(int c = 0; c < 9; ++c)
+        e[c] = assume_aligned(a.element(c/3, c%3));
+}
+
+}
+
+void multiply(const MatrixArray &a, const MatrixArray &b, MatrixArray &out)
+{
+    check_size(a.size(), b.size());
+    const size_t n = a.size();
+    out.resize(n);
+    const double *x[9], *y[9];
+    double *o[9];
+    elements(a, x);
+    elements(b, y);
+    elements(out, o);
+
+#pragma GCC ivdep
+    for(size_t k = 0; k < n; ++k) {
+        double x00 = x[0][k], x01 = x[1][k], x02 = x[2][k];
+        double x10 = x[3][k], x11 = x[4][k], x12 = x[5][k];
+        double x20 = x[6][k], x21 = x[7][k], x22 = x[8][k];
+        double y00 = y[0][k], y01 = y[1][k], y02 = y[2][k];
+        double y10 = y[3][k], y11 = y[4][k], y12 = y[5][k];
+        double y20 = y[6][k], y21 = y[7][k], y22 = y[8][k];
+        o[0][k] = x00*y00 + x01*y10 + x02*y20;
+        o[1][k] = x00*y01 + x01*y11 + x02*y21;
+        o[2][k] = x00*y02 + x01*y12 + x02*y22;
+        o[3][k] = x10*y00 + x11*y10 + x12*y20;
+        o[4][k] = x10*y01 + x11*y11 + x12*y21;
+        o[5][k] = x10*y02 + x11*y12 + x12*y22;
+        o[6][k] = x20*y00 + x21*y10 + x22*y20;
+        o[7][k] = x20*y01 + x21*y11 + x22*y21;
+        o[8][k] = x20*y02 + x21*y12 + x22*y22;
+    }
+}
+
+void multiply(const matrix &r, const MatrixArray &a, MatrixArray &out)
+{
+    const size_t n = a.size();
+    out.resize(n);
+    const double r00 = r.get(0,0), r01 = r.get(0,1), r02 = r.get(0,2);
+    const double r10 = r.get(1,0), r11 = r.get(1,1), r12 = r.get(1,2);
+    const double r20 = r.get(2,0), r21 = r.get(2,1), r22 = r.get(2,2);
+    const double *y[9];
+    double *o[9];
+    elements(a, y);
+    elements(out, o);
+
+#pragma GCC ivdep
+    for(size_t k = 0; k < n; ++k) {
+        double y00 = y[0][k], y01 = y[1][k], y02 = y[2][k];
+        double y10 = y[3][k], y11 = y[4][k], y12 = y[5][k];
+        double y20 = y[6][k], y21 = y[7][k], y22 = y[8][k];
+        o[0][k] = r00*y00 + r01*y10 + r02*y20;
+        o[1][k] = r00*y01 + r01*y11 + r02*y21;
+        o[2][k] = r00*y02 + r01*y12 + r02*y22;
+        o[3][k] = r10*y00 + r11*y10 + r12*y20;
+        o[4][k] = r10*y01 + r11*y11 + r12*y21;
+        o[5][k] = r10*y02 + r11*y12 + r12*y22;
+        o[6][k] = r20*y00 + r21*y10 + r22*y20;
+        o[7][k] = r20*y01 + r21*y11 + r22*y21;
+        o[8][k] = r20*y02 + r21*y12 + r22*y22;
+    }
+}
+
+void multiply(const MatrixArray &a, const VecArray &v, VecArray &out)
+{
+    check_size(a.size(), v.size());
+    const size_t n = a.size();
+    out.resize(n);
+    const double *x[9];
+    elements(a, x);
+    const double *vx = assume_aligned(v.x()), *vy = assume_aligned(v.y()), *vz = assume_aligned(v.z());
+    double *ox = assume_aligned(out.x()), *oy = assume_aligned(out.y()), *oz = assume_aligned(out.z());
+
+#pragma GCC ivdep
+    for(size_t k = 0; k < n; ++k) {
+        double px = vx[k], py = vy[k], pz = vz[k];
+        ox[k] = x[0][k]*px + x[1][k]*py + x[2][k]*pz;
+        oy[k] = x[3][k]*px + x[4][k]*py + x[5][k]*pz;
+        oz[k] = x[6][k]*px + x[7][k]*py + x[8][k]*pz;
+    }
+}
+
+void transpose(const MatrixArray &a, MatrixArray &out)
+{
+    const size_t n = a.size();
+    out.resize(n);
+    const double *x[9];
+    double *o[9];
+    elements(a, x);
+    elements(out, o);
+
+#pragma GCC ivdep
+    for(size_t k = 0; k < n; ++k) {
+        double x01 = x[1][k], x02 = x[2][k], x12 = x[5][k];
+        double x10 = x[3][k], x20 = x[6][k], x21 = x[7][k];
+        o[0][k] = x[0][k]; o[4][k] = x[4][k]; o[8][k] = x[8][k];
+        o[1][k] = x10; o[2][k] = x20; o[5][k] = x21;
+        o[3][k] = x01; o[6][k] = x02; o[7][k] = x12;
+    }
+}
+
+void determinant(const MatrixArray &a, double *out)
+{
+    const size_t n = a.size();
+    const double *x[9];
+    elements(a, x);
+
+#pragma GCC ivdep
+    for(size_t k = 0; k < n; ++k) {
+        out[k] = x[0][k]*(x[4][k]*x[8][k] - x[5][k]*x[7][k])
+               + x[1][k]*(x[5][k]*x[6][k] - x[3][k]*x[8][k])
+               + x[2][k]*(x[3][k]*x[7][k] - x[4][k]*x[6][k]);
+    }
+}
+
+void invert(const MatrixArray &a, MatrixArray &out)
+{
+    const size_t n = a.size();
+    out.resize(n);
+    const double *x[9];
+    double *o[9];
+    elements(a, x);
+    elements(out, o);
+
+#pragma GCC ivdep
+    for(size_t k = 0; k < n; ++k) {
+        double m00 = x[0][k], m01 = x[1][k], m02 = x[2][k];
+        double m10 = x[3][k], m11 = x[4][k], m12 = x[5][k];
+        double m20 = x[6][k], m21 = x[7][k], m22 = x[8][k];
+        // adjugate, as in matrix::Invert
+        double i00 = m11*m22 - m12*m21;
+        double i10 = m12*m20 - m10*m22;
+        double i20 = m10*m21 - m11*m20;
+        double i01 = m02*m21 - m01*m22;
+        double i11 = m00*m22 - m02*m20;
+        double i21 = m01*m20 - m00*m21;
+        double i02 = m01*m12 - m02*m11;
+        double i12 = m02*m10 - m00*m12;
+        double i22 = m00*m11 - m01*m10;
+        double d = m00*i00 + m01*i10 + m02*i20;
+        o[0][k] = i00/d; o[1][k] = i01/d; o[2][k] = i02/d;
+        o[3][k] = i10/d; o[4][k] = i11/d; o[5][k] = i12/d;
+        o[6][k] = i20/d; o[7][k] = i21/d; o[8][k] = i22/d;
+    }
+}
+
+}}
@@ -22,19 +22,14 @@
 #include <stdexcept>
 #include <expat.h>
 #include <votca/tools/parsexml.h>
+#include "xmlbuffer.h"
 
 namespace votca { namespace tools {
 
 void start_hndl(void *data, const char *el, const char **attr) {
     ParseXML *reader =
             (ParseXML*) XML_GetUserData((XML_Parser*) data);
-
-    map<string, string> mattr;
-
-    for (int i = 0; attr[i]; i += 2)
-        mattr[attr[i]] = attr[i + 1];
-    string sel = el;
-    reader->StartElemHndl(sel, mattr);
+    reader->StartElemHndl(el, attr);
 }
 
 void end_hndl(void *data, const char *el) {
@@ -43,7 +38,7 @@ void end_hndl(void *data, const char *el) {
     reader->EndElemHndl(el);
 }
 
-void ParseXML::Open(const string &filename)
+static XML_Parser create_parser(ParseXML *reader)
 {
     XML_Parser parser = XML_ParserCreate(NULL);
     if (!parser)
@@ -52,38 +47,63 @@ void ParseXML::Open(const string &filename)
     XML_UseParserAsHandlerArg(parser);
     XML_SetElementHandler(parser, start_hndl, end_hndl);
 //    XML_SetCharacterDataHandler(parser, char_hndl);
+    XML_SetUserData(parser, (void*) reader);
+    return parser;
+}
 
-    ifstream fl;
-    fl.open(filename.c_str());
-    if (!fl.is_open())
-        throw std::ios_base::failure("Error on open xml file: " + filename);
+void ParseXML::Open(const string &filename)
+{
+    XML_Parser parser = create_parser(this);
+    try {
+        xml_parse_file(parser, filename);
+    }
+    catch(std::exception &err) {
+        XML_ParserFree(parser);
+        throw;
+    }
+    XML_ParserFree(parser);
+}
 
-    XML_SetUserData(parser, (void*) this);
-    while (!fl.eof()) {
-        string line;
-        getline(fl, line);
-        line = line + "\n";
-        if (!XML_Parse(parser, line.c_str(), line.length(), fl.eof()))
-            throw std::ios_base::failure(filename + ": Parse error in " + filename + " at line " +
-                boost::lexical_cast<string > (XML_GetCurrentLineNumber(parser)) + "\n" +
-                XML_ErrorString(XML_GetErrorCode(parser)));
+void ParseXML::OpenBuffer(const char *data, size_t size, const string &name)
+{
+    XML_Parser parser = create_parser(this);
+    try {
+        xml_parse_buffer(parser, data, size, name);
+    }
+    catch(std::exception &err) {
+        XML_ParserFree(parser);
+        throw;
     }
-    fl.close();
+    XML_ParserFree(parser);
 }
 
 
-void ParseXML::ParseIgnore(const string &el, map<string, string> &attr) {
+ParseXML::~ParseXML()
+{
+    while (_depth > 0)
+        PopSlot();
+}
+
+void ParseXML::ParseIgnore(const boost::string_ref &el, const XMLAttributes &attr) {
     NextHandler(this, &ParseXML::ParseIgnore);
 }
 
-void ParseXML::StartElemHndl(const string &el, map<string, string> &attr) {
-    (*_handler)(el, attr);
+void ParseXML::PopSlot() {
+    _depth--;
+    _slots[_depth].handler->~Functor();
+}
+
+void ParseXML::StartElemHndl(const char *el, const char **attr) {
+    // no handler set, skip the element instead of failing inside expat
+    if (_depth == 0) {
+        IgnoreChilds();
+        return;
+    }
+    (*_slots[_depth-1].handler)(boost::string_ref(el), XMLAttributes(attr));
 }
 
-void ParseXML::EndElemHndl(const string &el) {
-    delete _handler;
-    _stack_handler.pop();
-    _handler = _stack_handler.top();
+void ParseXML::EndElemHndl(const char *el) {
+    PopSlot();
 }
 
 }}
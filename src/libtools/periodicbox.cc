@@ -0,0 +1,348 @@
+/*
+ * Copyright 2009-2014 The VOTCA Development Team (http://www.votca.org)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <math.h>
+#include <algorithm>
+#include <stdexcept>
+#include <votca/tools/periodicbox.h>
+#include "alignedarray.h"
+
+namespace votca { namespace tools {
+
+namespace {
+
+/*
+ * Round to the nearest integer by adding and subtracting 1.5*2^52 (2^23
+ * for float). Unlike rint this vectorizes without SSE4.1. Valid as long as
+ * |x| < 2^51 (2^22), which is far more box lengths than ever needed.
+ *
+ * -ffast-math allows the compiler to fold (x + magic) - magic to x, so
+ * rint is used there. The same holds for -fassociative-math alone, which
+ * cannot be detected, do not compile this file with it.
+ */
+#ifdef __FAST_MATH__
+inline double round_nearest(double x)
+{
+    return rint(x);
+}
+
+inline float round_nearest(float x)
+{
+    return rintf(x);
+}
+#else
+inline double round_nearest(double x)
+{
+    const double magic = 6755399441055744.0;
+    return (x + magic) - magic;
+}
+
+inline float round_nearest(float x)
+{
+    const float magic = 12582912.0f;
+    return (x + magic) - magic;
+}
+#endif
+
+template<typename T>
+struct open_image {
+    void operator()(T &, T &, T &) const {}
+};
+
+template<typename T>
+struct orthorhombic_image {
+    T lx, ly, lz;
+    T ix, iy, iz;
+
+    orthorhombic_image(const matrix &box)
+        : lx(box.get(0,0)), ly(box.get(1,1)), lz(box.get(2,2)),
+          ix(1./box.get(0,0)), iy(1./box.get(1,1)), iz(1./box.get(2,2)) {}
+
+    void operator()(T &dx, T &dy, T &dz) const {
+        dx -= lx*round_nearest(dx*ix);
+        dy -= ly*round_nearest(dy*iy);
+        dz -= lz*round_nearest(dz*iz);
+    }
+};
+
+template<typename T>
+struct triclinic_image {
+    T h[9], hi[9];
+
+    triclinic_image(const matrix &box, const matrix &inverse) {
+        for(int c = 0; c < 9; ++c) {
+            h[c] = box.get(c/3, c%3);
+            hi[c] = inverse.get(c/3, c%3);
+        }
+    }
+
+    void operator()(T &dx, T &dy, T &dz) const {
+        // fractional coordinates, shifted to the nearest image
+        T sx = hi[0]*dx + hi[1]*dy + hi[2]*dz;
+        T sy = hi[3]*dx + hi[4]*dy + hi[5]*dz;
+        T sz = hi[6]*dx + hi[7]*dy + hi[8]*dz;
+        sx = round_nearest(sx);
+        sy = round_nearest(sy);
+        sz = round_nearest(sz);
+        dx -= h[0]*sx + h[1]*sy + h[2]*sz;
+        dy -= h[3]*sx + h[4]*sy + h[5]*sz;
+        dz -= h[6]*sx + h[7]*sy + h[8]*sz;
+    }
+};
+
+template<typename T>
+struct displacements_op {
+    const T *ax, *ay, *az;
+    const T *bx, *by, *bz;
+    T *ox, *oy, *oz;
+    size_t n;
+
+    template<typename Image>
+    void operator()(const Image &image) const {
+#pragma GCC ivdep
+        for(size_t i = 0; i < n; ++i) {
+            T dx = bx[i] - ax[i], dy = by[i] - ay[i], dz = bz[i] - az[i];
+            image(dx, dy, dz);
+            ox[i] = dx; oy[i] = dy; oz[i] = dz;
+        }
+    }
+};
+
+template<typename T>
+struct point_displacements_op {
+    T px, py, pz;
+    const T *ax, *ay, *az;
+    T *ox, *oy, *oz;
+    size_t n;
+
+    template<typename Image>
+    void operator()(const Image &image) const {
+#pragma GCC ivdep
+        for(size_t i = 0; i < n; ++i) {
+            T dx = ax[i] - px, dy = ay[i] - py, dz = az[i] - pz;
+            image(dx, dy, dz);
+            ox[i] = dx; oy[i] = dy; oz[i] = dz;
+        }
+    }
+};
+
+template<typename T, bool Root>
+struct distances_op {
+    const T *ax, *ay, *az;
+    const T *bx, *by, *bz;
+    T *out;
+    size_t n;
+
+    template<typename Image>
+    void operator()(const Image &image) const {
+#pragma GCC ivdep
+        for(size_t i = 0; i < n; ++i) {
+            T dx = bx[i] - ax[i], dy = by[i] - ay[i], dz = bz[i] - az[i];
+            image(dx, dy, dz);
+            T d2 = dx*dx + dy*dy + dz*dz;
+            out[i] = Root ? sqrt(d2) : d2;
+        }
+    }
+};
+
+template<typename T, bool Root>
+struct point_distances_op {
+    T px, py, pz;
+    const T *ax, *ay, *az;
+    T *out;
+    size_t n;
+
+    template<typename Image>
+    void operator()(const Image &image) const {
+#pragma GCC ivdep
+        for(size_t i = 0; i < n; ++i) {
+            T dx = ax[i] - px, dy = ay[i] - py, dz = az[i] - pz;
+            image(dx, dy, dz);
+            T d2 = dx*dx + dy*dy + dz*dz;
+            out[i] = Root ? sqrt(d2) : d2;
+        }
+    }
+};
+
+}
+
+PeriodicBox::PeriodicBox()
+{
+    matrix box;
+    box.ZeroMatrix();
+    setBox(box);
+}
+
+PeriodicBox::PeriodicBox(const matrix &box)
+{
+    setBox(box);
+}
+
+void PeriodicBox::setBox(const matrix &box)
+{
+    _box = box;
+    bool zero = true, diagonal = true;
+    for(int i = 0; i < 3; ++i)
+        for(int j = 0; j < 3; ++j) {
+            if(box.get(i,j) != 0) zero = false;
+            if(i != j && box.get(i,j) != 0) diagonal = false;
+        }
+
+    if(zero) {
+        _type = typeOpen;
+        _inverse.ZeroMatrix();
+        return;
+    }
+    _type = diagonal ? typeOrthorhombic : typeTriclinic;
+    _inverse = box;
+    _inverse.Invert();
+    if(Volume() == 0)
+        throw std::invalid_argument("PeriodicBox: box vectors are linearly dependent");
+}
+
+double PeriodicBox::Volume() const
+{
+    if(_type == typeOpen) return 0;
+    return fabs(_box.getCol(0) * (_box.getCol(1) ^ _box.getCol(2)));
+}
+
+double PeriodicBox::MaxCutoff() const
+{
+    if(_type == typeOpen) return HUGE_VAL;
+    // width along a box vector is the volume divided by the opposite face
+    vec a = _box.getCol(0), b = _box.getCol(1), c = _box.getCol(2);
+    double V = Volume();
+    double w = std::min(V/abs(b^c), std::min(V/abs(c^a), V/abs(a^b)));
+    return 0.5*w;
+}
+
+template<typename T, typename Op>
+void PeriodicBox::Dispatch(const Op &op) const
+{
+    switch(_type) {
+    case typeOpen:
+        op(open_image<T>());
+        break;
+    case typeOrthorhombic:
+        op(orthorhombic_image<T>(_box));
+        break;
+    case typeTriclinic:
+        op(triclinic_image<T>(_box, _inverse));
+        break;
+    }
+}
+
+vec PeriodicBox::MinimumImage(const vec &d) const
+{
+    double dx = d.getX(), dy = d.getY(), dz = d.getZ();
+    if(_type == typeOrthorhombic) {
+        orthorhombic_image<double> image(_box);
+        image(dx, dy, dz);
+    }
+    else if(_type == typeTriclinic) {
+        triclinic_image<double> image(_box, _inverse);
+        image(dx, dy, dz);
+    }
+    return vec(dx, dy, dz);
+}
+
+template<typename T>
+void PeriodicBox::MinimumImage(VecArray_t<T> &d) const
+{
+    // displacement from the origin to d
+    T *x = assume_aligned(d.x()), *y = assume_aligned(d.y()), *z = assume_aligned(d.z());
+    point_displacements_op<T> op = { 0, 0, 0, x, y, z, x, y, z, d.size() };
+    Dispatch<T>(op);
+}
+
+template<typename T>
+void PeriodicBox::Displacements(const VecArray_t<T> &a, const VecArray_t<T> &b, VecArray_t<T> &out) const
+{
+    check_size(a.size(), b.size());
+    out.resize(a.size());
+    displacements_op<T> op = {
+        assume_aligned(a.x()), assume_aligned(a.y()), assume_aligned(a.z()),
+        assume_aligned(b.x()), assume_aligned(b.y()), assume_aligned(b.z()),
+        assume_aligned(out.x()), assume_aligned(out.y()), assume_aligned(out.z()),
+        a.size() };
+    Dispatch<T>(op);
+}
+
+template<typename T>
+void PeriodicBox::Displacements(const vec_t<T> &p, const VecArray_t<T> &a, VecArray_t<T> &out) const
+{
+    out.resize(a.size());
+    point_displacements_op<T> op = { p.getX(), p.getY(), p.getZ(),
+        assume_aligned(a.x()), assume_aligned(a.y()), assume_aligned(a.z()),
+        assume_aligned(out.x()), assume_aligned(out.y()), assume_aligned(out.z()),
+        a.size() };
+    Dispatch<T>(op);
+}
+
+template<typename T>
+void PeriodicBox::Distances(const VecArray_t<T> &a, const VecArray_t<T> &b, T *out) const
+{
+    check_size(a.size(), b.size());
+    distances_op<T, true> op = {
+        assume_aligned(a.x()), assume_aligned(a.y()), assume_aligned(a.z()),
+        assume_aligned(b.x()), assume_aligned(b.y()), assume_aligned(b.z()),
+        out, a.size() };
+    Dispatch<T>(op);
+}
+
+template<typename T>
+void PeriodicBox::Distances(const vec_t<T> &p, const VecArray_t<T> &a, T *out) const
+{
+    point_distances_op<T, true> op = { p.getX(), p.getY(), p.getZ(),
+        assume_aligned(a.x()), assume_aligned(a.y()), assume_aligned(a.z()),
+        out, a.size() };
+    Dispatch<T>(op);
+}
+
+template<typename T>
+void PeriodicBox::Distances2(const VecArray_t<T> &a, const VecArray_t<T> &b, T *out) const
+{
+    check_size(a.size(), b.size());
+    distances_op<T, false> op = {
+        assume_aligned(a.x()), assume_aligned(a.y()), assume_aligned(a.z()),
+        assume_aligned(b.x()), assume_aligned(b.y()), assume_aligned(b.z()),
+        out, a.size() };
+    Dispatch<T>(op);
+}
+
+template<typename T>
+void PeriodicBox::Distances2(const vec_t<T> &p, const VecArray_t<T> &a, T *out) const
+{
+    point_distances_op<T, false> op = { p.getX(), p.getY(), p.getZ(),
+        assume_aligned(a.x()), assume_aligned(a.y()), assume_aligned(a.z()),
+        out, a.size() };
+    Dispatch<T>(op);
+}
+
+#define PERIODICBOX_INSTANTIATE(T) \
+    template void PeriodicBox::MinimumImage(VecArray_t<T> &) const; \
+    template void PeriodicBox::Displacements(const VecArray_t<T> &, const VecArray_t<T> &, VecArray_t<T> &) const; \
+    template void PeriodicBox::Displacements(const vec_t<T> &, const VecArray_t<T> &, VecArray_t<T> &) const; \
+    template void PeriodicBox::Distances(const VecArray_t<T> &, const VecArray_t<T> &, T *) const; \
+    template void PeriodicBox::Distances(const vec_t<T> &, const VecArray_t<T> &, T *) const; \
+    template void PeriodicBox::Distances2(const VecArray_t<T> &, const VecArray_t<T> &, T *) const; \
+    template void PeriodicBox::Distances2(const vec_t<T> &, const VecArray_t<T> &, T *) const;
+
+PERIODICBOX_INSTANTIATE(double)
+PERIODICBOX_INSTANTIATE(float)
+
+}}
@@ -28,12 +28,16 @@
 #include <votca/tools/property.h>
 #include <votca/tools/colors.h>
 #include <votca/tools/tokenizer.h>
+#include <votca/tools/wildcard.h>
 #include <votca/tools/propertyiomanipulator.h>
+#include <votca/tools/propertysnapshot.h>
 
 #include <boost/format.hpp>
 #include <boost/algorithm/string.hpp>
 #include <unistd.h>
 
+#include "xmlbuffer.h"
+
 namespace votca { namespace tools {
 
 // ostream modifier defines the output format, level, indentation
@@ -85,17 +89,18 @@ std::list<Property *> Property::Select(const string &filter)
         
     for (Tokenizer::iterator n = tok.begin();
             n != tok.end(); ++n) {
+        WildcardPattern pattern(*n);
         std::list<Property *> childs;
         for (std::list<Property *>::iterator p = selection.begin();
                 p != selection.end(); ++p) {
                 for (list<Property>::iterator iter = (*p)->_properties.begin();
                     iter != (*p)->_properties.end(); ++iter) {
-                    if (wildcmp((*n).c_str(), (*iter).name().c_str())) {
+                    if (pattern.Match((*iter).name())) {
                         childs.push_back(&(*iter));
                     }
                 }
         }
-        selection = childs;        
+        selection.swap(childs);
     }
 
     return selection;
@@ -131,7 +136,7 @@ void char_hndl(void *data, const char *txt, int txtlen)
     cur->value().append(txt, txtlen);
 }
 
-bool load_property_from_xml(Property &p, string filename)
+static XML_Parser create_property_parser(stack<Property *> &pstack)
 {
   XML_Parser parser = XML_ParserCreate(NULL);
   if (! parser)
@@ -140,26 +145,58 @@ bool load_property_from_xml(Property &p, string filename)
   XML_UseParserAsHandlerArg(parser);
   XML_SetElementHandler(parser, start_hndl, end_hndl);
   XML_SetCharacterDataHandler(parser, char_hndl);
+  XML_SetUserData(parser, (void*)&pstack);
+  return parser;
+}
 
-  ifstream fl;
-  fl.open(filename.c_str());
-  if(!fl.is_open())
-    throw std::ios_base::failure("Error on open xml file: " + filename);
+bool load_property_from_xml(Property &p, string filename)
+{
+  PropertySnapshotCache *cache = PropertySnapshotCache::Default();
+  if(cache && cache->Load(p, filename))
+    return true;
+  size_t nchilds = p.size();
 
   stack<Property *> pstack;
   pstack.push(&p);
 
-  XML_SetUserData(parser, (void*)&pstack);
-  while(!fl.eof()) {
-    string line;
-    getline(fl, line);
-    line=line + "\n";
-    if (! XML_Parse(parser, line.c_str(), line.length(), fl.eof()))
-      throw  std::ios_base::failure(filename + ": Parse error at line " +
-          boost::lexical_cast<string>(XML_GetCurrentLineNumber(parser)) + "\n" +
-          XML_ErrorString(XML_GetErrorCode(parser)));
+  XML_Parser parser = create_property_parser(pstack);
+  snapshot_source_t source;
+  vector<char> content;
+  try {
+    if(cache) {
+      // parse the very data the snapshot is tagged with, the file might
+      // change in the meantime
+      source.FromFile(filename, &content);
+      xml_parse_buffer(parser, content.empty() ? "" : &content[0], content.size(), filename);
+    }
+    else
+      xml_parse_file(parser, filename);
+  }
+  catch(std::exception &err) {
+    XML_ParserFree(parser);
+    throw;
+  }
+  XML_ParserFree(parser);
+
+  if(cache)
+    cache->Store(p, source, nchilds);
+  return true;
+}
+
+bool load_property_from_xml_buffer(Property &p, const char *data, size_t size)
+{
+  stack<Property *> pstack;
+  pstack.push(&p);
+
+  XML_Parser parser = create_property_parser(pstack);
+  try {
+    xml_parse_buffer(parser, data, size, "xml buffer");
+  }
+  catch(std::exception &err) {
+    XML_ParserFree(parser);
+    throw;
   }
-  fl.close();
+  XML_ParserFree(parser);
   return true;
 }
 
@@ -0,0 +1,391 @@
+/*
+ * Copyright 2009-2014 The VOTCA Development Team (http://www.votca.org)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fstream>
+#include <stdexcept>
+#include <boost/filesystem.hpp>
+#include <boost/lexical_cast.hpp>
+#include <votca/tools/propertysnapshot.h>
+
+namespace votca { namespace tools {
+
+namespace {
+
+const char SNAPSHOT_MAGIC[8] = { 'V', 'O', 'T', 'C', 'A', 'P', 'S', '\0' };
+const boost::uint32_t SNAPSHOT_VERSION = 1;
+
+boost::uint64_t fnv1a64(const char *data, size_t size)
+{
+    boost::uint64_t h = 14695981039346656037ULL;
+    for(size_t i=0; i<size; ++i) {
+        h ^= (unsigned char)data[i];
+        h *= 1099511628211ULL;
+    }
+    return h;
+}
+
+/// read-only memory map of a whole file
+class MappedFile
+{
+public:
+    MappedFile() : _data(NULL), _size(0) {}
+    ~MappedFile() { if(_data) munmap(_data, _size); }
+
+    bool Open(const std::string &filename) {
+        int fd = open(filename.c_str(), O_RDONLY);
+        if(fd < 0) return false;
+        struct stat st;
+        if(fstat(fd, &st) != 0) { close(fd); return false; }
+        _size = st.st_size;
+        if(_size > 0) {
+            _data = mmap(NULL, _size, PROT_READ, MAP_PRIVATE, fd, 0);
+            if(_data == MAP_FAILED) _data = NULL;
+        }
+        close(fd);
+        return _data != NULL || _size == 0;
+    }
+
+    const char *data() const { return (const char *)_data; }
+    size_t size() const { return _size; }
+
+private:
+    void *_data;
+    size_t _size;
+};
+
+void write_u32(std::ostream &out, boost::uint32_t v)
+{
+    char b[4];
+    for(int i=0; i<4; ++i) b[i] = (char)((v >> (8*i)) & 0xff);
+    out.write(b, 4);
+}
+
+void write_u64(std::ostream &out, boost::uint64_t v)
+{
+    char b[8];
+    for(int i=0; i<8; ++i) b[i] = (char)((v >> (8*i)) & 0xff);
+    out.write(b, 8);
+}
+
+void write_string(std::ostream &out, const std::string &s)
+{
+    write_u32(out, s.size());
+    out.write(s.data(), s.size());
+}
+
+void write_node(std::ostream &out, Property &p)
+{
+    write_string(out, p.name());
+    write_string(out, p.value());
+
+    boost::uint32_t nattributes = 0;
+    for(Property::AttributeIterator ia = p.firstAttribute(); ia != p.lastAttribute(); ++ia)
+        nattributes++;
+    write_u32(out, nattributes);
+    for(Property::AttributeIterator ia = p.firstAttribute(); ia != p.lastAttribute(); ++ia) {
+        write_string(out, ia->first);
+        write_string(out, ia->second);
+    }
+
+    write_u32(out, p.size());
+    for(Property::iterator iter = p.begin(); iter != p.end(); ++iter)
+        write_node(out, *iter);
+}
+
+/// sequential reader with bounds checking
+class SnapshotReader
+{
+public:
+    SnapshotReader(const char *data, size_t size) : _data(data), _end(data + size) {}
+
+    void Need(size_t n) {
+        if((size_t)(_end - _data) < n)
+            throw std::runtime_error("property snapshot is truncated");
+    }
+
+    boost::uint32_t u32() {
+        Need(4);
+        boost::uint32_t v = 0;
+        for(int i=0; i<4; ++i) v |= (boost::uint32_t)(unsigned char)_data[i] << (8*i);
+        _data += 4;
+        return v;
+    }
+
+    boost::uint64_t u64() {
+        Need(8);
+        boost::uint64_t v = 0;
+        for(int i=0; i<8; ++i) v |= (boost::uint64_t)(unsigned char)_data[i] << (8*i);
+        _data += 8;
+        return v;
+    }
+
+    void str(std::string &s) {
+        boost::uint32_t len = u32();
+        Need(len);
+        s.assign(_data, len);
+        _data += len;
+    }
+
+    const char *raw(size_t n) {
+        Need(n);
+        const char *p = _data;
+        _data += n;
+        return p;
+    }
+
+    /// walk over a node without creating it, only checks the structure
+    void skip_node() {
+        boost::uint32_t nattributes = u32();
+        for(boost::uint32_t i=0; i<2*nattributes; ++i)
+            raw(u32());
+        boost::uint32_t nchilds = u32();
+        for(boost::uint32_t i=0; i<nchilds; ++i) {
+            raw(u32()); raw(u32());
+            skip_node();
+        }
+    }
+
+    bool at_end() const { return _data == _end; }
+
+    void node(Property &p) {
+        std::string name, value;
+        boost::uint32_t nattributes = u32();
+        for(boost::uint32_t i=0; i<nattributes; ++i) {
+            str(name); str(value);
+            p.setAttribute(name, value);
+        }
+        boost::uint32_t nchilds = u32();
+        for(boost::uint32_t i=0; i<nchilds; ++i) {
+            str(name); str(value);
+            node(p.add(name, value));
+        }
+    }
+
+private:
+    const char *_data;
+    const char *_end;
+};
+
+void read_header(SnapshotReader &in, snapshot_source_t &source)
+{
+    if(memcmp(in.raw(sizeof(SNAPSHOT_MAGIC)), SNAPSHOT_MAGIC, sizeof(SNAPSHOT_MAGIC)) != 0)
+        throw std::runtime_error("not a property snapshot");
+    boost::uint32_t version = in.u32();
+    if(version != SNAPSHOT_VERSION)
+        throw std::runtime_error("unsupported property snapshot version "
+                + boost::lexical_cast<std::string>(version));
+    in.str(source.path);
+    source.size = in.u64();
+    source.mtime = (boost::int64_t)in.u64();
+    source.hash = in.u64();
+}
+
+}
+
+void snapshot_source_t::FromFile(const std::string &filename, std::vector<char> *content)
+{
+    path = boost::filesystem::absolute(filename).string();
+    if(content) {
+        // take size and time from the open file before reading, a later
+        // change of the file then never matches this description
+        int fd = open(filename.c_str(), O_RDONLY);
+        if(fd < 0)
+            throw std::ios_base::failure("Error on open file: " + filename);
+        struct stat st;
+        if(fstat(fd, &st) != 0) {
+            close(fd);
+            throw std::ios_base::failure("Error on reading file: " + filename);
+        }
+        mtime = st.st_mtime;
+        content->resize(st.st_size);
+        size_t done = 0;
+        while(done < content->size()) {
+            ssize_t n = read(fd, &(*content)[done], content->size() - done);
+            if(n <= 0) {
+                close(fd);
+                throw std::ios_base::failure("Error on reading file: " + filename);
+            }
+            done += n;
+        }
+        close(fd);
+        size = content->size();
+        hash = fnv1a64(content->empty() ? NULL : &(*content)[0], content->size());
+        return;
+    }
+    MappedFile file;
+    if(!file.Open(filename))
+        throw std::ios_base::failure("Error on open file: " + filename);
+    size = file.size();
+    mtime = boost::filesystem::last_write_time(filename);
+    hash = fnv1a64(file.data(), file.size());
+}
+
+void save_property_snapshot(Property &p, const snapshot_source_t &source,
+        std::ostream &out, size_t skip)
+{
+    out.write(SNAPSHOT_MAGIC, sizeof(SNAPSHOT_MAGIC));
+    write_u32(out, SNAPSHOT_VERSION);
+    write_string(out, source.path);
+    write_u64(out, source.size);
+    write_u64(out, (boost::uint64_t)source.mtime);
+    write_u64(out, source.hash);
+
+    write_u32(out, p.size() > skip ? p.size() - skip : 0);
+    Property::iterator iter = p.begin();
+    for(size_t i=0; i<skip && iter != p.end(); ++i) ++iter;
+    for(; iter != p.end(); ++iter)
+        write_node(out, *iter);
+}
+
+void load_property_snapshot(Property &p, const char *data, size_t size,
+        snapshot_source_t *source)
+{
+    SnapshotReader in(data, size);
+    snapshot_source_t s;
+    read_header(in, s);
+    if(source) *source = s;
+
+    // the top nodes are written exactly like childs, so read them as such
+    std::string name, value;
+    boost::uint32_t ntop = in.u32();
+    for(boost::uint32_t i=0; i<ntop; ++i) {
+        in.str(name); in.str(value);
+        in.node(p.add(name, value));
+    }
+}
+
+PropertySnapshotCache::PropertySnapshotCache(const std::string &directory)
+    : _directory(directory)
+{
+}
+
+std::string PropertySnapshotCache::SnapshotFile(const std::string &filename) const
+{
+    std::string path = boost::filesystem::absolute(filename).string();
+    char key[17];
+    snprintf(key, sizeof(key), "%016llx", (unsigned long long)fnv1a64(path.data(), path.size()));
+    return (boost::filesystem::path(_directory) / (std::string(key) + ".snapshot")).string();
+}
+
+bool PropertySnapshotCache::Load(Property &p, const std::string &filename)
+{
+    MappedFile snapshot;
+    if(!snapshot.Open(SnapshotFile(filename)))
+        return false;
+
+    try {
+        // compare path, size and modification time before hashing the content
+        SnapshotReader in(snapshot.data(), snapshot.size());
+        snapshot_source_t cached;
+        read_header(in, cached);
+        if(cached.path != boost::filesystem::absolute(filename).string()
+                || cached.size != boost::filesystem::file_size(filename)
+                || cached.mtime != boost::filesystem::last_write_time(filename))
+            return false;
+
+        snapshot_source_t current;
+        current.FromFile(filename);
+        if(!(cached == current))
+            return false;
+
+        // check the whole structure first, p must stay untouched on errors
+        boost::uint32_t ntop = in.u32();
+        for(boost::uint32_t i=0; i<ntop; ++i) {
+            in.raw(in.u32()); in.raw(in.u32());
+            in.skip_node();
+        }
+        if(!in.at_end())
+            return false;
+    }
+    catch(std::exception &err) {
+        return false;
+    }
+
+    load_property_snapshot(p, snapshot.data(), snapshot.size());
+    return true;
+}
+
+void PropertySnapshotCache::Store(Property &p, const std::string &filename, size_t skip)
+{
+    try {
+        snapshot_source_t source;
+        source.FromFile(filename);
+        Store(p, source, skip);
+    }
+    catch(std::exception &err) {
+    }
+}
+
+void PropertySnapshotCache::Store(Property &p, const snapshot_source_t &source, size_t skip)
+{
+    // makes the temporary file names unique between the threads of a process
+    static unsigned long tmp_counter = 0;
+
+    try {
+        boost::filesystem::create_directories(_directory);
+
+        // write to a temporary file and rename it, so concurrent readers
+        // never see a half written snapshot
+        std::string snapshot = SnapshotFile(source.path);
+        std::string tmp = snapshot + ".tmp" + boost::lexical_cast<std::string>(getpid())
+            + "." + boost::lexical_cast<std::string>(__atomic_fetch_add(&tmp_counter, 1, __ATOMIC_RELAXED));
+        {
+            std::ofstream out(tmp.c_str(), std::ios::binary);
+            if(!out) return;
+            save_property_snapshot(p, source, out, skip);
+            if(!out) {
+                out.close();
+                unlink(tmp.c_str());
+                return;
+            }
+        }
+        if(rename(tmp.c_str(), snapshot.c_str()) != 0)
+            unlink(tmp.c_str());
+    }
+    catch(std::exception &err) {
+    }
+}
+
+namespace {
+
+PropertySnapshotCache *default_cache = NULL;
+pthread_once_t default_cache_once = PTHREAD_ONCE_INIT;
+
+void init_default_cache()
+{
+    const char *dir = getenv("VOTCA_PROPERTY_CACHE");
+    if(dir && *dir)
+        default_cache = new PropertySnapshotCache(dir);
+}
+
+}
+
+PropertySnapshotCache *PropertySnapshotCache::Default()
+{
+    pthread_once(&default_cache_once, init_default_cache);
+    return default_cache;
+}
+
+}}
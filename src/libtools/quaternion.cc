@@ -0,0 +1,155 @@
+/*
+ * Copyright 2009-2014 The VOTCA Development Team (http://www.votca.org)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <math.h>
+#include <stdlib.h>
+#include <votca/tools/quaternion.h>
+#include "alignedarray.h"
+
+namespace votca { namespace tools {
+
+quaternion quaternion::FromAxisAngle(const vec &axis, double angle)
+{
+    double s = sin(0.5*angle) / abs(axis);
+    return quaternion(cos(0.5*angle), s*axis);
+}
+
+matrix quaternion::ToMatrix() const
+{
+    double xx = _x*_x, yy = _y*_y, zz = _z*_z;
+    double xy = _x*_y, xz = _x*_z, yz = _y*_z;
+    double wx = _w*_x, wy = _w*_y, wz = _w*_z;
+    matrix R;
+    R[0][0] = 1. - 2.*(yy + zz); R[0][1] = 2.*(xy - wz);      R[0][2] = 2.*(xz + wy);
+    R[1][0] = 2.*(xy + wz);      R[1][1] = 1. - 2.*(xx + zz); R[1][2] = 2.*(yz - wx);
+    R[2][0] = 2.*(xz - wy);      R[2][1] = 2.*(yz + wx);      R[2][2] = 1. - 2.*(xx + yy);
+    return R;
+}
+
+void quaternion::FromMatrix(const matrix &R)
+{
+    double m00 = R.get(0,0), m11 = R.get(1,1), m22 = R.get(2,2);
+    double trace = m00 + m11 + m22;
+    // start from the largest of 4w^2, 4x^2, 4y^2, 4z^2 to avoid
+    // dividing by a small number
+    if(trace >= m00 && trace >= m11 && trace >= m22) {
+        double s = 2.*sqrt(1. + trace);
+        _w = 0.25*s;
+        _x = (R.get(2,1) - R.get(1,2)) / s;
+        _y = (R.get(0,2) - R.get(2,0)) / s;
+        _z = (R.get(1,0) - R.get(0,1)) / s;
+    }
+    else if(m00 >= m11 && m00 >= m22) {
+        double s = 2.*sqrt(1. + m00 - m11 - m22);
+        _w = (R.get(2,1) - R.get(1,2)) / s;
+        _x = 0.25*s;
+        _y = (R.get(0,1) + R.get(1,0)) / s;
+        _z = (R.get(0,2) + R.get(2,0)) / s;
+    }
+    else if(m11 >= m22) {
+        double s = 2.*sqrt(1. + m11 - m00 - m22);
+        _w = (R.get(0,2) - R.get(2,0)) / s;
+        _x = (R.get(0,1) + R.get(1,0)) / s;
+        _y = 0.25*s;
+        _z = (R.get(1,2) + R.get(2,1)) / s;
+    }
+    else {
+        double s = 2.*sqrt(1. + m22 - m00 - m11);
+        _w = (R.get(1,0) - R.get(0,1)) / s;
+        _x = (R.get(0,2) + R.get(2,0)) / s;
+        _y = (R.get(1,2) + R.get(2,1)) / s;
+        _z = 0.25*s;
+    }
+    if(_w < 0) *this *= -1.;
+    normalize();
+}
+
+void quaternion::RandomRotation()
+{
+    double u1 = drand48();
+    double u2 = drand48();
+    double u3 = drand48();
+    RotationFromUniform(u1, u2, u3);
+}
+
+void quaternion::RotationFromUniform(double u1, double u2, double u3)
+{
+    double r1 = sqrt(1. - u1);
+    double r2 = sqrt(u1);
+    double t1 = 2.*M_PI*u2;
+    double t2 = 2.*M_PI*u3;
+    _w = r2*cos(t2);
+    _x = r1*sin(t1);
+    _y = r1*cos(t1);
+    _z = r2*sin(t2);
+}
+
+quaternion slerp(const quaternion &q1, const quaternion &q2, double t)
+{
+    // q and -q are the same rotation, take the shorter arc
+    quaternion q = q2;
+    if(dot(q1, q2) < 0)
+        q *= -1.;
+    // acos of the dot product loses half of the digits for nearly parallel
+    // rotations, the angle from the chord does not and needs no fallback
+    double theta = 2.*atan2((q1 - q).norm(), (q1 + q).norm());
+    if(theta == 0)
+        return q1;
+    double s = sin(theta);
+    return q1*(sin((1. - t)*theta)/s) + q*(sin(t*theta)/s);
+}
+
+/*
+ * The batched kernels convert the quaternion to a matrix once, rotating a
+ * vector is then 9 multiplications.
+ */
+
+template<typename T>
+void rotate(const quaternion &q, const VecArray_t<T> &v, VecArray_t<T> &out)
+{
+    vec_t<T> center(0, 0, 0);
+    rotate(q, center, v, out);
+}
+
+template<typename T>
+void rotate(const quaternion &q, const vec_t<T> &center, const VecArray_t<T> &v, VecArray_t<T> &out)
+{
+    matrix R = q.ToMatrix();
+    const T r00 = R.get(0,0), r01 = R.get(0,1), r02 = R.get(0,2);
+    const T r10 = R.get(1,0), r11 = R.get(1,1), r12 = R.get(1,2);
+    const T r20 = R.get(2,0), r21 = R.get(2,1), r22 = R.get(2,2);
+    const T cx = center.getX(), cy = center.getY(), cz = center.getZ();
+
+    const size_t n = v.size();
+    out.resize(n);
+    const T *vx = assume_aligned(v.x()), *vy = assume_aligned(v.y()), *vz = assume_aligned(v.z());
+    T *ox = assume_aligned(out.x()), *oy = assume_aligned(out.y()), *oz = assume_aligned(out.z());
+#pragma GCC ivdep
+    for(size_t i = 0; i < n; ++i) {
+        T x = vx[i] - cx, y = vy[i] - cy, z = vz[i] - cz;
+        ox[i] = cx + r00*x + r01*y + r02*z;
+        oy[i] = cy + r10*x + r11*y + r12*z;
+        oz[i] = cz + r20*x + r21*y + r22*z;
+    }
+}
+
+template void rotate(const quaternion &, const VecArray_t<double> &, VecArray_t<double> &);
+template void rotate(const quaternion &, const VecArray_t<float> &, VecArray_t<float> &);
+template void rotate(const quaternion &, const vec_t<double> &, const VecArray_t<double> &, VecArray_t<double> &);
+template void rotate(const quaternion &, const vec_t<float> &, const VecArray_t<float> &, VecArray_t<float> &);
+
+}}
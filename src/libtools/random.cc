@@ -19,6 +19,7 @@
 #include <stdexcept>
 #include <string>
 #include <iostream>
+#include "randomfill.h"
 
 namespace votca { namespace tools {
 
@@ -203,4 +204,23 @@ double Random::rand_gaussian( double sigma )
     return r * cos(theta); // second independent number is r*sin(theta)
 }
 
+void Random::fill_uniform( double *out, size_t n )
+{
+    marsaglia_fill(MARSarray, MARSi, MARSj, MARSc, MARScd, MARScm, out, n);
+}
+
+void Random::fill_uniform_int( int *out, size_t n, int max_int )
+{
+    static_fill<Random> fill;
+    fill_int_via_uniform(fill, out, n, max_int);
+}
+
+void Random::fill_gaussian( double *out, size_t n, double sigma )
+{
+    fill_uniform(out, n & ~(size_t)1);
+    box_muller(out, n/2, sigma);
+    if(n & 1)
+        out[n-1] = rand_gaussian(sigma);
+}
+
 }}
@@ -0,0 +1,101 @@
+/*
+ * Copyright 2009-2014 The VOTCA Development Team (http://www.votca.org)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#ifndef _VOTCA_TOOLS_RANDOMFILL_H
+#define	_VOTCA_TOOLS_RANDOMFILL_H
+
+#include <math.h>
+#include <stddef.h>
+
+namespace votca { namespace tools {
+
+/**
+ * \brief turn pairs of uniform numbers into pairs of gaussian numbers
+ * @param data 2*npairs numbers in [0,1), replaced by the gaussian numbers
+ * @param npairs number of pairs
+ * @param sigma standard deviation
+ *
+ * Box-Muller which keeps both results. It uses the scalar libm functions,
+ * so the numbers are bit-identical to the ones of rand_gaussian.
+ */
+inline void box_muller(double *data, size_t npairs, double sigma)
+{
+    const double twopi = 2.0 * M_PI;
+    for(size_t i = 0; i < npairs; ++i) {
+        double r = sqrt(-2.0 * log(1.0 - data[2*i]));
+        double theta = twopi * data[2*i+1];
+        // same rounding as RandomStream::rand_gaussian
+        data[2*i] = sigma * r * cos(theta);
+        data[2*i+1] = sigma * (r * sin(theta));
+    }
+}
+
+/**
+ * \brief fill an array with integers in [0, max_int-1]
+ * @param rng generator with fill_uniform
+ *
+ * The uniform numbers are generated in chunks on the stack.
+ */
+template<typename RNG>
+inline void fill_int_via_uniform(RNG &rng, int *out, size_t n, int max_int)
+{
+    double buffer[256];
+    while(n > 0) {
+        size_t m = n < 256 ? n : 256;
+        rng.fill_uniform(buffer, m);
+        for(size_t i = 0; i < m; ++i)
+            out[i] = (int)(max_int * buffer[i]);
+        out += m;
+        n -= m;
+    }
+}
+
+/// \brief fill_uniform of a generator with static state, such as Random
+template<typename RNG>
+struct static_fill {
+    void fill_uniform(double *out, size_t n) { RNG::fill_uniform(out, n); }
+};
+
+/**
+ * \brief MARSAGLIA generator, n numbers at once
+ *
+ * Same sequence as n calls of rand_uniform of Random or Random2, but the
+ * state is kept in registers during the loop.
+ */
+inline void marsaglia_fill(double *array, int &mi, int &mj, double &c,
+        double cd, double cm, double *out, size_t n)
+{
+    int i = mi, j = mj;
+    double cc = c;
+    for(size_t k = 0; k < n; ++k) {
+        double r = array[i] - array[j];
+        if(r < 0.0) r += 1.0;
+        array[i] = r;
+        if(--i < 1) i = 97;
+        if(--j < 1) j = 97;
+        cc -= cd;
+        if(cc < 0.0) cc += cm;
+        r -= cc;
+        if(r < 0.0) r += 1.0;
+        out[k] = r;
+    }
+    mi = i; mj = j; c = cc;
+}
+
+}}
+
+#endif	/* _VOTCA_TOOLS_RANDOMFILL_H */
@@ -0,0 +1,182 @@
+/*
+ * Copyright 2009-2014 The VOTCA Development Team (http://www.votca.org)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <math.h>
+#include <votca/tools/randomstream.h>
+#include "randomfill.h"
+
+namespace votca { namespace tools {
+
+namespace {
+
+const boost::uint32_t PHILOX_M0 = 0xD2511F53;
+const boost::uint32_t PHILOX_M1 = 0xCD9E8D57;
+const boost::uint32_t PHILOX_W0 = 0x9E3779B9;
+const boost::uint32_t PHILOX_W1 = 0xBB67AE85;
+
+inline void philox_round(boost::uint32_t c[4], const boost::uint32_t k[2])
+{
+    boost::uint64_t p0 = (boost::uint64_t)PHILOX_M0 * c[0];
+    boost::uint64_t p1 = (boost::uint64_t)PHILOX_M1 * c[2];
+    boost::uint32_t c1 = c[1], c3 = c[3];
+    c[0] = (boost::uint32_t)(p1 >> 32) ^ c1 ^ k[0];
+    c[1] = (boost::uint32_t)p1;
+    c[2] = (boost::uint32_t)(p0 >> 32) ^ c3 ^ k[1];
+    c[3] = (boost::uint32_t)p0;
+}
+
+/// philox for N counters at once, stored as structure of arrays
+template<int N>
+inline void philox_lanes(boost::uint32_t c0[N], boost::uint32_t c1[N],
+        boost::uint32_t c2[N], boost::uint32_t c3[N], const boost::uint32_t key[2])
+{
+    boost::uint32_t k0 = key[0], k1 = key[1];
+    for(int round = 0; round < 10; ++round) {
+        for(int l = 0; l < N; ++l) {
+            boost::uint64_t p0 = (boost::uint64_t)PHILOX_M0 * c0[l];
+            boost::uint64_t p1 = (boost::uint64_t)PHILOX_M1 * c2[l];
+            boost::uint32_t n0 = (boost::uint32_t)(p1 >> 32) ^ c1[l] ^ k0;
+            boost::uint32_t n2 = (boost::uint32_t)(p0 >> 32) ^ c3[l] ^ k1;
+            c0[l] = n0;
+            c1[l] = (boost::uint32_t)p1;
+            c2[l] = n2;
+            c3[l] = (boost::uint32_t)p0;
+        }
+        k0 += PHILOX_W0;
+        k1 += PHILOX_W1;
+    }
+}
+
+inline double to_double(boost::uint32_t a, boost::uint32_t b)
+{
+    return ((a >> 5) * 67108864.0 + (b >> 6)) * (1.0 / 9007199254740992.0);
+}
+
+}
+
+void RandomStream::philox(uint32_t counter[4], const uint32_t key[2])
+{
+    uint32_t k[2] = { key[0], key[1] };
+    for(int round = 0; round < 9; ++round) {
+        philox_round(counter, k);
+        k[0] += PHILOX_W0;
+        k[1] += PHILOX_W1;
+    }
+    philox_round(counter, k);
+}
+
+void RandomStream::init(uint64_t seed, uint64_t stream)
+{
+    _seed = seed;
+    _stream = stream;
+    _position = 0;
+    _has_gaussian = false;
+}
+
+void RandomStream::GenerateBlock()
+{
+    // counter: block number in the low, stream id in the high 64 bits
+    uint64_t block = _position >> 2;
+    _block[0] = (uint32_t)block;
+    _block[1] = (uint32_t)(block >> 32);
+    _block[2] = (uint32_t)_stream;
+    _block[3] = (uint32_t)(_stream >> 32);
+    uint32_t key[2] = { (uint32_t)_seed, (uint32_t)(_seed >> 32) };
+    philox(_block, key);
+}
+
+void RandomStream::seek(uint64_t position)
+{
+    _position = position;
+    _has_gaussian = false;
+    // rand_uint32 only generates at block boundaries
+    if(_position & 3)
+        GenerateBlock();
+}
+
+void RandomStream::skip(uint64_t n)
+{
+    seek(_position + n);
+}
+
+void RandomStream::fill_uniform(double *out, size_t n)
+{
+    const int lanes = 8;
+    size_t k = 0;
+
+    // get to the start of a block, odd positions stay on the scalar path
+    while(k < n && (_position & 3))
+        out[k++] = rand_uniform();
+
+    if(!(_position & 3)) {
+        uint32_t key[2] = { (uint32_t)_seed, (uint32_t)(_seed >> 32) };
+        uint64_t block = _position >> 2;
+        uint32_t c0[lanes], c1[lanes], c2[lanes], c3[lanes];
+        // every block gives two numbers
+        for(; k + 2*lanes <= n; k += 2*lanes, block += lanes) {
+            for(int l = 0; l < lanes; ++l) {
+                c0[l] = (uint32_t)(block + l);
+                c1[l] = (uint32_t)((block + l) >> 32);
+                c2[l] = (uint32_t)_stream;
+                c3[l] = (uint32_t)(_stream >> 32);
+            }
+            philox_lanes<lanes>(c0, c1, c2, c3, key);
+            for(int l = 0; l < lanes; ++l) {
+                out[k + 2*l] = to_double(c0[l], c1[l]);
+                out[k + 2*l + 1] = to_double(c2[l], c3[l]);
+            }
+        }
+        _position = block << 2;
+    }
+
+    for(; k < n; ++k)
+        out[k] = rand_uniform();
+}
+
+void RandomStream::fill_uniform_int(int *out, size_t n, int max_int)
+{
+    fill_int_via_uniform(*this, out, n, max_int);
+}
+
+void RandomStream::fill_gaussian(double *out, size_t n, double sigma)
+{
+    if(n == 0) return;
+    size_t k = 0;
+    if(_has_gaussian)
+        out[k++] = rand_gaussian(sigma);
+    size_t npairs = (n - k) / 2;
+    fill_uniform(out + k, 2*npairs);
+    box_muller(out + k, npairs, sigma);
+    k += 2*npairs;
+    if(k < n)
+        out[k] = rand_gaussian(sigma);
+}
+
+double RandomStream::rand_gaussian(double sigma)
+{
+    if(_has_gaussian) {
+        _has_gaussian = false;
+        return sigma * _gaussian;
+    }
+    double r = sqrt(-2.0 * log(1.0 - rand_uniform()));
+    double theta = 2.0 * M_PI * rand_uniform();
+    _gaussian = r * sin(theta);
+    _has_gaussian = true;
+    return sigma * r * cos(theta);
+}
+
+}}
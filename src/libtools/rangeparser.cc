@@ -20,12 +20,15 @@
 #include <boost/lexical_cast.hpp>
 #include <iostream>
 #include <functional>
+#include <algorithm>
 #include <stdexcept>
+#include <climits>
 
 namespace votca { namespace tools {
 
 RangeParser::RangeParser()
     //: _has_begin(false) , _has_end(false)
+    : _compiled(false), _size(0), _bits_begin(0)
 {
 }
 
@@ -41,6 +44,7 @@ void RangeParser::Parse(string str)
     
     for(bl=tok.begin(); bl!=tok.end();++bl)
         ParseBlock(*bl);
+    Invalidate();
     
 //    list<block_t>::iterator iter;
 //    for(iter=_blocks.begin();iter!=_blocks.end();++iter) {
@@ -69,7 +73,7 @@ void RangeParser::ParseBlock(string str)
         block._end = ToNumber(toks[2]);
     }
         
-    if(block._begin*block._stride > block._end*block._stride) {
+    if((long long)block._begin*block._stride > (long long)block._end*block._stride) {
         throw runtime_error(string("invalid range " + str + ": begin, end and stride do not form a closed interval"));
     }
     
@@ -94,4 +98,183 @@ RangeParser::iterator & RangeParser::iterator::operator++()
     return *this;
 }
 
+// largest bitset built for Contains, 2^27 bits = 16MB
+static const long long max_bits = 1LL << 27;
+
+void RangeParser::Compile() const
+{
+    _runs.clear();
+    _bits.clear();
+    _size = 0;
+
+    // normalize blocks to ascending runs ending on the last index hit
+    vector<run_t> runs;
+    bool unit_stride = true;
+    for(list<block_t>::const_iterator b = _blocks.begin(); b != _blocks.end(); ++b) {
+        run_t r;
+        if(b->_stride == 0 || (long long)b->_begin*b->_stride > (long long)b->_end*b->_stride)
+            continue;
+        if(b->_stride > 0) {
+            r._begin = b->_begin;
+            r._stride = b->_stride;
+            r._end = (int)(b->_begin + ((long long)b->_end - b->_begin) / b->_stride * b->_stride);
+        }
+        else {
+            r._stride = -b->_stride;
+            r._end = b->_begin;
+            r._begin = (int)(b->_begin - ((long long)b->_begin - b->_end) / r._stride * r._stride);
+        }
+        if(r._begin == r._end) r._stride = 1;
+        if(r._stride != 1) unit_stride = false;
+        runs.push_back(r);
+    }
+
+    if(unit_stride) {
+        // merge overlapping and adjacent intervals
+        sort(runs.begin(), runs.end(), RunBeginLess);
+        for(vector<run_t>::iterator r = runs.begin(); r != runs.end(); ++r) {
+            if(!_runs.empty() && (long long)r->_begin <= (long long)_runs.back()._end + 1)
+                _runs.back()._end = max(_runs.back()._end, r->_end);
+            else
+                _runs.push_back(*r);
+        }
+    }
+    else {
+        // strided runs which do not overlap are stored as they are, only
+        // groups of overlapping runs are enumerated and re-encoded
+        sort(runs.begin(), runs.end(), RunBeginLess);
+        for(size_t i = 0; i < runs.size(); ) {
+            size_t j = i + 1;
+            int group_end = runs[i]._end;
+            while(j < runs.size() && runs[j]._begin <= group_end)
+                group_end = max(group_end, runs[j++]._end);
+            if(j == i + 1)
+                _runs.push_back(runs[i]);
+            else
+                EncodeOverlapping(runs.begin() + i, runs.begin() + j, group_end);
+            i = j;
+        }
+    }
+
+    for(vector<run_t>::iterator r = _runs.begin(); r != _runs.end(); ++r) {
+        r->_offset = _size;
+        _size += r->count();
+    }
+
+    if(!_runs.empty()) {
+        long long span = (long long)_runs.back()._end - _runs.front()._begin + 1;
+        if(span <= max_bits) {
+            _bits_begin = _runs.front()._begin;
+            _bits.assign((span + 63) / 64, 0);
+            for(vector<run_t>::iterator r = _runs.begin(); r != _runs.end(); ++r)
+                for(long long k = r->_begin; k <= r->_end; k += r->_stride) {
+                    size_t bit = (size_t)(k - _bits_begin);
+                    _bits[bit >> 6] |= 1ULL << (bit & 63);
+                }
+        }
+    }
+    _compiled = true;
+}
+
+void RangeParser::EncodeOverlapping(vector<run_t>::const_iterator first,
+        vector<run_t>::const_iterator last, int end) const
+{
+    // mark the indices window by window in a bitset, this bounds the memory
+    // and collapses duplicates without sorting
+    vector<unsigned long long> bits;
+    for(long long lo = first->_begin; lo <= end; lo += max_bits) {
+        long long hi = min((long long)end, lo + max_bits - 1);
+        bits.assign((hi - lo + 64) / 64, 0);
+        for(vector<run_t>::const_iterator r = first; r != last && r->_begin <= hi; ++r) {
+            if(r->_end < lo) continue;
+            long long k = r->_begin;
+            if(k < lo)
+                k += (lo - k + r->_stride - 1) / r->_stride * r->_stride;
+            for(; k <= min((long long)r->_end, hi); k += r->_stride) {
+                size_t bit = (size_t)(k - lo);
+                bits[bit >> 6] |= 1ULL << (bit & 63);
+            }
+        }
+        for(size_t w = 0; w < bits.size(); ++w)
+            for(unsigned long long word = bits[w]; word; word &= word - 1)
+                AppendIndex((int)(lo + 64*w + __builtin_ctzll(word)));
+    }
+}
+
+void RangeParser::AppendIndex(int k) const
+{
+    // extend the last run if k continues its stride, otherwise start a new one
+    if(!_runs.empty()) {
+        run_t &r = _runs.back();
+        long long step = (long long)k - r._end;
+        if(r._begin == r._end && step <= INT_MAX) {
+            r._stride = (int)step;
+            r._end = k;
+            return;
+        }
+        if(step == r._stride) {
+            r._end = k;
+            return;
+        }
+    }
+    run_t r;
+    r._begin = r._end = k;
+    r._stride = 1;
+    _runs.push_back(r);
+}
+
+bool RangeParser::RunBeginLess(const run_t &a, const run_t &b)
+{
+    return a._begin < b._begin;
+}
+
+vector<RangeParser::run_t>::const_iterator RangeParser::FindRun(int k) const
+{
+    // first run which ends at or after k
+    size_t lo = 0, hi = _runs.size();
+    while(lo < hi) {
+        size_t mid = (lo + hi) / 2;
+        if(_runs[mid]._end < k) lo = mid + 1;
+        else hi = mid;
+    }
+    return _runs.begin() + lo;
+}
+
+int RangeParser::operator[](size_t i) const
+{
+    if(!_compiled) Compile();
+    if(i >= _size)
+        throw std::out_of_range("RangeParser: index out of range");
+    // last run starting at or before position i
+    size_t lo = 0, hi = _runs.size();
+    while(hi - lo > 1) {
+        size_t mid = (lo + hi) / 2;
+        if(_runs[mid]._offset <= i) lo = mid;
+        else hi = mid;
+    }
+    const run_t &r = _runs[lo];
+    return (int)(r._begin + (long long)(i - r._offset) * r._stride);
+}
+
+vector<RangeParser> RangeParser::Split(size_t n) const
+{
+    if(!_compiled) Compile();
+    vector<RangeParser> chunks(n);
+    size_t run = 0;
+    for(size_t c = 0; c < n; ++c) {
+        size_t first = c * _size / n;
+        size_t last = (c + 1) * _size / n;
+        while(first < last) {
+            while(_runs[run]._offset + _runs[run].count() <= first)
+                ++run;
+            const run_t &r = _runs[run];
+            size_t end = min(last, r._offset + r.count());
+            chunks[c].Add((int)(r._begin + (long long)(first - r._offset) * r._stride),
+                    (int)(r._begin + (long long)(end - 1 - r._offset) * r._stride), r._stride);
+            first = end;
+        }
+    }
+    return chunks;
+}
+
 }}
@@ -0,0 +1,325 @@
+/*
+ * Copyright 2009-2014 The VOTCA Development Team (http://www.votca.org)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <string.h>
+#include <stdlib.h>
+#include <stdexcept>
+#include <algorithm>
+#include <boost/lexical_cast.hpp>
+#include <votca/tools/rngcheckpoint.h>
+#include <votca/tools/random.h>
+#include <votca/tools/random2.h>
+#include <votca/tools/randomstream.h>
+
+namespace votca { namespace tools {
+
+namespace {
+
+const char RNG_MAGIC[8] = { 'V', 'O', 'T', 'C', 'A', 'R', 'N', 'G' };
+const boost::uint32_t RNG_VERSION = 1;
+/// magic, version, number of records
+const size_t RNG_HEADER_SIZE = 16;
+/// type and length in front of every record
+const size_t RNG_RECORD_HEADER_SIZE = 8;
+/// i, j, c, cd, cm and the field
+const size_t MARS_RECORD_SIZE = 8 + 3*8 + MARS_FIELD_SIZE*8;
+/// seed, stream, position, has_gaussian, gaussian
+const size_t STREAM_RECORD_SIZE = 3*8 + 4 + 8;
+/// streams are read in pieces, a corrupt length cannot allocate more than is there
+const size_t RNG_READ_CHUNK = 65536;
+
+void put_u32(std::string &out, boost::uint32_t v)
+{
+    for(int i = 0; i < 4; ++i) out += (char)((v >> (8*i)) & 0xff);
+}
+
+void put_u64(std::string &out, boost::uint64_t v)
+{
+    for(int i = 0; i < 8; ++i) out += (char)((v >> (8*i)) & 0xff);
+}
+
+void put_double(std::string &out, double d)
+{
+    boost::uint64_t v;
+    memcpy(&v, &d, sizeof(v));
+    put_u64(out, v);
+}
+
+/// sequential reader with bounds checking
+class Decoder
+{
+public:
+    Decoder(const char *data, size_t size) : _begin(data), _data(data), _end(data + size) {}
+
+    const char *raw(size_t n) {
+        if((size_t)(_end - _data) < n)
+            throw std::runtime_error("random number checkpoint is truncated");
+        const char *p = _data;
+        _data += n;
+        return p;
+    }
+
+    boost::uint32_t u32() {
+        const char *p = raw(4);
+        boost::uint32_t v = 0;
+        for(int i = 0; i < 4; ++i) v |= (boost::uint32_t)(unsigned char)p[i] << (8*i);
+        return v;
+    }
+
+    boost::uint64_t u64() {
+        const char *p = raw(8);
+        boost::uint64_t v = 0;
+        for(int i = 0; i < 8; ++i) v |= (boost::uint64_t)(unsigned char)p[i] << (8*i);
+        return v;
+    }
+
+    double real() {
+        boost::uint64_t v = u64();
+        double d;
+        memcpy(&d, &v, sizeof(d));
+        return d;
+    }
+
+    size_t consumed() const { return _data - _begin; }
+    size_t remaining() const { return _end - _data; }
+    bool at_end() const { return _data == _end; }
+
+private:
+    const char *_begin, *_data, *_end;
+};
+
+void put_marsaglia(std::string &out, const double *array, int i, int j,
+        double c, double cd, double cm)
+{
+    if(!array)
+        throw std::runtime_error("cannot checkpoint a random number generator which was not initialized");
+    put_u32(out, i);
+    put_u32(out, j);
+    put_double(out, c);
+    put_double(out, cd);
+    put_double(out, cm);
+    for(int k = 0; k < MARS_FIELD_SIZE; ++k)
+        put_double(out, array[k]);
+}
+
+void get_marsaglia(const std::string &in, double *&array, int &i, int &j,
+        double &c, double &cd, double &cm)
+{
+    if(in.size() != MARS_RECORD_SIZE)
+        throw std::runtime_error("random number checkpoint: Marsaglia state has wrong size");
+    Decoder d(in.data(), in.size());
+    boost::uint32_t newi = d.u32(), newj = d.u32();
+    // the generator indexes the field with i and j, which stay in 1..97
+    if(newi < 1 || newi >= MARS_FIELD_SIZE || newj < 1 || newj >= MARS_FIELD_SIZE)
+        throw std::runtime_error("random number checkpoint: Marsaglia state is corrupt");
+    i = newi;
+    j = newj;
+    c = d.real();
+    cd = d.real();
+    cm = d.real();
+    if(!array)
+        array = (double*)malloc(MARS_FIELD_SIZE*sizeof(double));
+    for(int k = 0; k < MARS_FIELD_SIZE; ++k)
+        array[k] = d.real();
+}
+
+void put_stream(std::string &out, const RandomStream &rng, boost::uint64_t position,
+        bool has_gaussian, double gaussian)
+{
+    put_u64(out, rng.seed());
+    put_u64(out, rng.stream());
+    put_u64(out, position);
+    put_u32(out, has_gaussian);
+    put_double(out, gaussian);
+}
+
+/// check magic and version, returns the number of records
+boost::uint32_t get_header(Decoder &d)
+{
+    if(memcmp(d.raw(sizeof(RNG_MAGIC)), RNG_MAGIC, sizeof(RNG_MAGIC)) != 0)
+        throw std::runtime_error("not a random number checkpoint");
+    boost::uint32_t version = d.u32();
+    if(version != RNG_VERSION)
+        throw std::runtime_error("unsupported random number checkpoint version "
+                + boost::lexical_cast<std::string>(version));
+    return d.u32();
+}
+
+/// append n bytes from in to blob
+void read_bytes(std::istream &in, std::string &blob, size_t n)
+{
+    while(n > 0) {
+        size_t chunk = std::min(n, RNG_READ_CHUNK);
+        size_t pos = blob.size();
+        blob.resize(pos + chunk);
+        if(!in.read(&blob[pos], chunk))
+            throw std::runtime_error("random number checkpoint is truncated");
+        n -= chunk;
+    }
+}
+
+}
+
+std::string &RNGCheckpoint::Add(record_type_t type)
+{
+    _records.push_back(record_t());
+    _records.back().type = type;
+    return _records.back().data;
+}
+
+const std::string &RNGCheckpoint::Next(record_type_t type)
+{
+    if(_next >= _records.size())
+        throw std::runtime_error("random number checkpoint contains no more states");
+    const record_t &r = _records[_next];
+    if(r.type != (boost::uint32_t)type)
+        throw std::runtime_error("random number checkpoint: expected state of type "
+                + boost::lexical_cast<std::string>(type) + ", found type "
+                + boost::lexical_cast<std::string>(r.type));
+    ++_next;
+    return r.data;
+}
+
+void RNGCheckpoint::StoreGlobalRandom()
+{
+    std::string &data = Add(RECORD_MARSAGLIA_GLOBAL);
+    put_marsaglia(data, Random::MARSarray, Random::MARSi, Random::MARSj,
+            Random::MARSc, Random::MARScd, Random::MARScm);
+}
+
+void RNGCheckpoint::Store(const Random2 &rng)
+{
+    std::string &data = Add(RECORD_MARSAGLIA);
+    put_marsaglia(data, rng.MARSarray, rng.MARSi, rng.MARSj,
+            rng.MARSc, rng.MARScd, rng.MARScm);
+}
+
+void RNGCheckpoint::Store(const RandomStream &rng)
+{
+    std::string &data = Add(RECORD_STREAM);
+    put_stream(data, rng, rng._position, rng._has_gaussian, rng._gaussian);
+}
+
+void RNGCheckpoint::Store(const std::vector<RandomStream> &streams)
+{
+    std::string &data = Add(RECORD_STREAM_SET);
+    put_u32(data, streams.size());
+    for(size_t i = 0; i < streams.size(); ++i)
+        put_stream(data, streams[i], streams[i]._position,
+                streams[i]._has_gaussian, streams[i]._gaussian);
+}
+
+void RNGCheckpoint::RestoreGlobalRandom()
+{
+    get_marsaglia(Next(RECORD_MARSAGLIA_GLOBAL), Random::MARSarray, Random::MARSi,
+            Random::MARSj, Random::MARSc, Random::MARScd, Random::MARScm);
+}
+
+void RNGCheckpoint::Restore(Random2 &rng)
+{
+    get_marsaglia(Next(RECORD_MARSAGLIA), rng.MARSarray, rng.MARSi, rng.MARSj,
+            rng.MARSc, rng.MARScd, rng.MARScm);
+}
+
+void RNGCheckpoint::SetState(RandomStream &rng, boost::uint64_t seed, boost::uint64_t stream,
+        boost::uint64_t position, bool has_gaussian, double gaussian)
+{
+    rng.init(seed, stream);
+    rng.seek(position);
+    rng._has_gaussian = has_gaussian;
+    rng._gaussian = gaussian;
+}
+
+void RNGCheckpoint::Restore(RandomStream &rng)
+{
+    const std::string &data = Next(RECORD_STREAM);
+    if(data.size() != STREAM_RECORD_SIZE)
+        throw std::runtime_error("random number checkpoint: stream state has wrong size");
+    Decoder d(data.data(), data.size());
+    boost::uint64_t seed = d.u64(), stream = d.u64(), position = d.u64();
+    bool has_gaussian = d.u32() != 0;
+    SetState(rng, seed, stream, position, has_gaussian, d.real());
+}
+
+void RNGCheckpoint::Restore(std::vector<RandomStream> &streams)
+{
+    const std::string &data = Next(RECORD_STREAM_SET);
+    Decoder d(data.data(), data.size());
+    boost::uint32_t n = d.u32();
+    if(d.remaining() % STREAM_RECORD_SIZE != 0 || d.remaining() / STREAM_RECORD_SIZE != n)
+        throw std::runtime_error("random number checkpoint: stream set has wrong size");
+    streams.resize(n);
+    for(size_t i = 0; i < streams.size(); ++i) {
+        boost::uint64_t seed = d.u64(), stream = d.u64(), position = d.u64();
+        bool has_gaussian = d.u32() != 0;
+        SetState(streams[i], seed, stream, position, has_gaussian, d.real());
+    }
+}
+
+std::string RNGCheckpoint::ToString() const
+{
+    std::string out(RNG_MAGIC, sizeof(RNG_MAGIC));
+    put_u32(out, RNG_VERSION);
+    put_u32(out, _records.size());
+    for(size_t i = 0; i < _records.size(); ++i) {
+        put_u32(out, _records[i].type);
+        put_u32(out, _records[i].data.size());
+        out += _records[i].data;
+    }
+    return out;
+}
+
+void RNGCheckpoint::Write(std::ostream &out) const
+{
+    std::string blob = ToString();
+    out.write(blob.data(), blob.size());
+}
+
+size_t RNGCheckpoint::Read(const char *data, size_t size)
+{
+    Decoder d(data, size);
+    boost::uint32_t nrecords = get_header(d);
+    if(nrecords > d.remaining() / RNG_RECORD_HEADER_SIZE)
+        throw std::runtime_error("random number checkpoint is truncated");
+
+    std::vector<record_t> records(nrecords);
+    for(size_t i = 0; i < records.size(); ++i) {
+        records[i].type = d.u32();
+        boost::uint32_t length = d.u32();
+        records[i].data.assign(d.raw(length), length);
+    }
+    _records.swap(records);
+    _next = 0;
+    return d.consumed();
+}
+
+void RNGCheckpoint::Read(std::istream &in)
+{
+    // read the header and all records, then parse the whole blob
+    std::string blob;
+    read_bytes(in, blob, RNG_HEADER_SIZE);
+    Decoder header(blob.data(), blob.size());
+    boost::uint32_t nrecords = get_header(header);
+    for(boost::uint32_t i = 0; i < nrecords; ++i) {
+        size_t pos = blob.size();
+        read_bytes(in, blob, RNG_RECORD_HEADER_SIZE);
+        read_bytes(in, blob, Decoder(blob.data() + pos + 4, 4).u32());
+    }
+    Read(blob.data(), blob.size());
+}
+
+}}
@@ -0,0 +1,151 @@
+/*
+ * Copyright 2009-2014 The VOTCA Development Team (http://www.votca.org)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <votca/tools/sparsematrix.h>
+#include <algorithm>
+
+namespace votca { namespace tools {
+
+using namespace std;
+
+double SparseMatrix::operator()(size_t i, size_t j) const
+{
+    vector<unsigned int>::const_iterator begin = _col_index.begin() + _row_ptr[i];
+    vector<unsigned int>::const_iterator end = _col_index.begin() + _row_ptr[i+1];
+    vector<unsigned int>::const_iterator p = lower_bound(begin, end, (unsigned int)j);
+    if(p == end || *p != j)
+        return 0;
+    return _values[p - _col_index.begin()];
+}
+
+void SparseMatrix::prod(const double *x, double *y) const
+{
+    for(size_t i=0; i<_size1; ++i) {
+        double s = 0;
+        for(size_t k=_row_ptr[i]; k<_row_ptr[i+1]; ++k)
+            s += _values[k]*x[_col_index[k]];
+        y[i] = s;
+    }
+}
+
+void SparseMatrix::trans_prod(const double *x, double *y) const
+{
+    fill(y, y + _size2, 0.0);
+    for(size_t i=0; i<_size1; ++i) {
+        const double xi = x[i];
+        for(size_t k=_row_ptr[i]; k<_row_ptr[i+1]; ++k)
+            y[_col_index[k]] += _values[k]*xi;
+    }
+}
+
+void SparseMatrix::prod(const ub::vector<double> &x, ub::vector<double> &y) const
+{
+    if(x.size() != _size2)
+        throw std::invalid_argument("SparseMatrix::prod: size of x does not match");
+    y.resize(_size1, false);
+    if(_size1 == 0) return;
+    prod(&x.data()[0], &y(0));
+}
+
+void SparseMatrix::trans_prod(const ub::vector<double> &x, ub::vector<double> &y) const
+{
+    if(x.size() != _size1)
+        throw std::invalid_argument("SparseMatrix::trans_prod: size of x does not match");
+    y.resize(_size2, false);
+    if(_size2 == 0) return;
+    trans_prod(&x.data()[0], &y(0));
+}
+
+void SparseMatrix::ColumnNorms2(ub::vector<double> &norms) const
+{
+    norms = ub::zero_vector<double>(_size2);
+    for(size_t k=0; k<_values.size(); ++k)
+        norms(_col_index[k]) += _values[k]*_values[k];
+}
+
+void SparseMatrix::ToDense(ub::matrix<double> &A) const
+{
+    A = ub::zero_matrix<double>(_size1, _size2);
+    for(size_t i=0; i<_size1; ++i)
+        for(size_t k=_row_ptr[i]; k<_row_ptr[i+1]; ++k)
+            A(i, _col_index[k]) = _values[k];
+}
+
+size_t SparseMatrix::MemoryUsage() const
+{
+    return sizeof(*this) + _row_ptr.capacity()*sizeof(size_t)
+        + _col_index.capacity()*sizeof(unsigned int)
+        + _values.capacity()*sizeof(double);
+}
+
+void SparseMatrixBuilder::Build(SparseMatrix &A) const
+{
+    // bucket the entries by row (counting sort keeps the order of insertion)
+    vector<size_t> start(_size1 + 1, 0);
+    for(size_t k=0; k<_triplets.size(); ++k)
+        start[_triplets[k].row + 1]++;
+    for(size_t i=0; i<_size1; ++i)
+        start[i+1] += start[i];
+
+    vector<triplet_t> sorted(_triplets.size());
+    {
+        vector<size_t> pos(start.begin(), start.end() - 1);
+        for(size_t k=0; k<_triplets.size(); ++k)
+            sorted[pos[_triplets[k].row]++] = _triplets[k];
+    }
+
+    A._size1 = _size1;
+    A._size2 = _size2;
+    A._row_ptr.resize(_size1 + 1);
+    A._col_index.clear();
+    A._values.clear();
+    A._col_index.reserve(_triplets.size());
+    A._values.reserve(_triplets.size());
+    A._row_ptr[0] = 0;
+
+    for(size_t i=0; i<_size1; ++i) {
+        triplet_t *begin = sorted.empty() ? NULL : &sorted[0] + start[i];
+        triplet_t *end = sorted.empty() ? NULL : &sorted[0] + start[i+1];
+
+        // sort the row by column, rows are usually short
+        if(end - begin > 32)
+            stable_sort(begin, end, column_less);
+        else
+            for(triplet_t *p=begin+1; p<end; ++p) {
+                triplet_t t = *p;
+                triplet_t *q = p;
+                for(; q>begin && (q-1)->col > t.col; --q)
+                    *q = *(q-1);
+                *q = t;
+            }
+
+        // combine duplicates in the order they were given
+        for(triplet_t *p=begin; p<end; ) {
+            unsigned int col = p->col;
+            double value = 0;
+            for(; p<end && p->col == col; ++p)
+                value = p->assign ? p->value : value + p->value;
+            if(value != 0) {
+                A._col_index.push_back(col);
+                A._values.push_back(value);
+            }
+        }
+        A._row_ptr[i+1] = A._values.size();
+    }
+}
+
+}}
@@ -78,6 +78,12 @@ void Table::clear(void)
     _yerr.clear();
 }
 
+static void ConversionError(Table &t, int line_number)
+{
+    throw runtime_error("invaid type: " + t.getErrorDetails() + ", line "
+            + boost::lexical_cast<string>(line_number));
+}
+
 // TODO: this functon is weired, reading occours twice, cleanup!!
 // TODO: modify function to work properly, when _has_yerr is true
 istream &operator>>(istream &in, Table& t)
@@ -88,10 +94,13 @@ istream &operator>>(istream &in, Table& t)
     int line_number=0;
    t.clear();
     
+    // views into the tokenizer, reused for all lines
+    vector<boost::string_ref> tokens;
+    double x, y;
+
     // read till the first data line
     while(getline(in, line)) {
         line_number++;
-        string conversion_error =  t.getErrorDetails() + ", line " + boost::lexical_cast<string>(line_number);
 
         // remove comments and xmgrace stuff
         line = line.substr(0, line.find("#"));
@@ -99,7 +108,7 @@ istream &operator>>(istream &in, Table& t)
     
         // tokenize string and put it to vector
         Tokenizer tok(line, " \t");
-        vector<string> tokens;
+        tokens.clear();
         tok.ToVector(tokens);
         
         // skip empty lines
@@ -107,19 +116,23 @@ istream &operator>>(istream &in, Table& t)
         
         // if first line is only 1 token, it's the size
         if(tokens.size() == 1) {
-            N = lexical_cast<int>(tokens[0], conversion_error);
+            int n;
+            if(!parse_token(tokens[0], n))
+                ConversionError(t, line_number);
+            N = n;
             bHasN = true;
         }
         // it's the first data line with 2 or 3 entries
-        else if(tokens.size() == 2) {
-            t.push_back(lexical_cast<double>(tokens[0], conversion_error), lexical_cast<double>(tokens[1], conversion_error), 'i');
-        }
-        else if(tokens.size() > 2) {
-           char flag='i';
-           string sflag = tokens.back();
-            if(sflag == "i" || sflag == "o" || sflag == "u")
-                flag = sflag.c_str()[0];
-            t.push_back(lexical_cast<double>(tokens[0], conversion_error), lexical_cast<double>(tokens[1], conversion_error), flag);
+        else if(tokens.size() >= 2) {
+            char flag='i';
+            if(tokens.size() > 2) {
+                boost::string_ref sflag = tokens.back();
+                if(sflag == "i" || sflag == "o" || sflag == "u")
+                    flag = sflag[0];
+            }
+            if(!parse_token(tokens[0], x) || !parse_token(tokens[1], y))
+                ConversionError(t, line_number);
+            t.push_back(x, y, flag);
         }
         else throw runtime_error("error, wrong table format");                                
     }
@@ -127,7 +140,6 @@ istream &operator>>(istream &in, Table& t)
     // read the rest
     while(getline(in, line)) {
         line_number++;
-        string conversion_error =  t.getErrorDetails() + ", line " + boost::lexical_cast<string>(line_number);
 
         // remove comments and xmgrace stuff
         line = line.substr(0, line.find("#"));
@@ -135,21 +147,20 @@ istream &operator>>(istream &in, Table& t)
     
         // tokenize string and put it to vector
         Tokenizer tok(line, " \t");
-        vector<string> tokens;
+        tokens.clear();
         tok.ToVector(tokens);
         
         // skip empty lines
         if(tokens.size()==0) continue;
                     
         // it's a data line
-        if(tokens.size() == 2) {            
-            t.push_back(lexical_cast<double>(tokens[0], conversion_error), lexical_cast<double>(tokens[1], conversion_error), 'i');
-        }
-        else if(tokens.size() > 2) {
+        if(tokens.size() >= 2) {
             char flag='i';
-            if(tokens[2] == "i" || tokens[2] == "o" || tokens[2] == "u")
-                flag = tokens[2].c_str()[0];
-            t.push_back(lexical_cast<double>(tokens[0], conversion_error), lexical_cast<double>(tokens[1], conversion_error), flag);
+            if(tokens.size() > 2 && (tokens[2] == "i" || tokens[2] == "o" || tokens[2] == "u"))
+                flag = tokens[2][0];
+            if(!parse_token(tokens[0], x) || !parse_token(tokens[1], y))
+                ConversionError(t, line_number);
+            t.push_back(x, y, flag);
         }
         // otherwise error
         else throw runtime_error("error, wrong table format");                                
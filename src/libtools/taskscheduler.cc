@@ -0,0 +1,234 @@
+/*
+ * Copyright 2009-2014 The VOTCA Development Team (http://www.votca.org)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <unistd.h>
+#include <algorithm>
+#include <stdexcept>
+#include <votca/tools/taskscheduler.h>
+
+namespace votca { namespace tools {
+
+namespace {
+    /// worker running in this thread, NULL for threads outside any pool
+    __thread void *current_worker = NULL;
+}
+
+TaskScheduler::TaskScheduler(int nworkers)
+    : _pending(0), _shutdown(false)
+{
+    nworkers = std::max(1, nworkers);
+    for(int i = 0; i < nworkers; ++i)
+        _workers.push_back(new Worker(this, i));
+    for(int i = 0; i < nworkers; ++i)
+        _workers[i]->Start();
+}
+
+TaskScheduler::~TaskScheduler()
+{
+    {
+        ScopedLock lock(_sleep_mutex);
+        _shutdown = true;
+        _wakeup.Broadcast();
+    }
+
+    for(size_t i = 0; i < _workers.size(); ++i) {
+        _workers[i]->WaitDone();
+        delete _workers[i];
+    }
+}
+
+TaskScheduler &TaskScheduler::Instance()
+{
+    static TaskScheduler scheduler(sysconf(_SC_NPROCESSORS_ONLN));
+    return scheduler;
+}
+
+TaskScheduler::Worker *TaskScheduler::CurrentWorker()
+{
+    Worker *worker = (Worker *)current_worker;
+    if(worker && worker->_scheduler == this)
+        return worker;
+    return NULL;
+}
+
+void TaskScheduler::Push(Task *task)
+{
+    Worker *self = CurrentWorker();
+    // hold _sleep_mutex while publishing: a Take of this task can only
+    // decrement _pending after it was incremented here
+    ScopedLock sleep(_sleep_mutex);
+    if(self) {
+        ScopedLock lock(self->_mutex);
+        self->_tasks.push_back(task);
+    }
+    else {
+        ScopedLock lock(_injected_mutex);
+        _injected.push_back(task);
+    }
+    ++_pending;
+    _wakeup.Signal();
+}
+
+Task *TaskScheduler::Take(Worker *self)
+{
+    Task *task = NULL;
+
+    // own tasks, newest first
+    if(self) {
+        ScopedLock lock(self->_mutex);
+        if(!self->_tasks.empty()) {
+            task = self->_tasks.back();
+            self->_tasks.pop_back();
+        }
+    }
+
+    if(!task) {
+        ScopedLock lock(_injected_mutex);
+        if(!_injected.empty()) {
+            task = _injected.front();
+            _injected.pop_front();
+        }
+    }
+
+    // steal the oldest task of another worker
+    size_t start = self ? self->_id + 1 : 0;
+    for(size_t i = 0; !task && i < _workers.size(); ++i) {
+        Worker *victim = _workers[(start + i) % _workers.size()];
+        if(victim == self) continue;
+        ScopedLock lock(victim->_mutex);
+        if(!victim->_tasks.empty()) {
+            task = victim->_tasks.front();
+            victim->_tasks.pop_front();
+        }
+    }
+
+    if(task) {
+        ScopedLock lock(_sleep_mutex);
+        --_pending;
+    }
+    return task;
+}
+
+void TaskScheduler::Run(Task *task)
+{
+    TaskGroup *group = task->_group;
+    bool failed = false;
+    std::string error;
+    try {
+        task->Execute();
+    }
+    catch(std::exception &e) {
+        failed = true;
+        error = e.what();
+    }
+    catch(...) {
+        failed = true;
+        error = "unknown exception in task";
+    }
+    group->Finished(failed, error);
+}
+
+void TaskScheduler::Worker::Run()
+{
+    current_worker = this;
+    while(true) {
+        Task *task = _scheduler->Take(this);
+        if(task) {
+            _scheduler->Run(task);
+            continue;
+        }
+
+        ScopedLock lock(_scheduler->_sleep_mutex);
+        while(_scheduler->_pending == 0 && !_scheduler->_shutdown)
+            _scheduler->_wakeup.Wait(_scheduler->_sleep_mutex);
+        if(_scheduler->_shutdown && _scheduler->_pending == 0)
+            break;
+    }
+    current_worker = NULL;
+}
+
+TaskGroup::TaskGroup(TaskScheduler &scheduler)
+    : _scheduler(scheduler), _remaining(0), _failed(false)
+{
+}
+
+TaskGroup::~TaskGroup()
+{
+    WaitNoThrow();
+}
+
+void TaskGroup::Spawn(Task *task)
+{
+    task->_group = this;
+    {
+        ScopedLock lock(_mutex);
+        ++_remaining;
+    }
+    _scheduler.Push(task);
+}
+
+void TaskGroup::Finished(bool failed, const std::string &error)
+{
+    ScopedLock lock(_mutex);
+    if(failed && !_failed) {
+        _failed = true;
+        _error = error;
+    }
+    if(--_remaining == 0)
+        _done.Broadcast();
+}
+
+void TaskGroup::WaitNoThrow()
+{
+    TaskScheduler::Worker *self = _scheduler.CurrentWorker();
+    while(true) {
+        {
+            ScopedLock lock(_mutex);
+            if(_remaining == 0) break;
+        }
+
+        // help with queued tasks (of any group) instead of blocking
+        Task *task = _scheduler.Take(self);
+        if(task) {
+            _scheduler.Run(task);
+            continue;
+        }
+
+        // all tasks of the group are running elsewhere
+        ScopedLock lock(_mutex);
+        while(_remaining != 0)
+            _done.Wait(_mutex);
+    }
+}
+
+void TaskGroup::Wait()
+{
+    WaitNoThrow();
+    bool failed;
+    std::string error;
+    {
+        ScopedLock lock(_mutex);
+        failed = _failed;
+        error = _error;
+        _failed = false;
+        _error.clear();
+    }
+    if(failed)
+        throw std::runtime_error(error);
+}
+
+}}
@@ -15,10 +15,131 @@
  *
  */
 
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include <errno.h>
+#include <limits.h>
+#include <math.h>
+#include <limits>
 #include <votca/tools/tokenizer.h>
 
 namespace votca { namespace tools {
 
+void Tokenizer::SetSeparators(const char *separators)
+{
+    memset(_separator, 0, sizeof(_separator));
+    for(const char *c = separators; *c; ++c)
+        _separator[(unsigned char)*c] = true;
+}
+
+size_t Tokenizer::size() const
+{
+    size_t n = 0;
+    for(size_t pos = WordBegin(0); pos < _str.size(); pos = WordBegin(WordEnd(pos)))
+        ++n;
+    return n;
+}
+
+namespace {
+
+/**
+ * copies a token to a zero terminated buffer for the strto* functions,
+ * short tokens (all numbers) stay on the stack
+ */
+class TokenBuffer {
+public:
+    explicit TokenBuffer(const boost::string_ref &tok) {
+        if(tok.size() < sizeof(_buf)) {
+            memcpy(_buf, tok.data(), tok.size());
+            _buf[tok.size()] = '\0';
+            _str = _buf;
+        }
+        else {
+            _long.assign(tok.data(), tok.size());
+            _str = _long.c_str();
+        }
+    }
+    const char *c_str() const { return _str; }
+
+private:
+    char _buf[64];
+    std::string _long;
+    const char *_str;
+};
+
+/// lexical_cast does not allow leading spaces, empty strings or hex numbers
+inline bool valid_number(const boost::string_ref &tok)
+{
+    return !tok.empty() && !isspace((unsigned char)tok[0])
+            && tok.find_first_of("xX") == boost::string_ref::npos;
+}
+
+/// float is parsed directly, rounding through double can overflow near FLT_MAX
+inline double to_floating(const char *str, char **end, double) { return strtod(str, end); }
+inline float to_floating(const char *str, char **end, float) { return strtof(str, end); }
+
+template<typename T>
+bool parse_floating(const boost::string_ref &tok, T &v)
+{
+    if(!valid_number(tok)) return false;
+    TokenBuffer buf(tok);
+    char *end;
+    errno = 0;
+    T d = to_floating(buf.c_str(), &end, T());
+    if(*end != '\0' || (errno == ERANGE && fabs(d) > std::numeric_limits<T>::max()))
+        return false;
+    v = d;
+    return true;
+}
+
+bool parse_integer(const boost::string_ref &tok, long min, long max, long &v)
+{
+    if(!valid_number(tok)) return false;
+    TokenBuffer buf(tok);
+    char *end;
+    errno = 0;
+    long l = strtol(buf.c_str(), &end, 10);
+    if(*end != '\0' || errno == ERANGE || l < min || l > max)
+        return false;
+    v = l;
+    return true;
+}
+
+}
+
+bool parse_token(const boost::string_ref &tok, double &v)
+{
+    return parse_floating(tok, v);
+}
+
+bool parse_token(const boost::string_ref &tok, float &v)
+{
+    return parse_floating(tok, v);
+}
+
+bool parse_token(const boost::string_ref &tok, int &v)
+{
+    long l;
+    if(!parse_integer(tok, INT_MIN, INT_MAX, l)) return false;
+    v = (int)l;
+    return true;
+}
+
+bool parse_token(const boost::string_ref &tok, unsigned int &v)
+{
+    // like lexical_cast, negative numbers wrap around
+    long l;
+    if(!parse_integer(tok, -(long)UINT_MAX, UINT_MAX, l)) return false;
+    v = (unsigned int)l;
+    return true;
+}
+
+bool parse_token(const boost::string_ref &tok, long &v)
+{
+    return parse_integer(tok, LONG_MIN, LONG_MAX, v);
+}
+
 int wildcmp(const char *wild, const char *string) {
     // Written by Jack Handy - jakkhandy@hotmail.com
     const char *cp = NULL, *mp = NULL;
@@ -0,0 +1,208 @@
+/*
+ * Copyright 2009-2014 The VOTCA Development Team (http://www.votca.org)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <string.h>
+#include <stdexcept>
+#include <votca/tools/vecarray.h>
+#include "alignedarray.h"
+
+namespace votca { namespace tools {
+
+template<typename T>
+VecArray_t<T>::VecArray_t()
+    : _size(0), _capacity(0)
+{
+    _c[0] = _c[1] = _c[2] = NULL;
+}
+
+template<typename T>
+VecArray_t<T>::VecArray_t(size_t n)
+    : _size(0), _capacity(0)
+{
+    _c[0] = _c[1] = _c[2] = NULL;
+    resize(n);
+}
+
+template<typename T>
+VecArray_t<T>::VecArray_t(const VecArray_t &a)
+    : _size(0), _capacity(0)
+{
+    _c[0] = _c[1] = _c[2] = NULL;
+    *this = a;
+}
+
+template<typename T>
+VecArray_t<T>::~VecArray_t()
+{
+    free(_c[0]);
+}
+
+template<typename T>
+VecArray_t<T> &VecArray_t<T>::operator=(const VecArray_t &a)
+{
+    if(this == &a) return *this;
+    resize(a.size());
+    for(int c = 0; c < 3; ++c)
+        memcpy(_c[c], a._c[c], _size*sizeof(T));
+    return *this;
+}
+
+template<typename T>
+void VecArray_t<T>::reserve(size_t n)
+{
+    aligned_reserve(_c, 3, _size, _capacity, n);
+}
+
+template<typename T>
+void VecArray_t<T>::resize(size_t n)
+{
+    reserve(n);
+    _size = n;
+}
+
+template<typename T>
+void VecArray_t<T>::push_back(const vec_t<T> &v)
+{
+    if(_size == _capacity)
+        reserve(_capacity ? 2*_capacity : 16);
+    set(_size++, v);
+}
+
+template<typename T>
+void dot(const VecArray_t<T> &a, const VecArray_t<T> &b, T *out)
+{
+    check_size(a.size(), b.size());
+    const T *ax = assume_aligned(a.x()), *ay = assume_aligned(a.y()), *az = assume_aligned(a.z());
+    const T *bx = assume_aligned(b.x()), *by = assume_aligned(b.y()), *bz = assume_aligned(b.z());
+    const size_t n = a.size();
+#pragma GCC ivdep
+    for(size_t i = 0; i < n; ++i)
+        out[i] = ax[i]*bx[i] + ay[i]*by[i] + az[i]*bz[i];
+}
+
+template<typename T>
+void abs(const VecArray_t<T> &a, T *out)
+{
+    const T *ax = assume_aligned(a.x()), *ay = assume_aligned(a.y()), *az = assume_aligned(a.z());
+    const size_t n = a.size();
+#pragma GCC ivdep
+    for(size_t i = 0; i < n; ++i)
+        out[i] = sqrt(ax[i]*ax[i] + ay[i]*ay[i] + az[i]*az[i]);
+}
+
+template<typename T>
+void cross(const VecArray_t<T> &a, const VecArray_t<T> &b, VecArray_t<T> &out)
+{
+    check_size(a.size(), b.size());
+    out.resize(a.size());
+    const T *ax = assume_aligned(a.x()), *ay = assume_aligned(a.y()), *az = assume_aligned(a.z());
+    const T *bx = assume_aligned(b.x()), *by = assume_aligned(b.y()), *bz = assume_aligned(b.z());
+    T *ox = assume_aligned(out.x()), *oy = assume_aligned(out.y()), *oz = assume_aligned(out.z());
+    const size_t n = a.size();
+#pragma GCC ivdep
+    for(size_t i = 0; i < n; ++i) {
+        T x1 = ax[i], y1 = ay[i], z1 = az[i];
+        T x2 = bx[i], y2 = by[i], z2 = bz[i];
+        ox[i] = y1*z2 - z1*y2;
+        oy[i] = z1*x2 - x1*z2;
+        oz[i] = x1*y2 - y1*x2;
+    }
+}
+
+template<typename T>
+void axpy(typename VecArray_t<T>::scalar_t alpha, const VecArray_t<T> &x, VecArray_t<T> &y)
+{
+    check_size(x.size(), y.size());
+    const T *xx = assume_aligned(x.x()), *xy = assume_aligned(x.y()), *xz = assume_aligned(x.z());
+    T *yx = assume_aligned(y.x()), *yy = assume_aligned(y.y()), *yz = assume_aligned(y.z());
+    const size_t n = x.size();
+#pragma GCC ivdep
+    for(size_t i = 0; i < n; ++i) {
+        yx[i] += alpha*xx[i];
+        yy[i] += alpha*xy[i];
+        yz[i] += alpha*xz[i];
+    }
+}
+
+template<typename T>
+void distances(const VecArray_t<T> &a, const VecArray_t<T> &b, T *out)
+{
+    check_size(a.size(), b.size());
+    const T *ax = assume_aligned(a.x()), *ay = assume_aligned(a.y()), *az = assume_aligned(a.z());
+    const T *bx = assume_aligned(b.x()), *by = assume_aligned(b.y()), *bz = assume_aligned(b.z());
+    const size_t n = a.size();
+#pragma GCC ivdep
+    for(size_t i = 0; i < n; ++i) {
+        T dx = ax[i] - bx[i], dy = ay[i] - by[i], dz = az[i] - bz[i];
+        out[i] = sqrt(dx*dx + dy*dy + dz*dz);
+    }
+}
+
+template<typename T>
+void distances(const VecArray_t<T> &a, const vec_t<T> &p, T *out)
+{
+    const T *ax = assume_aligned(a.x()), *ay = assume_aligned(a.y()), *az = assume_aligned(a.z());
+    const T px = p.getX(), py = p.getY(), pz = p.getZ();
+    const size_t n = a.size();
+#pragma GCC ivdep
+    for(size_t i = 0; i < n; ++i) {
+        T dx = ax[i] - px, dy = ay[i] - py, dz = az[i] - pz;
+        out[i] = sqrt(dx*dx + dy*dy + dz*dz);
+    }
+}
+
+template<typename T>
+vec_t<T> center_of_mass(const VecArray_t<T> &a, const typename VecArray_t<T>::scalar_t *masses)
+{
+    const T *ax = assume_aligned(a.x()), *ay = assume_aligned(a.y()), *az = assume_aligned(a.z());
+    const size_t n = a.size();
+    double sx = 0, sy = 0, sz = 0, m = 0;
+    if(masses) {
+        for(size_t i = 0; i < n; ++i) {
+            sx += masses[i]*ax[i];
+            sy += masses[i]*ay[i];
+            sz += masses[i]*az[i];
+            m += masses[i];
+        }
+    }
+    else {
+        for(size_t i = 0; i < n; ++i) {
+            sx += ax[i];
+            sy += ay[i];
+            sz += az[i];
+        }
+        m = n;
+    }
+    if(m == 0)
+        throw std::runtime_error("center_of_mass: total mass is zero");
+    return vec_t<T>(sx/m, sy/m, sz/m);
+}
+
+#define VECARRAY_INSTANTIATE(T) \
+    template class VecArray_t<T>; \
+    template void dot(const VecArray_t<T> &, const VecArray_t<T> &, T *); \
+    template void abs(const VecArray_t<T> &, T *); \
+    template void cross(const VecArray_t<T> &, const VecArray_t<T> &, VecArray_t<T> &); \
+    template void axpy(VecArray_t<T>::scalar_t, const VecArray_t<T> &, VecArray_t<T> &); \
+    template void distances(const VecArray_t<T> &, const VecArray_t<T> &, T *); \
+    template void distances(const VecArray_t<T> &, const vec_t<T> &, T *); \
+    template vec_t<T> center_of_mass(const VecArray_t<T> &, const VecArray_t<T>::scalar_t *);
+
+VECARRAY_INSTANTIATE(double)
+VECARRAY_INSTANTIATE(float)
+
+}}
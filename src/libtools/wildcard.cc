@@ -0,0 +1,51 @@
+/*
+ * Copyright 2009-2014 The VOTCA Development Team (http://www.votca.org)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <votca/tools/wildcard.h>
+
+namespace votca { namespace tools {
+
+void WildcardPattern::Compile(const std::string &pattern)
+{
+    _pattern = pattern;
+    _segments.clear();
+    _star = false;
+    _literal = true;
+    _min_length = 0;
+
+    segment_t seg;
+    seg.begin = 0;
+    seg.any = false;
+    for(size_t i = 0; i <= _pattern.size(); ++i) {
+        if(i == _pattern.size() || _pattern[i] == '*') {
+            seg.length = i - seg.begin;
+            // empty segments between two '*' do not need to be searched
+            if(seg.length > 0 || _segments.empty() || i == _pattern.size())
+                _segments.push_back(seg);
+            _min_length += seg.length;
+            if(i < _pattern.size())
+                _star = true;
+            seg.begin = i + 1;
+            seg.any = false;
+        }
+        else if(_pattern[i] == '?')
+            seg.any = true;
+    }
+    _literal = !_star && !_segments.front().any;
+}
+
+}}
@@ -0,0 +1,75 @@
+/*
+ * Copyright 2009-2014 The VOTCA Development Team (http://www.votca.org)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <stdio.h>
+#include <ios>
+#include <stdexcept>
+#include <boost/lexical_cast.hpp>
+#include "xmlbuffer.h"
+
+namespace votca { namespace tools {
+
+// size of the blocks handed to expat
+static const int XML_BLOCK_SIZE = 1 << 20;
+
+static std::string xml_error(XML_Parser parser, const std::string &name)
+{
+    return name + ": Parse error at line " +
+        boost::lexical_cast<std::string>(XML_GetCurrentLineNumber(parser)) + "\n" +
+        XML_ErrorString(XML_GetErrorCode(parser));
+}
+
+void xml_parse_file(XML_Parser parser, const std::string &filename)
+{
+    FILE *fl = fopen(filename.c_str(), "rb");
+    if(!fl)
+        throw std::ios_base::failure("Error on open xml file: " + filename);
+
+    bool done = false;
+    while(!done) {
+        void *buffer = XML_GetBuffer(parser, XML_BLOCK_SIZE);
+        if(!buffer) {
+            fclose(fl);
+            throw std::runtime_error("Couldn't allocate memory for xml parser");
+        }
+        size_t len = fread(buffer, 1, XML_BLOCK_SIZE, fl);
+        if(ferror(fl)) {
+            fclose(fl);
+            throw std::ios_base::failure("Error on reading xml file: " + filename);
+        }
+        done = (len < (size_t)XML_BLOCK_SIZE);
+        if(!XML_ParseBuffer(parser, (int)len, done)) {
+            fclose(fl);
+            throw std::ios_base::failure(xml_error(parser, filename));
+        }
+    }
+    fclose(fl);
+}
+
+void xml_parse_buffer(XML_Parser parser, const char *data, size_t size, const std::string &name)
+{
+    // XML_Parse takes an int as length, so huge documents go in pieces
+    do {
+        int len = (size > (size_t)XML_BLOCK_SIZE << 10) ? XML_BLOCK_SIZE << 10 : (int)size;
+        size -= len;
+        if(!XML_Parse(parser, data, len, size == 0))
+            throw std::ios_base::failure(xml_error(parser, name));
+        data += len;
+    } while(size > 0);
+}
+
+}}
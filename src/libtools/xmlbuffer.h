@@ -0,0 +1,50 @@
+/*
+ * Copyright 2009-2014 The VOTCA Development Team (http://www.votca.org)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#ifndef _VOTCA_TOOLS_XMLBUFFER_H
+#define	_VOTCA_TOOLS_XMLBUFFER_H
+
+#include <string>
+#include <expat.h>
+
+// internal helpers shared by the expat based readers, not installed
+
+namespace votca { namespace tools {
+
+/**
+ * \brief feed a whole file to an expat parser
+ * @param parser parser with handlers already set up
+ * @param filename file to parse
+ *
+ * The file is read in large blocks directly into the internal buffer of
+ * the parser (XML_GetBuffer/XML_ParseBuffer), so no copies or per line
+ * calls are needed. Throws std::ios_base::failure on errors.
+ */
+void xml_parse_file(XML_Parser parser, const std::string &filename);
+
+/**
+ * \brief feed an in-memory document to an expat parser
+ * @param parser parser with handlers already set up
+ * @param data begin of the document
+ * @param size size of the document in bytes
+ * @param name name used in error messages
+ */
+void xml_parse_buffer(XML_Parser parser, const char *data, size_t size, const std::string &name);
+
+}}
+
+#endif	/* _VOTCA_TOOLS_XMLBUFFER_H */
@@ -19,6 +19,7 @@
 #include <boost/program_options.hpp>
 #include <boost/format.hpp>
 #include <boost/algorithm/string/replace.hpp>
+#include <boost/algorithm/string/trim.hpp>
 
 #include <votca/tools/version.h>
 #include <votca/tools/globals.h>
@@ -26,6 +27,7 @@
 #include <votca/tools/application.h>
 #include <votca/tools/propertyiomanipulator.h>
 #include <list>
+#include <cctype>
 
 using namespace std;
 using namespace votca::tools;
@@ -49,7 +51,11 @@ public:
         AddProgramOptions() 
         ("file", po::value<string>(), "xml file to parse")
         ("format", po::value<string>(), "output format [XML TXT TEX]")
-        ("level", po::value<int>(), "output from this level ");   
+        ("level", po::value<int>(), "output from this level ")
+        ("key", po::value<vector<string> >()->composing(), "print value of key as key<TAB>value lines, can be given multiple times, answers follow the command line order")
+        ("select", po::value<vector<string> >()->composing(), "print values of all properties matching the filter (wildcards * and ?), can be given multiple times")
+        ("stdin", "read further keys from stdin (one per line), keys containing wildcards are used as filters")
+        ("shell", "print answers to --key/--select/--stdin as shell-sourceable KEY='value' lines, failed keys are unset");
         
      };
     
@@ -81,6 +87,11 @@ public:
 
         load_property_from_xml(p, file);
 
+        if (_op_vm.count("key") || _op_vm.count("select") || _op_vm.count("stdin")) {
+            RunQueries(p);
+            return;
+        }
+
         it = _mformat.find( format );
         if ( it != _mformat.end() ) {
             PropertyIOManipulator *piom = _mformat.find( format )->second;
@@ -105,6 +116,94 @@ public:
     };
     
 private:
+    /// answer all queries from the command line and stdin with one parsed file
+    void RunQueries(Property &p) {
+        shell = _op_vm.count("shell") > 0;
+
+        // the variables map loses the order of --key and --select
+        for (vector<po::option>::iterator o = _op_parsed.begin(); o != _op_parsed.end(); ++o) {
+            if (o->string_key == "key")
+                for (vector<string>::iterator v = o->value.begin(); v != o->value.end(); ++v)
+                    Query(p, *v, false);
+            else if (o->string_key == "select")
+                for (vector<string>::iterator v = o->value.begin(); v != o->value.end(); ++v)
+                    Query(p, *v, true);
+        }
+
+        if (_op_vm.count("stdin")) {
+            string line;
+            while (getline(cin, line)) {
+                boost::trim(line);
+                if (line.empty()) continue;
+                Query(p, line, line.find_first_of("*?") != string::npos);
+            }
+        }
+    }
+
+    /// answer one query, a failed query is reported and counted but does not stop the batch
+    void Query(Property &p, const string &query, bool select) {
+        string name;
+        if (shell) {
+            name = VariableName(query);
+            map<string, string>::iterator used = names.find(name);
+            if (used != names.end() && used->second != query) {
+                cerr << "query " << query << ": shell variable " << name
+                     << " is already used by query " << used->second << endl;
+                ++failed;
+                return;
+            }
+            names[name] = query;
+        }
+
+        vector<string> values;
+        try {
+            if (select) {
+                list<Property *> sel = p.Select(query);
+                for (list<Property *>::iterator iter = sel.begin(); iter != sel.end(); ++iter)
+                    values.push_back((*iter)->as<string>());
+            }
+            else
+                values.push_back(p.get(query).as<string>());
+        }
+        catch (std::exception &error) {
+            cerr << "query " << query << ": " << error.what() << endl;
+            ++failed;
+            if (shell) cout << "unset " << name << "\n";
+            return;
+        }
+
+        if (!shell) {
+            // one line per value, prefixed by the query it answers
+            for (vector<string>::iterator v = values.begin(); v != values.end(); ++v)
+                cout << query << "\t" << *v << "\n";
+            return;
+        }
+        // in shell mode all matches go into one variable
+        string value;
+        for (vector<string>::iterator v = values.begin(); v != values.end(); ++v) {
+            if (v != values.begin()) value += " ";
+            value += *v;
+        }
+        cout << name << "='" << boost::replace_all_copy(value, "'", "'\\''") << "'\n";
+    }
+
+    /// shell variable name of a query: every character which is not allowed becomes _
+    static string VariableName(const string &query) {
+        string name(query);
+        for (string::iterator c = name.begin(); c != name.end(); ++c)
+            if (!isalnum((unsigned char)*c)) *c = '_';
+        if (name.empty() || isdigit((unsigned char)name[0])) name = "_" + name;
+        return name;
+    }
+
+public:
+    /// number of queries which could not be answered
+    int Failed() const { return failed; }
+
+private:
+    int failed;
+    map<string, string> names;
+    bool shell;
     string file;
     string format;
     int level;
@@ -112,13 +211,16 @@ private:
 
 };
 
-VotcaProperty::VotcaProperty(void) {}
+VotcaProperty::VotcaProperty(void) : failed(0) {}
 
 VotcaProperty::~VotcaProperty(void) {}
 
 int main(int argc, char** argv)
 {        
     VotcaProperty vp;
-    return vp.Exec(argc, argv);
+    int ret = vp.Exec(argc, argv);
+    // failed queries do not stop the batch but are reported in the exit code
+    if (ret == 0 && vp.Failed() > 0) ret = 1;
+    return ret;
 }
 
@@ -0,0 +1,60 @@
+#!/bin/bash
+#
+# Copyright 2009-2014 The VOTCA Development Team (http://www.votca.org)
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+#
+
+# Checks of the query mode of votca_property, run by ctest.
+#
+# usage: votca_property_check.sh path/to/votca_property
+
+prog="$1"
+unset VOTCA_PROPERTY_CACHE
+tmpdir=$(mktemp -d) || exit 1
+trap 'rm -rf "$tmpdir"' EXIT
+failures=0
+
+fail() {
+  echo "FAILED: $*"
+  failures=$((failures+1))
+}
+
+cat > "$tmpdir/test.xml" <<XML
+<options><a><b>1</b><c>two words</c></a><a_b>x</a_b><d><e>it's</e><e>5</e></d></options>
+XML
+
+# answers in command line order, prefixed by their query
+out=$("$prog" --file "$tmpdir/test.xml" --select 'options.d.*' --key options.a.b --key options.a.c)
+expected=$(printf 'options.d.*\tit'"'"'s\noptions.d.*\t5\noptions.a.b\t1\noptions.a.c\ttwo words')
+[ "$out" = "$expected" ] || fail "plain output: $out"
+
+# a missing key does not stop the batch, but sets the exit code
+out=$("$prog" --file "$tmpdir/test.xml" --key zz --key options.a.b 2>/dev/null)
+[ $? -eq 1 ] || fail "exit code of a missing key"
+[ "$out" = "$(printf 'options.a.b\t1')" ] || fail "output after a missing key: $out"
+
+# shell mode: quoting, unset for missing keys, name collisions
+out=$(printf 'zz\noptions.d.e\n' | "$prog" --file "$tmpdir/test.xml" --shell --stdin \
+        --key options.a_b --key options.a.b --select 'options.d.*' 2>/dev/null)
+[ $? -eq 1 ] || fail "exit code of shell mode with failed queries"
+(
+  zz=set
+  eval "$out"
+  [ "$options_a_b" = "x" ] || exit 1
+  [ "$options_d__" = "it's 5" ] || exit 1
+  [ "$options_d_e" = "5" ] || exit 1
+  [ -z "${zz+set}" ] || exit 1
+) || fail "shell output: $out"
+
+exit $((failures > 0))